@@ -0,0 +1,43 @@
+/*
+ * bench.hpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef BENCH_BENCH_HPP_
+#define BENCH_BENCH_HPP_
+
+#include <chrono>
+#include <cstdio>
+#include <cstddef>
+
+namespace bench
+{
+
+//keeps the compiler from discarding a computed value
+template<typename T>
+inline void keep(const T& value)
+{
+	asm volatile("" : : "g"(&value) : "memory");
+}
+
+//runs fn(iteration) for the given number of iterations, returns ns per call
+template<typename Function>
+inline double measure(std::size_t iterations, Function && fn)
+{
+	auto begin = std::chrono::steady_clock::now();
+	for (std::size_t index = 0; index < iterations; ++index)
+		fn(index);
+	auto end = std::chrono::steady_clock::now();
+	double ns = std::chrono::duration<double, std::nano>(end - begin).count();
+	return ns / (double) iterations;
+}
+
+inline void report(const char* name, double ns_per_op)
+{
+	std::printf("%-48s %12.2f ns/op\n", name, ns_per_op);
+}
+
+}
+
+#endif /* BENCH_BENCH_HPP_ */
@@ -0,0 +1,72 @@
+/*
+ * bench_bit_array_table.cpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#include <random>
+#include <vector>
+#include <R/bit_array_table.hpp>
+
+#include "bench.hpp"
+
+using namespace R;
+
+typedef BitArray<uint64_t, 1024> Mask;
+
+//One query against N sparse masks: a per-entry is_collide loop against
+//the bucket-major table with and without block summaries. Queries are
+//drawn so most of them miss, which is the full-scan worst case.
+static void run(std::size_t entries, std::size_t queries)
+{
+	std::mt19937_64 rng(1);
+	std::vector<Mask> flat;
+	BitArrayTable<uint64_t, 1024> plain(false), summary(true);
+	for (std::size_t k = 0; k < entries; ++k)
+	{
+		Mask mask(false);
+		for (int bit = 0; bit < 4; ++bit)
+			mask.set_bit(rng() % 1024);
+		flat.push_back(mask);
+		plain.push_back(mask);
+		summary.push_back(mask);
+	}
+
+	std::vector<Mask> probes;
+	for (std::size_t k = 0; k < 64; ++k)
+	{
+		Mask mask(false);
+		mask.set_bit(rng() % 1024);
+		probes.push_back(mask);
+	}
+
+	char name[128];
+	std::size_t sink = 0;
+
+	std::snprintf(name, sizeof(name), "%zu entries loop is_collide", entries);
+	bench::report(name, bench::measure(queries, [&](std::size_t i)
+	{
+		const Mask& query = probes[i % probes.size()];
+		for (std::size_t k = 0; k < flat.size(); ++k)
+			sink += flat[k].is_collide(query);
+	}));
+	std::snprintf(name, sizeof(name), "%zu entries table all_collisions", entries);
+	bench::report(name, bench::measure(queries, [&](std::size_t i)
+	{
+		sink += plain.all_collisions(probes[i % probes.size()]).size();
+	}));
+	std::snprintf(name, sizeof(name), "%zu entries summary all_collisions", entries);
+	bench::report(name, bench::measure(queries, [&](std::size_t i)
+	{
+		sink += summary.all_collisions(probes[i % probes.size()]).size();
+	}));
+	bench::keep(sink);
+}
+
+int main()
+{
+	std::printf("kernel backend %s\n", bit_kernel::active().name);
+	run(1 << 10, 1 << 12);
+	run(1 << 16, 1 << 6);
+	return 0;
+}
@@ -0,0 +1,61 @@
+/*
+ * bench_bit_parallel.cpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#include <R/bit_parallel.hpp>
+
+#include "bench.hpp"
+
+using namespace R;
+
+typedef BitVector<uint64_t> Bits;
+
+//Bulk operations on a 4G-bit (512MB) bitmap with growing pool sizes.
+//The pools are pinned and the bitmaps first written through them, so
+//pages are placed where they are read.
+static void run(std::size_t bits, std::size_t threads)
+{
+	ThreadPool pool(threads, true);
+	Bits a = bit_parallel::make_vector<uint64_t>(pool, bits);
+	Bits b = bit_parallel::make_vector<uint64_t>(pool, bits, true);
+
+	char name[128];
+	std::size_t sink = 0;
+	double gb = bits / 8 / 1e9;
+
+	std::snprintf(name, sizeof(name), "%zu threads fill", threads);
+	double ns = bench::measure(4, [&](std::size_t)
+	{
+		bit_parallel::fill(pool, a);
+	});
+	bench::report(name, ns);
+	std::printf("%48s %12.2f GB/s\n", "", gb / ns * 1e9);
+
+	std::snprintf(name, sizeof(name), "%zu threads merge", threads);
+	ns = bench::measure(4, [&](std::size_t)
+	{
+		bit_parallel::merge(pool, a, b);
+	});
+	bench::report(name, ns);
+	std::printf("%48s %12.2f GB/s\n", "", 3 * gb / ns * 1e9);
+
+	std::snprintf(name, sizeof(name), "%zu threads count", threads);
+	ns = bench::measure(4, [&](std::size_t)
+	{
+		sink += bit_parallel::count(pool, a);
+	});
+	bench::report(name, ns);
+	std::printf("%48s %12.2f GB/s\n", "", gb / ns * 1e9);
+	bench::keep(sink);
+}
+
+int main()
+{
+	const std::size_t BITS = ((std::size_t) 1) << 32;
+	for (std::size_t threads = 1; threads <= ThreadPool::default_threads();
+			threads *= 2)
+		run(BITS, threads);
+	return 0;
+}
@@ -0,0 +1,77 @@
+/*
+ * bench_bitmap_index.cpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#include <random>
+#include <vector>
+#include <R/bitmap_index.hpp>
+
+#include "bench.hpp"
+
+using namespace R;
+
+typedef BitmapIndex::Bitmap Bitmap;
+
+//A selective conjunction over four attributes, answered by a hand-written
+//loop of pairwise intersect/merge calls on whole bitmaps and by the query
+//engine, which orders the operands and stops on empty chunks.
+static void run(std::size_t records, std::size_t queries)
+{
+	std::mt19937_64 rng(1);
+	BitmapIndex index(records);
+	std::size_t region = index.add_attribute(64);
+	std::size_t status = index.add_attribute(4);
+	std::size_t age = index.add_attribute(100, BitmapIndex::RANGE);
+	std::size_t flag = index.add_attribute(2);
+	for (std::size_t record = 0; record < records; ++record)
+	{
+		index.set(region, record, rng() % 64);
+		index.set(status, record, rng() % 4);
+		index.set(age, record, rng() % 100);
+		index.set(flag, record, rng() % 2);
+	}
+
+	char name[128];
+	std::size_t sink = 0;
+
+	std::snprintf(name, sizeof(name), "%zu records pairwise loop", records);
+	bench::report(name, bench::measure(queries, [&](std::size_t i)
+	{
+		//(status 1 or 2) and flag 1 and region r and 20 <= age <= 40
+		Bitmap result(index.bitmap(status, 1));
+		result.merge(index.bitmap(status, 2));
+		result.intersect(index.bitmap(flag, 1));
+		result.intersect(index.bitmap(region, i % 64));
+		Bitmap ages(index.bitmap(age, 40));
+		Bitmap below(index.bitmap(age, 19));
+		for (std::size_t word = 0; word < ages.buckets(); ++word)
+			ages.data()[word] &= ~below.data()[word];
+		result.intersect(ages);
+		sink += result.find_first_set();
+	}));
+	std::snprintf(name, sizeof(name), "%zu records query engine", records);
+	bench::report(name, bench::measure(queries, [&](std::size_t i)
+	{
+		sink += index.evaluate((BitmapQuery::equal(status, 1)
+				| BitmapQuery::equal(status, 2)) & BitmapQuery::equal(flag, 1)
+				& BitmapQuery::equal(region, i % 64)
+				& BitmapQuery::range(age, 20, 40)).find_first_set();
+	}));
+	std::snprintf(name, sizeof(name), "%zu records query engine, disjoint", records);
+	bench::report(name, bench::measure(queries, [&](std::size_t i)
+	{
+		sink += index.evaluate(BitmapQuery::equal(region, i % 64)
+				& BitmapQuery::equal(region, (i + 1) % 64)
+				& BitmapQuery::range(age, 20, 40)).find_first_set();
+	}));
+	bench::keep(sink);
+}
+
+int main()
+{
+	run(1 << 16, 1 << 12);
+	run(1 << 22, 1 << 6);
+	return 0;
+}
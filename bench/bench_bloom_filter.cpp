@@ -0,0 +1,82 @@
+/*
+ * bench_bloom_filter.cpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#include <memory>
+#include <random>
+#include <vector>
+#include <R/bloom_filter.hpp>
+
+#include "bench.hpp"
+
+using namespace R;
+
+static const std::size_t KEYS = (std::size_t) 1 << 24;
+static const std::size_t PROBES = (std::size_t) 1 << 22;
+static const std::size_t HASHES = 7;
+
+//Classic Bloom filter: k independent positions, i.e. up to k cache misses.
+static std::size_t classic_position(uint64_t hash, std::size_t index,
+		std::size_t bits)
+{
+	uint64_t h1 = hash, h2 = hash_batch::mix(hash) | 1;
+	return (std::size_t) ((h1 + index * h2) % bits);
+}
+
+int main()
+{
+	std::size_t bits = bloom_block::bits_for(KEYS, 0.01);
+	std::printf("%zu keys in %zu MB, kernel backend %s\n", KEYS,
+			bits / 8 / 1024 / 1024, bit_kernel::active().name);
+
+	std::mt19937_64 rng(1);
+	std::vector<uint64_t> keys(KEYS), probes(PROBES);
+	for (auto& key : keys)
+		key = rng();
+	for (std::size_t k = 0; k < PROBES; ++k)
+		probes[k] = (k % 2) ? keys[rng() % KEYS] : rng();
+
+	BitVector<uint64_t> classic(bits);
+	for (uint64_t key : keys)
+		for (std::size_t index = 0; index < HASHES; ++index)
+			classic.set_bit(classic_position(key, index, bits));
+	BloomFilter blocked(bits);
+	blocked.insert_many(keys.data(), keys.size());
+
+	std::size_t sink = 0;
+	bench::report("classic k=7 contains", bench::measure(PROBES,
+			[&](std::size_t i)
+			{
+				bool found = true;
+				for (std::size_t index = 0; index < HASHES && found; ++index)
+					found = classic.get_bit(classic_position(probes[i], index, bits));
+				sink += found;
+			}));
+	bench::report("blocked contains", bench::measure(PROBES, [&](std::size_t i)
+	{
+		sink += blocked.contains(probes[i]);
+	}));
+	std::unique_ptr<bool[]> results(new bool[PROBES]);
+	bench::report("blocked contains_many", bench::measure(1, [&](std::size_t)
+	{
+		sink += blocked.contains_many(probes.data(), PROBES, results.get());
+	}) / PROBES);
+	bench::report("blocked insert", bench::measure(PROBES, [&](std::size_t i)
+	{
+		blocked.insert(probes[i]);
+	}));
+	bench::report("blocked insert_many", bench::measure(1, [&](std::size_t)
+	{
+		blocked.insert_many(probes.data(), PROBES);
+	}) / PROBES);
+
+	AtomicBloomFilter shared(bits);
+	bench::report("atomic insert_many", bench::measure(1, [&](std::size_t)
+	{
+		shared.insert_many(keys.data(), PROBES);
+	}) / PROBES);
+	bench::keep(sink);
+	return 0;
+}
@@ -0,0 +1,126 @@
+/*
+ * bench_channel.cpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <R/channel.hpp>
+
+#include "bench.hpp"
+
+using namespace R;
+
+//one producer and one consumer fiber on a single worker
+static void pair(Scheduler& scheduler, std::size_t capacity,
+		std::size_t messages)
+{
+	Channel<std::size_t> channel(capacity);
+	std::size_t sum = 0;
+	char name[128];
+	std::snprintf(name, sizeof(name), "channel of %zu, producer -> consumer",
+			capacity);
+	bench::report(name, bench::measure(1, [&](std::size_t)
+	{
+		Task consumer = scheduler.spawn([&]()
+		{
+			std::size_t value;
+			while (channel.receive(value))
+				sum += value;
+		});
+		scheduler.spawn([&]()
+		{
+			for (std::size_t index = 0; index < messages; ++index)
+				channel.send(index);
+			channel.close();
+		}).join();
+		consumer.join();
+	}) / (double) messages);
+	bench::keep(sum);
+}
+
+//a chain of stages, each passing on what it received
+static void pipeline(Scheduler& scheduler, std::size_t stages,
+		std::size_t messages)
+{
+	std::vector<std::unique_ptr<Channel<std::size_t>>> channels;
+	for (std::size_t index = 0; index <= stages; ++index)
+		channels.emplace_back(new Channel<std::size_t>(64));
+	std::size_t sum = 0;
+	char name[128];
+	std::snprintf(name, sizeof(name), "pipeline of %zu stages, per hop", stages);
+	bench::report(name, bench::measure(1, [&](std::size_t)
+	{
+		std::vector<Task> tasks;
+		for (std::size_t index = 0; index < stages; ++index)
+			tasks.push_back(scheduler.spawn([&, index]()
+			{
+				std::size_t value;
+				while (channels[index]->receive(value))
+					channels[index + 1]->send(value + 1);
+				channels[index + 1]->close();
+			}));
+		tasks.push_back(scheduler.spawn([&]()
+		{
+			std::size_t value;
+			while (channels[stages]->receive(value))
+				sum += value;
+		}));
+		scheduler.spawn([&]()
+		{
+			for (std::size_t index = 0; index < messages; ++index)
+				channels[0]->send(index);
+			channels[0]->close();
+		}).join();
+		for (Task& task : tasks)
+			task.join();
+	}) / (double) (messages * (stages + 1)));
+	bench::keep(sum);
+}
+
+//fibers taking turns on one mutex, yielding while they hold it
+static void mutex(Scheduler& scheduler, std::size_t fibers, std::size_t rounds)
+{
+	CoMutex mutex;
+	std::size_t counter = 0;
+	char name[128];
+	std::snprintf(name, sizeof(name), "CoMutex, %zu fibers, contended", fibers);
+	bench::report(name, bench::measure(1, [&](std::size_t)
+	{
+		std::vector<Task> tasks;
+		for (std::size_t index = 0; index < fibers; ++index)
+			tasks.push_back(scheduler.spawn([&]()
+			{
+				for (std::size_t step = 0; step < rounds; ++step)
+				{
+					std::lock_guard<CoMutex> lock(mutex);
+					++counter;
+					Scheduler::yield_to_scheduler();
+				}
+			}));
+		for (Task& task : tasks)
+			task.join();
+	}) / (double) (fibers * rounds));
+	bench::keep(counter);
+}
+
+int main()
+{
+	Scheduler scheduler(1);
+	for (std::size_t capacity : { (std::size_t) 0, (std::size_t) 1,
+			(std::size_t) 128 })
+		pair(scheduler, capacity, 1000000);
+	pipeline(scheduler, 8, 200000);
+	mutex(scheduler, 4, 100000);
+
+	CoMutex uncontended;
+	bench::report("CoMutex lock and unlock", bench::measure(10000000,
+			[&](std::size_t)
+			{
+				uncontended.lock();
+				uncontended.unlock();
+			}));
+	return 0;
+}
@@ -0,0 +1,203 @@
+/*
+ * bench_coroutine.cpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include <unistd.h>
+#include <R/coroutine.hpp>
+
+#include "bench.hpp"
+
+using namespace R;
+
+//Build with -DR_COROUTINE_BACKEND=R_COROUTINE_THREAD (or _UCONTEXT) to
+//compare against the other backends, or with -std=gnu++20
+//-DR_COROUTINE_BACKEND=R_COROUTINE_STACKLESS.
+static const char* backend()
+{
+	switch (R_COROUTINE_BACKEND)
+	{
+	case R_COROUTINE_THREAD:
+		return "thread";
+	case R_COROUTINE_UCONTEXT:
+		return "ucontext";
+	case R_COROUTINE_STACKLESS:
+		return "stackless";
+	default:
+		return "asm";
+	}
+}
+
+//stackless bodies are coroutines themselves
+#if R_COROUTINE_BACKEND == R_COROUTINE_STACKLESS
+#define BODY(T) -> symmetric_coroutine<T>::body_type
+#define YIELD(yield) co_await yield()
+#define TRANSFER(yield, other, x) co_await yield(other, x)
+#define END co_return
+#else
+#define BODY(T)
+#define YIELD(yield) yield()
+#define TRANSFER(yield, other, x) yield(other, x)
+#define END return
+#endif
+
+//virtual and resident memory of the process
+static void memory(std::size_t& virtual_bytes, std::size_t& resident_bytes)
+{
+	long size = 0, resident = 0;
+	FILE* file = std::fopen("/proc/self/statm", "r");
+	if (file == nullptr || std::fscanf(file, "%ld %ld", &size, &resident) != 2)
+		size = resident = 0;
+	if (file != nullptr)
+		std::fclose(file);
+	virtual_bytes = (std::size_t) size * (std::size_t) sysconf(_SC_PAGESIZE);
+	resident_bytes = (std::size_t) resident * (std::size_t) sysconf(_SC_PAGESIZE);
+}
+
+static void report_bytes(const char* what, double bytes)
+{
+	char name[128];
+	std::snprintf(name, sizeof(name), "%s %s", backend(), what);
+	std::printf("%-48s %12.0f bytes\n", name, bytes);
+}
+
+int main()
+{
+	const std::size_t rounds = (R_COROUTINE_BACKEND == R_COROUTINE_THREAD) ?
+			(1 << 12) : (1 << 22);
+	std::size_t sink = 0;
+	char name[128];
+
+	symmetric_coroutine<int>::call_type counter(
+			[&sink](symmetric_coroutine<int>::yield_type& yield) BODY(int)
+			{
+				while (true)
+				{
+					sink += yield.get();
+					YIELD(yield);
+				}
+			});
+	counter(0);
+	std::snprintf(name, sizeof(name), "%s run/yield round trip", backend());
+	bench::report(name, bench::measure(rounds, [&](std::size_t i)
+	{
+		counter((int) i);
+	}));
+
+	std::snprintf(name, sizeof(name), "%s create, run, destroy", backend());
+	bench::report(name, bench::measure(rounds >> 4, [&](std::size_t)
+	{
+		symmetric_coroutine<void>::call_type once(
+				[&sink](symmetric_coroutine<void>::yield_type& yield) BODY(void)
+				{
+					++sink;
+					YIELD(yield);
+				});
+		once();
+	}));
+	std::snprintf(name, sizeof(name), "%s create, run to the end, destroy",
+			backend());
+	bench::report(name, bench::measure(rounds >> 4, [&](std::size_t)
+	{
+		symmetric_coroutine<void>::call_type once(
+				[&sink](symmetric_coroutine<void>::yield_type&) BODY(void)
+				{
+					++sink;
+					END;
+				}
+#if R_COROUTINE_BACKEND != R_COROUTINE_STACKLESS
+				, 16 * 1024
+#endif
+				);
+		once();
+	}));
+
+#if R_COROUTINE_BACKEND != R_COROUTINE_THREAD
+	//Ping-pong of a counter between two coroutines: handed straight over
+	//by symmetric transfer, then bounced through the caller
+	std::size_t end = 0;
+	symmetric_coroutine<std::size_t>::call_type* other = nullptr;
+	symmetric_coroutine<std::size_t>::call_type ping(
+			[&end, &other](symmetric_coroutine<std::size_t>::yield_type& yield)
+					BODY(std::size_t)
+			{
+				while (true)
+				{
+					if (yield.get() >= end)
+						YIELD(yield);
+					else
+						TRANSFER(yield, *other, yield.get() + 1);
+				}
+			});
+	symmetric_coroutine<std::size_t>::call_type pong(
+			[&ping](symmetric_coroutine<std::size_t>::yield_type& yield)
+					BODY(std::size_t)
+			{
+				while (true)
+					TRANSFER(yield, ping, yield.get() + 1);
+			});
+	other = &pong;
+	end = rounds;
+	std::snprintf(name, sizeof(name), "%s ping-pong by symmetric transfer",
+			backend());
+	bench::report(name, bench::measure(1, [&](std::size_t)
+	{
+		ping(0);
+	}) / (double) rounds);
+
+	symmetric_coroutine<std::size_t>::call_type left(
+			[](symmetric_coroutine<std::size_t>::yield_type& yield)
+					BODY(std::size_t)
+			{
+				while (true)
+					YIELD(yield);
+			});
+	symmetric_coroutine<std::size_t>::call_type right(
+			[](symmetric_coroutine<std::size_t>::yield_type& yield)
+					BODY(std::size_t)
+			{
+				while (true)
+					YIELD(yield);
+			});
+	std::snprintf(name, sizeof(name), "%s ping-pong through the caller",
+			backend());
+	bench::report(name, bench::measure(rounds / 2, [&](std::size_t i)
+	{
+		left(i);
+		right(i + 1);
+	}) / 2);
+#endif
+
+	//memory of suspended coroutines that touched a little stack
+	const std::size_t live = (R_COROUTINE_BACKEND == R_COROUTINE_THREAD) ?
+			1000 : 10000;
+	std::vector<std::unique_ptr<symmetric_coroutine<void>::call_type>> coroutines;
+	coroutines.reserve(live);
+	std::size_t virtual_before, resident_before, virtual_after, resident_after;
+	memory(virtual_before, resident_before);
+	for (std::size_t index = 0; index < live; ++index)
+	{
+		coroutines.emplace_back(new symmetric_coroutine<void>::call_type(
+				[&sink](symmetric_coroutine<void>::yield_type& yield) BODY(void)
+				{
+					volatile char scratch[256];
+					scratch[0] = (char) sink;
+					sink += scratch[0];
+					while (true)
+						YIELD(yield);
+				}));
+		(*coroutines.back())();
+	}
+	memory(virtual_after, resident_after);
+	report_bytes("virtual memory per coroutine",
+			(double) (virtual_after - virtual_before) / (double) live);
+	report_bytes("resident memory per coroutine",
+			(double) (resident_after - resident_before) / (double) live);
+	coroutines.clear();
+	bench::keep(sink);
+	return 0;
+}
@@ -0,0 +1,85 @@
+/*
+ * bench_hierarchical_bitmap.cpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#include <random>
+#include <vector>
+#include <R/hierarchical_bitmap.hpp>
+
+#include "bench.hpp"
+
+using namespace R;
+
+static const std::size_t BITS = (std::size_t) 1 << 28;
+
+//Random find_next_set / find_next_zero queries at a given occupancy.
+//At 1% the zero search is trivial and the set search scans ~100 bits;
+//at 99% it is the other way around. The "clustered" rows put all set (or
+//clear) bits in one corner, which is where the flat scan has to walk
+//megabytes while the summary levels skip them.
+static void run(const char* label, double occupancy, bool clustered,
+		std::size_t queries)
+{
+	std::mt19937_64 rng(1);
+	HierarchicalBitmap tree(BITS);
+	BitVector<uint64_t> flat(BITS);
+
+	std::size_t target = (std::size_t) (BITS * occupancy);
+	if (clustered)
+	{
+		tree.set_range(0, target);
+		flat.set_range(0, target);
+	}
+	else
+	{
+		std::bernoulli_distribution coin(occupancy);
+		for (std::size_t k = 0; k < BITS; ++k)
+			if (coin(rng))
+			{
+				tree.set_bit(k);
+				flat.set_bit(k);
+			}
+	}
+
+	std::vector<std::size_t> probes(queries);
+	for (auto& probe : probes)
+		probe = rng() % BITS;
+
+	char name[128];
+	std::size_t sink = 0;
+
+	std::snprintf(name, sizeof(name), "%s flat find_next_set", label);
+	bench::report(name, bench::measure(queries, [&](std::size_t i)
+	{
+		sink += flat.find_next_set(probes[i]);
+	}));
+	std::snprintf(name, sizeof(name), "%s tree find_next_set", label);
+	bench::report(name, bench::measure(queries, [&](std::size_t i)
+	{
+		sink += tree.find_next_set(probes[i]);
+	}));
+	std::snprintf(name, sizeof(name), "%s flat find_next_zero", label);
+	bench::report(name, bench::measure(queries, [&](std::size_t i)
+	{
+		sink += flat.find_next_zero(probes[i]);
+	}));
+	std::snprintf(name, sizeof(name), "%s tree find_next_zero", label);
+	bench::report(name, bench::measure(queries, [&](std::size_t i)
+	{
+		sink += tree.find_next_zero(probes[i]);
+	}));
+	bench::keep(sink);
+}
+
+int main()
+{
+	std::printf("bitmap of %zu bits\n", BITS);
+	run("1% random", 0.01, false, 1 << 20);
+	run("99% random", 0.99, false, 1 << 20);
+	//flat scans walk megabytes per query here, so fewer queries
+	run("1% clustered", 0.01, true, 1 << 10);
+	run("99% clustered", 0.99, true, 1 << 10);
+	return 0;
+}
@@ -0,0 +1,116 @@
+/*
+ * bench_reactor.cpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#include <cstring>
+#include <vector>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <R/reactor.hpp>
+
+#include "bench.hpp"
+
+using namespace R;
+
+static void write_all(Reactor& io, int fd, const char* data, std::size_t bytes)
+{
+	while (bytes > 0)
+	{
+		std::size_t written = io.async_write(fd, data, bytes);
+		data += written;
+		bytes -= written;
+	}
+}
+
+static bool read_all(Reactor& io, int fd, char* data, std::size_t bytes)
+{
+	while (bytes > 0)
+	{
+		std::size_t read = io.async_read(fd, data, bytes);
+		if (read == 0)
+			return false;
+		data += read;
+		bytes -= read;
+	}
+	return true;
+}
+
+//Loopback echo: every client connects, then sends a message and waits
+//for it to come back, rounds times. Clients and their server side
+//connections are all fibers of the reactor's scheduler.
+static void run(Reactor& io, std::size_t connections, std::size_t rounds,
+		std::size_t message)
+{
+	Scheduler& scheduler = io.scheduler();
+	int listener = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+	sockaddr_in address;
+	std::memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	socklen_t length = sizeof(address);
+	if (listener < 0 || bind(listener, (sockaddr*) &address, length) != 0
+			|| getsockname(listener, (sockaddr*) &address, &length) != 0
+			|| listen(listener, SOMAXCONN) != 0)
+	{
+		std::perror("listen");
+		return;
+	}
+	std::vector<Task> echoes;
+	char name[128];
+	std::snprintf(name, sizeof(name), "%zu threads, %zu connections x %zu B",
+			scheduler.size(), connections, message);
+	bench::report(name, bench::measure(1, [&](std::size_t)
+	{
+		Task server = scheduler.spawn([&]()
+		{
+			for (std::size_t index = 0; index < connections; ++index)
+			{
+				int connection = io.async_accept(listener);
+				echoes.push_back(scheduler.spawn([&io, connection, message]()
+				{
+					std::vector<char> buffer(message);
+					while (read_all(io, connection, buffer.data(), message))
+						write_all(io, connection, buffer.data(), message);
+					io.close(connection);
+				}));
+			}
+		});
+		std::vector<Task> clients;
+		for (std::size_t index = 0; index < connections; ++index)
+			clients.push_back(scheduler.spawn([&]()
+			{
+				int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+				//completes while the first write waits for the socket
+				connect(fd, (sockaddr*) &address, sizeof(address));
+				std::vector<char> buffer(message, 'x');
+				for (std::size_t round = 0; round < rounds; ++round)
+				{
+					write_all(io, fd, buffer.data(), message);
+					read_all(io, fd, buffer.data(), message);
+				}
+				io.close(fd);
+			}));
+		for (Task& task : clients)
+			task.join();
+		server.join();
+		for (Task& task : echoes)
+			task.join();
+	}) / (double) (connections * rounds));
+	echoes.clear();
+	io.close(listener);
+}
+
+int main()
+{
+	StackPool pool((std::size_t) 256 << 20, page_allocator(), false);
+	std::printf("backend: %s, ns per round trip\n",
+			R_REACTOR_BACKEND == R_REACTOR_IO_URING ? "io_uring" : "epoll");
+	Scheduler scheduler(1, 16 * 1024, pool);
+	Reactor io(scheduler);
+	run(io, 100, 1000, 64);
+	run(io, 4000, 100, 64);
+	run(io, 4000, 20, 4096);
+	return 0;
+}
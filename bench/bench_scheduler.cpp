@@ -0,0 +1,80 @@
+/*
+ * bench_scheduler.cpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#include <atomic>
+#include <vector>
+#include <R/scheduler.hpp>
+
+#include "bench.hpp"
+
+using namespace R;
+
+//Spawns fibers that each yield a few times, keeps all of them alive at
+//once, then joins them from outside the pool.
+static void run(Scheduler& scheduler, std::size_t fibers, std::size_t yields)
+{
+	std::atomic<std::size_t> sink(0);
+	std::vector<Task> tasks;
+	tasks.reserve(fibers);
+	char name[128];
+	std::snprintf(name, sizeof(name), "%zu threads, %zu fibers x %zu yields",
+			scheduler.size(), fibers, yields);
+	bench::report(name, bench::measure(1, [&](std::size_t)
+	{
+		for (std::size_t index = 0; index < fibers; ++index)
+			tasks.push_back(scheduler.spawn([&sink, yields]()
+			{
+				for (std::size_t step = 0; step < yields; ++step)
+					Scheduler::yield_to_scheduler();
+				sink.fetch_add(1, std::memory_order_relaxed);
+			}));
+		for (Task& task : tasks)
+			task.join();
+	}) / (double) fibers);
+	tasks.clear();
+	bench::keep(sink);
+}
+
+//fork-join tree spawned from inside the pool
+static std::size_t tree(Scheduler& scheduler, std::size_t depth)
+{
+	if (depth == 0)
+		return 1;
+	std::size_t left = 0;
+	Task task = scheduler.spawn([&]()
+	{
+		left = tree(scheduler, depth - 1);
+	});
+	std::size_t right = tree(scheduler, depth - 1);
+	task.join();
+	return left + right;
+}
+
+int main()
+{
+	//unguarded stacks: 100k guard pages exceed vm.max_map_count
+	StackPool pool((std::size_t) 256 << 20, page_allocator(), false);
+	for (std::size_t threads = 1; threads <= Scheduler::default_threads();
+			threads *= 2)
+	{
+		Scheduler scheduler(threads, 16 * 1024, pool);
+		run(scheduler, 100000, 0);
+		run(scheduler, 100000, 4);
+		std::size_t leaves = 0;
+		char name[128];
+		std::snprintf(name, sizeof(name), "%zu threads, fork-join tree of 2^16",
+				threads);
+		bench::report(name, bench::measure(1, [&](std::size_t)
+		{
+			scheduler.spawn([&]()
+			{
+				leaves = tree(scheduler, 16);
+			}).join();
+		}) / (double) (1 << 16));
+		bench::keep(leaves);
+	}
+	return 0;
+}
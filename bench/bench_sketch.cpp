@@ -0,0 +1,89 @@
+/*
+ * bench_sketch.cpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#include <random>
+#include <vector>
+#include <R/count_min_sketch.hpp>
+#include <R/hyper_log_log.hpp>
+
+#include "bench.hpp"
+
+using namespace R;
+
+static const std::size_t EVENTS = (std::size_t) 1 << 22;
+
+int main()
+{
+	std::printf("kernel backend %s\n", bit_kernel::active().name);
+	std::mt19937_64 rng(1);
+	std::vector<uint64_t> events(EVENTS);
+	for (auto& event : events)
+		event = rng() % (1 << 20);
+
+	std::size_t sink = 0;
+	HyperLogLog hll(14), other(14);
+	bench::report("hll insert", bench::measure(EVENTS, [&](std::size_t i)
+	{
+		hll.insert(events[i]);
+	}));
+	bench::report("hll insert_many", bench::measure(1, [&](std::size_t)
+	{
+		hll.insert_many(events.data(), EVENTS);
+	}) / EVENTS);
+	AtomicHyperLogLog shared_hll(14);
+	bench::report("atomic hll insert_many", bench::measure(1, [&](std::size_t)
+	{
+		shared_hll.insert_many(events.data(), EVENTS);
+	}) / EVENTS);
+
+	other.insert_many(events.data(), EVENTS / 2);
+	//plain per-register loop on the packed layout, for reference
+	bench::report("hll merge per register", bench::measure(1 << 10,
+			[&](std::size_t)
+			{
+				uint64_t* dst = const_cast<uint64_t*>(hll.words().data());
+				const uint64_t* src = other.words().data();
+				for (std::size_t index = 0; index < hll.registers(); ++index)
+				{
+					std::size_t word = index / hll_register::PER_WORD;
+					std::size_t field = index % hll_register::PER_WORD;
+					std::size_t value = hll_register::get(src[word], field);
+					if (hll_register::get(dst[word], field) < value)
+						dst[word] = hll_register::set(dst[word], field, value);
+				}
+			}));
+	bench::report("hll merge packed", bench::measure(1 << 10, [&](std::size_t)
+	{
+		hll.merge(other);
+	}));
+	sink += (std::size_t) hll.estimate();
+
+	CountMinSketch<> cms(count_min_row::width_for(0.0001),
+			count_min_row::depth_for(0.001)), cms_other(cms);
+	bench::report("cms add", bench::measure(EVENTS, [&](std::size_t i)
+	{
+		cms.add(events[i]);
+	}));
+	bench::report("cms add_many", bench::measure(1, [&](std::size_t)
+	{
+		cms.add_many(events.data(), EVENTS);
+	}) / EVENTS);
+	AtomicCountMinSketch<> shared_cms(cms.width(), cms.depth());
+	bench::report("atomic cms add_many", bench::measure(1, [&](std::size_t)
+	{
+		shared_cms.add_many(events.data(), EVENTS);
+	}) / EVENTS);
+	bench::report("cms estimate", bench::measure(EVENTS, [&](std::size_t i)
+	{
+		sink += cms.estimate(events[i]);
+	}));
+	bench::report("cms merge", bench::measure(1 << 10, [&](std::size_t)
+	{
+		cms.merge(cms_other);
+	}));
+	bench::keep(sink);
+	return 0;
+}
@@ -0,0 +1,118 @@
+/*
+ * bench_timer.cpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#include <chrono>
+#include <functional>
+#include <queue>
+#include <random>
+#include <vector>
+#include <R/scheduler.hpp>
+#include <R/timing_wheel.hpp>
+
+#include "bench.hpp"
+
+using namespace R;
+
+//a million pending deadlines up to a minute ahead in millisecond ticks
+static void wheel(std::size_t count)
+{
+	std::mt19937_64 random(1);
+	std::vector<TimingWheel::Tick> deadlines(count);
+	for (TimingWheel::Tick& deadline : deadlines)
+		deadline = 1 + random() % 60000;
+	std::vector<TimingWheel::Timer> timers(count);
+	TimingWheel wheel;
+	bench::report("timing wheel insert", bench::measure(count,
+			[&](std::size_t index)
+			{
+				wheel.insert(&timers[index], deadlines[index]);
+			}));
+	bench::report("timing wheel cancel", bench::measure(count / 2,
+			[&](std::size_t index)
+			{
+				wheel.cancel(&timers[index * 2]);
+			}));
+	std::size_t fired = 0;
+	double ns = bench::measure(1, [&](std::size_t)
+	{
+		fired += wheel.advance(60000, [](TimingWheel::Timer*)
+		{
+		});
+	});
+	bench::report("timing wheel expire, per timer", ns / (double) fired);
+
+	typedef std::pair<TimingWheel::Tick, std::size_t> Entry;
+	std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+	bench::report("binary heap push", bench::measure(count,
+			[&](std::size_t index)
+			{
+				heap.push(Entry(deadlines[index], index));
+			}));
+	bench::report("binary heap pop", bench::measure(count,
+			[&](std::size_t)
+			{
+				heap.pop();
+			}));
+}
+
+//fibers sleeping at once on one worker
+static void sleepers(std::size_t fibers)
+{
+	StackPool pool((std::size_t) 256 << 20, page_allocator(), false);
+	Scheduler scheduler(1, 16 * 1024, pool);
+	std::vector<Task> tasks;
+	tasks.reserve(fibers);
+	char name[128];
+	std::snprintf(name, sizeof(name), "%zu fibers sleeping 0-100 ms, per fiber",
+			fibers);
+	bench::report(name, bench::measure(1, [&](std::size_t)
+	{
+		for (std::size_t index = 0; index < fibers; ++index)
+			tasks.push_back(scheduler.spawn([index]()
+			{
+				Scheduler::sleep_for(std::chrono::milliseconds(index % 100));
+			}));
+		for (Task& task : tasks)
+			task.join();
+	}) / (double) fibers);
+}
+
+//Every worker arms and disarms timeouts that never go off, as fibers
+//whose waits end early do. Wall time per arm/disarm pair over all of them.
+static void timeouts(std::size_t workers, std::size_t rounds)
+{
+	Scheduler scheduler(workers);
+	std::vector<Task> tasks;
+	char name[128];
+	std::snprintf(name, sizeof(name), "%zu workers arm + disarm", workers);
+	bench::report(name, bench::measure(1, [&](std::size_t)
+	{
+		for (std::size_t index = 0; index < workers; ++index)
+			tasks.push_back(scheduler.spawn([&scheduler, rounds]()
+			{
+				Scheduler::Clock::time_point deadline =
+						Scheduler::Clock::now() + std::chrono::seconds(60);
+				for (std::size_t round = 0; round < rounds; ++round)
+				{
+					Scheduler::Alarm alarm;
+					scheduler.arm(alarm, deadline);
+					scheduler.disarm(alarm);
+				}
+			}));
+		for (Task& task : tasks)
+			task.join();
+	}) / (double) (workers * rounds));
+}
+
+int main()
+{
+	wheel(1000000);
+	sleepers(100000);
+	for (std::size_t workers = 1; workers <= Scheduler::default_threads();
+			workers *= 2)
+		timeouts(workers, 1000000);
+	return 0;
+}
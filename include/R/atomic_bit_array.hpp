@@ -0,0 +1,291 @@
+/*
+ * atomic_bit_array.hpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef INCLUDE_R_ATOMIC_BIT_ARRAY_HPP_
+#define INCLUDE_R_ATOMIC_BIT_ARRAY_HPP_
+
+#include <type_traits>
+#include <array>
+#include <atomic>
+#include <algorithm>
+
+#include <R/bit_array.hpp>
+#include <R/bit_algorithm.hpp>
+#include <R/bit_word.hpp>
+
+namespace R
+{
+
+//Lock-free bitmap with the same bit order as BitArray.
+//Every operation is atomic per bucket; multi-bucket operations are not
+//atomic as a whole. Loads default to acquire, read-modify-writes to acq_rel.
+template<typename BaseInt, std::size_t TotalBits>
+class AtomicBitArray
+{
+	static_assert(std::is_integral<BaseInt>::value, "Integer type required.");
+	static_assert(std::is_unsigned<BaseInt>::value, "Unsigned type required.");
+	static_assert(TotalBits % (sizeof(BaseInt) * 8) == 0,
+			"TotalBits must be multiple of the bits in BaseInt");
+public:
+	typedef std::size_t Size;
+	typedef BitArray<BaseInt, TotalBits> PlainType;
+private:
+	typedef AtomicBitArray<BaseInt, TotalBits> SelfType;
+	typedef BitAlgorithm<BaseInt> Algorithm;
+
+	constexpr static Size BUCKETS()
+	{
+		return PlainType::BUCKETS();
+	}
+	constexpr static Size BIT_COUNT()
+	{
+		return Algorithm::BIT_COUNT();
+	}
+
+	std::array<std::atomic<BaseInt>, BUCKETS()> array;
+
+	//a CAS failure may not carry release semantics
+	constexpr static std::memory_order failure_order(std::memory_order order)
+	{
+		return (order == std::memory_order_acq_rel) ?
+				std::memory_order_acquire :
+				(order == std::memory_order_release) ?
+						std::memory_order_relaxed : order;
+	}
+
+	//mask of the bits of [start, start + length) inside start's bucket
+	static BaseInt segment_mask(Size start, Size length)
+	{
+		Size sub = Algorithm::sub_index(start);
+		Size fill = std::min(length + sub, BIT_COUNT()) - sub;
+		return (BaseInt) (Algorithm::fill_left(fill) >> sub);
+	}
+
+	//Sets every bit of [start, start + length) only if all of them were
+	//clear, bucket by bucket; claimed buckets are rolled back on conflict.
+	bool try_claim(Size start, Size length, std::memory_order order)
+	{
+		Size first = start;
+		Size remain = length;
+		while (remain > 0)
+		{
+			Size bucket = Algorithm::bucket_index(start);
+			BaseInt mask = segment_mask(start, remain);
+			BaseInt word = array[bucket].load(std::memory_order_relaxed);
+			do
+			{
+				if (word & mask)
+				{
+					release_range(first, start - first, order);
+					return false;
+				}
+			} while (!array[bucket].compare_exchange_weak(word,
+					(BaseInt) (word | mask), order, failure_order(order)));
+			Size filled = bit_word::popcount(mask);
+			start += filled;
+			remain -= filled;
+		}
+		return true;
+	}
+
+public:
+	AtomicBitArray() :
+			AtomicBitArray(false)
+	{
+	}
+
+	explicit AtomicBitArray(bool initial)
+	{
+		BaseInt value = initial ? (BaseInt) ~(BaseInt) 0 : (BaseInt) 0;
+		for (Size index = 0; index < BUCKETS(); ++index)
+			array[index].store(value, std::memory_order_relaxed);
+	}
+
+	explicit AtomicBitArray(const PlainType& source)
+	{
+		for (Size index = 0; index < BUCKETS(); ++index)
+			array[index].store(source.array[index], std::memory_order_relaxed);
+	}
+
+	AtomicBitArray(const SelfType&) = delete;
+	SelfType& operator=(const SelfType&) = delete;
+
+	bool get_bit(Size index,
+			std::memory_order order = std::memory_order_acquire) const
+	{
+		BaseInt marker = Algorithm::mark_bit(Algorithm::sub_index(index));
+		return !!(array[Algorithm::bucket_index(index)].load(order) & marker);
+	}
+
+	void set_bit(Size index, std::memory_order order = std::memory_order_acq_rel)
+	{
+		test_and_set(index, order);
+	}
+
+	void clear_bit(Size index,
+			std::memory_order order = std::memory_order_acq_rel)
+	{
+		test_and_clear(index, order);
+	}
+
+	//returns the previous value of the bit
+	bool test_and_set(Size index,
+			std::memory_order order = std::memory_order_acq_rel)
+	{
+		BaseInt marker = Algorithm::mark_bit(Algorithm::sub_index(index));
+		return !!(array[Algorithm::bucket_index(index)].fetch_or(marker, order)
+				& marker);
+	}
+
+	bool test_and_clear(Size index,
+			std::memory_order order = std::memory_order_acq_rel)
+	{
+		BaseInt marker = Algorithm::mark_bit(Algorithm::sub_index(index));
+		return !!(array[Algorithm::bucket_index(index)].fetch_and(
+				(BaseInt) ~marker, order) & marker);
+	}
+
+	void set_range(Size start, Size length,
+			std::memory_order order = std::memory_order_acq_rel)
+	{
+		while (length > 0)
+		{
+			BaseInt mask = segment_mask(start, length);
+			array[Algorithm::bucket_index(start)].fetch_or(mask, order);
+			Size filled = bit_word::popcount(mask);
+			start += filled;
+			length -= filled;
+		}
+	}
+
+	void release_range(Size start, Size length,
+			std::memory_order order = std::memory_order_acq_rel)
+	{
+		while (length > 0)
+		{
+			BaseInt mask = segment_mask(start, length);
+			array[Algorithm::bucket_index(start)].fetch_and((BaseInt) ~mask,
+					order);
+			Size filled = bit_word::popcount(mask);
+			start += filled;
+			length -= filled;
+		}
+	}
+
+	void clear_range(Size start, Size length,
+			std::memory_order order = std::memory_order_acq_rel)
+	{
+		release_range(start, length, order);
+	}
+
+	void merge(const PlainType& other,
+			std::memory_order order = std::memory_order_acq_rel)
+	{
+		for (Size index = 0; index < BUCKETS(); ++index)
+			if (other.array[index])
+				array[index].fetch_or(other.array[index], order);
+	}
+
+	void merge(const SelfType& other,
+			std::memory_order order = std::memory_order_acq_rel)
+	{
+		for (Size index = 0; index < BUCKETS(); ++index)
+		{
+			BaseInt word = other.array[index].load(std::memory_order_acquire);
+			if (word)
+				array[index].fetch_or(word, order);
+		}
+	}
+
+	void intersect(const PlainType& other,
+			std::memory_order order = std::memory_order_acq_rel)
+	{
+		for (Size index = 0; index < BUCKETS(); ++index)
+			if ((BaseInt) ~other.array[index])
+				array[index].fetch_and(other.array[index], order);
+	}
+
+	bool is_collide(const PlainType& other,
+			std::memory_order order = std::memory_order_acquire) const
+	{
+		for (Size index = 0; index < BUCKETS(); ++index)
+			if (other.array[index] & array[index].load(order))
+				return true;
+		return false;
+	}
+
+	//Claims the first clear bit and returns its index, or TotalBits if full.
+	//fetch_or claims the bit, so a conflict only costs a retry on the same word.
+	Size claim_first_zero(std::memory_order order = std::memory_order_acq_rel)
+	{
+		for (Size bucket = 0; bucket < BUCKETS(); ++bucket)
+		{
+			BaseInt word = array[bucket].load(std::memory_order_relaxed);
+			while ((BaseInt) ~word)
+			{
+				Size sub = bit_word::clz((BaseInt) ~word);
+				BaseInt marker = Algorithm::mark_bit(sub);
+				BaseInt prev = array[bucket].fetch_or(marker, order);
+				if (!(prev & marker))
+					return bucket * BIT_COUNT() + sub;
+				word = prev | marker;
+			}
+		}
+		return TotalBits;
+	}
+
+	//Claims a clear run of length bits by CAS and returns its start, or
+	//TotalBits if no run is free. Retries only when another thread wins.
+	Size claim_range(Size length, Size hint = 0,
+			std::memory_order order = std::memory_order_acq_rel)
+	{
+		if (length == 0 || length > TotalBits)
+			return TotalBits;
+		while (true)
+		{
+			Size found = snapshot(std::memory_order_relaxed).find_zero_run(
+					length, hint);
+			if (found == TotalBits)
+				return TotalBits;
+			if (try_claim(found, length, order))
+				return found;
+			hint = found;
+		}
+	}
+
+	Size count(std::memory_order order = std::memory_order_acquire) const
+	{
+		Size total = 0;
+		for (Size index = 0; index < BUCKETS(); ++index)
+			total += bit_word::popcount(array[index].load(order));
+		return total;
+	}
+
+	void clear(std::memory_order order = std::memory_order_release)
+	{
+		for (Size index = 0; index < BUCKETS(); ++index)
+			array[index].store((BaseInt) 0, order);
+	}
+
+	void fill(std::memory_order order = std::memory_order_release)
+	{
+		for (Size index = 0; index < BUCKETS(); ++index)
+			array[index].store((BaseInt) ~(BaseInt) 0, order);
+	}
+
+	//bucket-wise copy; not a consistent view under concurrent writers
+	PlainType snapshot(std::memory_order order = std::memory_order_acquire) const
+	{
+		PlainType ret(false);
+		for (Size index = 0; index < BUCKETS(); ++index)
+			ret.array[index] = array[index].load(order);
+		return ret;
+	}
+};
+
+}
+
+#endif /* INCLUDE_R_ATOMIC_BIT_ARRAY_HPP_ */
@@ -0,0 +1,354 @@
+/*
+ * bit_algorithm.hpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef INCLUDE_R_BIT_ALGORITHM_HPP_
+#define INCLUDE_R_BIT_ALGORITHM_HPP_
+
+#include <type_traits>
+#include <algorithm>
+#include <cstring>
+
+#include <R/bit_kernel.hpp>
+#include <R/bit_word.hpp>
+
+#ifdef FUNC_ATTR
+#define __func__attr__ FUNC_ATTR
+#else
+#define __func__attr__
+#endif
+
+namespace R
+{
+
+//Bucket math and word-at-a-time algorithms shared by BitArray, BitVector
+//and the other bitmap containers. Bit 0 is the MSB of bucket 0.
+//Functions work on a raw bucket pointer; "buckets" is the bucket count and
+//searches return buckets * BIT_COUNT() when nothing is found.
+template<typename BaseInt>
+struct BitAlgorithm
+{
+	static_assert(std::is_integral<BaseInt>::value, "Integer type required.");
+	static_assert(std::is_unsigned<BaseInt>::value, "Unsigned type required.");
+
+	typedef std::size_t Size;
+
+	constexpr static Size BIT_COUNT()
+	{
+		return ((Size) (sizeof(BaseInt) * 8));
+	}
+	constexpr static BaseInt LOW_FLAG()
+	{
+		return ((BaseInt) 1);
+	}
+	constexpr static BaseInt HIGH_FLAG()
+	{
+		return ((LOW_FLAG()) << (BIT_COUNT() - 1));
+	}
+	constexpr static BaseInt ZERO()
+	{
+		return ((BaseInt) 0);
+	}
+	constexpr static BaseInt MASK()
+	{
+		return (~ZERO());
+	}
+	//buffers smaller than one SSE register stay on the scalar loops
+	constexpr static Size KERNEL_MIN_BYTES()
+	{
+		return ((Size) 16);
+	}
+
+	constexpr static BaseInt mark_bit(Size index)
+	{
+		return ((BaseInt) (HIGH_FLAG()) >> (BaseInt) (index));
+	}
+
+	//shifting by the full width is undefined, so count == BIT_COUNT() is special
+	constexpr static inline BaseInt fill_left(Size count)
+	{
+		return (count >= BIT_COUNT()) ? MASK() : (BaseInt) ~(MASK() >> count);
+	}
+
+	constexpr static inline BaseInt fill_right(Size count)
+	{
+		return (count == 0) ? ZERO() : (BaseInt) (MASK() >> (BIT_COUNT() - count));
+	}
+
+	constexpr static inline Size bucket_index(Size count)
+	{
+		return count / BIT_COUNT();
+	}
+
+	constexpr static inline Size sub_index(Size count)
+	{
+		return count % BIT_COUNT();
+	}
+
+	constexpr static inline Size buckets_for(Size bits)
+	{
+		return (bits + BIT_COUNT() - 1) / BIT_COUNT();
+	}
+
+	__func__attr__
+	static bool get_bit(const BaseInt* array, Size index)
+	{
+		return !!(mark_bit(sub_index(index)) & array[bucket_index(index)]);
+	}
+
+	__func__attr__
+	static void set_bit(BaseInt* array, Size index)
+	{
+		array[bucket_index(index)] |= mark_bit(sub_index(index));
+	}
+
+	__func__attr__
+	static void clear_bit(BaseInt* array, Size index)
+	{
+		array[bucket_index(index)] &= (BaseInt) (~mark_bit(sub_index(index)));
+	}
+
+	__func__attr__
+	static void set_range(BaseInt* array, Size start, Size length)
+	{
+		Size start_offset = sub_index(start);
+		Size current_bucket = bucket_index(start);
+
+		if (start_offset > 0)
+		{
+			Size current_fill = std::min(length + start_offset, BIT_COUNT())
+					- start_offset;
+			BaseInt current_mask = fill_left(current_fill) >> start_offset;
+			array[current_bucket++] |= current_mask;
+			length -= current_fill;
+			start_offset = 0;
+		}
+
+		while (length > 0)
+		{
+			Size current_fill = std::min(length, BIT_COUNT());
+			BaseInt current_mask = fill_left(current_fill);
+			array[current_bucket++] |= current_mask;
+			length -= current_fill;
+		}
+	}
+
+	__func__attr__
+	static void clear_range(BaseInt* array, Size start, Size length)
+	{
+		Size start_offset = sub_index(start);
+		Size current_bucket = bucket_index(start);
+
+		if (start_offset > 0)
+		{
+			Size current_fill = std::min(length + start_offset, BIT_COUNT())
+					- start_offset;
+			BaseInt current_mask = fill_left(current_fill) >> start_offset;
+			array[current_bucket++] &= (~current_mask);
+			length -= current_fill;
+			start_offset = 0;
+		}
+
+		while (length > 0)
+		{
+			Size current_fill = std::min(length, BIT_COUNT());
+			BaseInt current_mask = fill_left(current_fill);
+			array[current_bucket++] &= (~current_mask);
+			length -= current_fill;
+		}
+	}
+
+	__func__attr__
+	static bool is_collide(const BaseInt* array, const BaseInt* other,
+			Size buckets)
+	{
+#ifdef R_BIT_KERNEL_X86
+		if (buckets * sizeof(BaseInt) >= KERNEL_MIN_BYTES())
+			return bit_kernel::active().is_collide(array, other,
+					buckets * sizeof(BaseInt));
+#endif
+		for (Size index = 0; index < buckets; ++index)
+			if (array[index] & other[index])
+				return true;
+		return false;
+	}
+
+	__func__attr__
+	static void merge(BaseInt* array, const BaseInt* other, Size buckets)
+	{
+#ifdef R_BIT_KERNEL_X86
+		if (buckets * sizeof(BaseInt) >= KERNEL_MIN_BYTES())
+		{
+			bit_kernel::active().merge(array, other, buckets * sizeof(BaseInt));
+			return;
+		}
+#endif
+		for (Size index = 0; index < buckets; ++index)
+			array[index] |= other[index];
+	}
+
+	__func__attr__
+	static void intersect(BaseInt* array, const BaseInt* other, Size buckets)
+	{
+#ifdef R_BIT_KERNEL_X86
+		if (buckets * sizeof(BaseInt) >= KERNEL_MIN_BYTES())
+		{
+			bit_kernel::active().intersect(array, other,
+					buckets * sizeof(BaseInt));
+			return;
+		}
+#endif
+		for (Size index = 0; index < buckets; ++index)
+			array[index] &= other[index];
+	}
+
+	__func__attr__
+	static bool equal(const BaseInt* array, const BaseInt* other, Size buckets)
+	{
+#ifdef R_BIT_KERNEL_X86
+		if (buckets * sizeof(BaseInt) >= KERNEL_MIN_BYTES())
+			return bit_kernel::active().equal(array, other,
+					buckets * sizeof(BaseInt));
+#endif
+		for (Size index = 0; index < buckets; ++index)
+			if (array[index] != other[index])
+				return false;
+		return true;
+	}
+
+	__func__attr__
+	static Size count(const BaseInt* array, Size buckets)
+	{
+		Size total = 0;
+		for (Size index = 0; index < buckets; ++index)
+			total += bit_word::popcount(array[index]);
+		return total;
+	}
+
+	//first index >= start whose bit equals the target
+	template<bool Target>
+	__func__attr__ static Size find_from(const BaseInt* array, Size buckets,
+			Size start)
+	{
+		if (start >= buckets * BIT_COUNT())
+			return buckets * BIT_COUNT();
+		Size bucket = bucket_index(start);
+		BaseInt word = Target ? array[bucket] : (BaseInt) ~array[bucket];
+		word &= (BaseInt) (MASK() >> sub_index(start));
+		while (true)
+		{
+			if (word)
+				return bucket * BIT_COUNT() + bit_word::clz(word);
+			if (++bucket == buckets)
+				return buckets * BIT_COUNT();
+			word = Target ? array[bucket] : (BaseInt) ~array[bucket];
+		}
+	}
+
+	//first clear run of at least length bits starting at or after start
+	__func__attr__
+	static Size find_zero_run_from(const BaseInt* array, Size buckets,
+			Size length, Size start)
+	{
+		if (start >= buckets * BIT_COUNT())
+			return buckets * BIT_COUNT();
+		Size bucket = bucket_index(start);
+		//bits before start are treated as set
+		BaseInt word = array[bucket] | fill_left(sub_index(start));
+		Size run = 0;
+		Size run_start = start;
+
+		while (true)
+		{
+			Size base = bucket * BIT_COUNT();
+			if (word == ZERO())
+			{
+				if (run == 0)
+					run_start = base;
+				run += BIT_COUNT();
+				if (run >= length)
+					return run_start;
+			}
+			else
+			{
+				Size pos = bit_word::clz(word);
+				if (run + pos >= length)
+					return (run == 0) ? base : run_start;
+
+				//runs inside the word, between set bits
+				while (true)
+				{
+					pos += bit_word::clz_or_bits((BaseInt) ~(BaseInt) (word << pos));
+					if (pos >= BIT_COUNT())
+					{
+						run = 0;
+						break;
+					}
+					Size zeros = std::min(
+							bit_word::clz_or_bits((BaseInt) (word << pos)),
+							BIT_COUNT() - pos);
+					if (zeros >= length)
+						return base + pos;
+					if (pos + zeros == BIT_COUNT())
+					{
+						//carried into the next bucket
+						run = zeros;
+						run_start = base + pos;
+						break;
+					}
+					pos += zeros;
+				}
+			}
+			if (++bucket == buckets)
+				return buckets * BIT_COUNT();
+			word = array[bucket];
+		}
+	}
+
+	//Finds the first clear run of at least length bits inside [0, total),
+	//searching from hint and wrapping around. Returns total if none.
+	//Bits past total in the last bucket must be clear.
+	__func__attr__
+	static Size find_zero_run(const BaseInt* array, Size total, Size length,
+			Size hint)
+	{
+		if (length > total)
+			return total;
+		if (hint >= total)
+			hint = 0;
+		if (length == 0)
+			return hint;
+		Size buckets = buckets_for(total);
+		Size found = find_zero_run_from(array, buckets, length, hint);
+		if ((found + length > total) && hint > 0)
+			found = find_zero_run_from(array, buckets, length, 0);
+		return (found + length > total) ? total : found;
+	}
+
+	//calls fn(index) for every set bit, in ascending index order
+	template<typename Function>
+	__func__attr__ static void for_each_set_bit(const BaseInt* array,
+			Size buckets, Function && fn)
+	{
+		for (Size bucket = 0; bucket < buckets; ++bucket)
+		{
+			BaseInt word = array[bucket];
+			while (word)
+			{
+				Size sub = bit_word::clz(word);
+				fn(bucket * BIT_COUNT() + sub);
+				word &= (BaseInt) ~mark_bit(sub);
+			}
+		}
+	}
+};
+
+}
+
+#ifdef __func__attr__
+#undef __func__attr__
+#endif
+
+#endif /* INCLUDE_R_BIT_ALGORITHM_HPP_ */
@@ -9,8 +9,14 @@
 #define INCLUDE_R_BIT_ARRAY_HPP_
 
 #include <type_traits>
+#include <array>
 #include <algorithm>
 #include <ostream>
+#include <utility>
+#include <cassert>
+
+#include <R/bit_algorithm.hpp>
+#include <R/bit_expression.hpp>
 
 #ifdef FUNC_ATTR
 #define __func__attr__ FUNC_ATTR
@@ -18,9 +24,113 @@
 #define __func__attr__
 #endif
 
+//True while a constant expression is evaluated, so constexpr queries can
+//avoid the SIMD kernels there and keep them at run time. This needs
+//__builtin_is_constant_evaluated (GCC 10, clang 9 or later); without it
+//count, is_collide, == and != always take the kernels and are usable only
+//at run time, while the factories and get_bit stay constant expressions.
+//R_HAS_CONSTANT_EVALUATED tells which case applies.
+#ifndef R_CONSTANT_EVALUATED
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+#define R_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#endif
+#endif
+#endif
+#ifdef R_CONSTANT_EVALUATED
+#define R_HAS_CONSTANT_EVALUATED 1
+#else
+#define R_HAS_CONSTANT_EVALUATED 0
+#define R_CONSTANT_EVALUATED() false
+#endif
+
 namespace R
 {
 
+template<typename BaseInt, std::size_t TotalBits>
+class AtomicBitArray;
+
+//Compile-time index lists for building BitArray words in constant
+//expressions. The list is built by halving, so the instantiation depth
+//stays logarithmic even for thousands of buckets.
+namespace bit_index
+{
+
+typedef std::size_t Size;
+
+template<Size... Index>
+struct List
+{
+};
+
+template<typename Left, typename Right>
+struct Concat;
+
+template<Size... Left, Size... Right>
+struct Concat<List<Left...>, List<Right...> >
+{
+	typedef List<Left..., (sizeof...(Left) + Right)...> Type;
+};
+
+template<Size Count>
+struct Make
+{
+	typedef typename Concat<typename Make<Count / 2>::Type,
+			typename Make<Count - Count / 2>::Type>::Type Type;
+};
+
+template<>
+struct Make<0>
+{
+	typedef List<> Type;
+};
+
+template<>
+struct Make<1>
+{
+	typedef List<0> Type;
+};
+
+}
+
+//Plain bucket array whose const accessors are constexpr in C++11,
+//unlike std::array.
+template<typename BaseInt, std::size_t Count>
+struct BitStorage
+{
+	BaseInt words[Count > 0 ? Count : 1];
+
+	__func__attr__
+	constexpr const BaseInt& operator[](std::size_t index) const
+	{
+		return words[index];
+	}
+
+	__func__attr__
+	BaseInt& operator[](std::size_t index)
+	{
+		return words[index];
+	}
+
+	__func__attr__
+	constexpr const BaseInt* data() const
+	{
+		return words;
+	}
+
+	__func__attr__
+	BaseInt* data()
+	{
+		return words;
+	}
+
+	__func__attr__
+	void fill(BaseInt value)
+	{
+		std::fill(words, words + Count, value);
+	}
+};
+
 template<typename BaseInt, std::size_t TotalBits>
 class BitArray
 {
@@ -31,6 +141,7 @@ class BitArray
 private:
 	typedef std::size_t Size;
 	typedef BitArray<BaseInt, TotalBits> SelfType;
+	typedef BitAlgorithm<BaseInt> Algorithm;
 
 	constexpr static Size BUCKETS()
 	{
@@ -38,59 +149,151 @@ private:
 	}
 	constexpr static Size BIT_COUNT()
 	{
-		return ((Size) (sizeof(BaseInt) * 8));
-	}
-	constexpr static BaseInt LOW_FLAG()
-	{
-		return ((BaseInt) 1);
-	}
-	constexpr static BaseInt HIGH_FLAG()
-	{
-		return ((LOW_FLAG()) << (BIT_COUNT() - 1));
+		return Algorithm::BIT_COUNT();
 	}
 	constexpr static BaseInt ZERO()
 	{
-		return ((BaseInt) 0);
+		return Algorithm::ZERO();
 	}
 	constexpr static BaseInt MASK()
 	{
-		return (~ZERO());
+		return Algorithm::MASK();
 	}
 
-	std::array<BaseInt, BUCKETS()> array;
+	BitStorage<BaseInt, BUCKETS()> array;
+
+	friend class AtomicBitArray<BaseInt, TotalBits>;
 
 private:
 	constexpr static BaseInt mark_bit(Size index)
 	{
-		return ((BaseInt) (HIGH_FLAG()) >> (BaseInt) (index));
+		return Algorithm::mark_bit(index);
 	}
 
 	constexpr static inline BaseInt fill_left(Size count)
 	{
-		return ~(MASK() >> count);
+		return Algorithm::fill_left(count);
 	}
 
 	constexpr static inline BaseInt fill_right(Size count)
 	{
-		return (MASK() >> (BIT_COUNT() - count));
+		return Algorithm::fill_right(count);
 	}
 
 	constexpr static inline Size bucket_index(Size count)
 	{
-		return count / BIT_COUNT();
+		return Algorithm::bucket_index(count);
 	}
 
 	constexpr static inline Size sub_index(Size count)
 	{
-		return count % BIT_COUNT();
+		return Algorithm::sub_index(count);
+	}
+
+	//Word builders for the constexpr constructors. C++11 constexpr
+	//functions are single expressions, hence the recursion.
+	constexpr static BaseInt word_of_bits(Size)
+	{
+		return ZERO();
+	}
+
+	template<typename... Rest>
+	constexpr static BaseInt word_of_bits(Size bucket, Size first, Rest... rest)
+	{
+		return (BaseInt) ((bucket_index(first) == bucket ?
+				mark_bit(sub_index(first)) : ZERO())
+				| word_of_bits(bucket, rest...));
+	}
+
+	//the part of [start, end) inside [base, base + BIT_COUNT())
+	constexpr static BaseInt word_of_range(Size base, Size start, Size end)
+	{
+		return (end <= base || start >= base + BIT_COUNT()) ? ZERO() :
+				(BaseInt) (fill_left(end - base < BIT_COUNT() ?
+						end - base : BIT_COUNT())
+						& (BaseInt) ~fill_left(start > base ? start - base : 0));
+	}
+
+	constexpr static BaseInt word_of_string(const char* text, Size length,
+			Size base, Size sub)
+	{
+		return sub == BIT_COUNT() ? ZERO() :
+				(BaseInt) ((base + sub < length && text[base + sub] == '1' ?
+						mark_bit(sub) : ZERO())
+						| word_of_string(text, length, base, sub + 1));
+	}
+
+	struct BitsTag
+	{
+	};
+	struct RangeTag
+	{
+	};
+	struct StringTag
+	{
+	};
+
+	template<Size... Bucket, typename... Bits>
+	constexpr BitArray(BitsTag, bit_index::List<Bucket...>, Bits... bits) :
+			array { { word_of_bits(Bucket, bits...)... } }
+	{
+	}
+
+	template<Size... Bucket>
+	constexpr BitArray(RangeTag, bit_index::List<Bucket...>, Size start,
+			Size end) :
+			array { { word_of_range(Bucket * BIT_COUNT(), start, end)... } }
+	{
+	}
+
+	template<Size... Bucket>
+	constexpr BitArray(StringTag, bit_index::List<Bucket...>, const char* text,
+			Size length) :
+			array { { word_of_string(text, length, Bucket * BIT_COUNT(), 0)... } }
+	{
+	}
+
+	//Constant-evaluation forms of the queries, split in halves so the
+	//recursion depth is logarithmic in the number of buckets.
+	constexpr static Size popcount_word(BaseInt word)
+	{
+		return word ? 1 + popcount_word((BaseInt) (word & (word - 1))) : 0;
+	}
+
+	constexpr Size count_words(Size first, Size length) const
+	{
+		return length == 1 ? popcount_word(array[first]) :
+				count_words(first, length / 2)
+						+ count_words(first + length / 2, length - length / 2);
+	}
+
+	constexpr bool equal_words(const SelfType& other, Size first,
+			Size length) const
+	{
+		return length == 1 ? array[first] == other.array[first] :
+				equal_words(other, first, length / 2)
+						&& equal_words(other, first + length / 2,
+								length - length / 2);
+	}
+
+	constexpr bool collide_words(const SelfType& other, Size first,
+			Size length) const
+	{
+		return length == 1 ? (array[first] & other.array[first]) != 0 :
+				collide_words(other, first, length / 2)
+						|| collide_words(other, first + length / 2,
+								length - length / 2);
 	}
 public:
+	//all clear; value-initialization keeps it a constant expression
 	__func__attr__
-	BitArray() :
-			BitArray(false)
+	constexpr BitArray() :
+			array()
 	{
 	}
 
+	//Stays a run-time fill: expanding every bucket would bloat the code of
+	//large arrays. Use from_range(0, TotalBits) for a constexpr full mask.
 	__func__attr__
 	BitArray(bool initial)
 	{
@@ -100,48 +303,92 @@ public:
 			this->clear();
 	}
 
+	BitArray(const SelfType& source) = default;
+
+	//Builders usable in constant expressions, e.g.
+	//constexpr auto mask = BitArray<uint64_t, 128>::from_bits(1, 5, 70);
+	template<typename... Bits>
+	constexpr static SelfType from_bits(Bits... bits)
+	{
+		return SelfType(BitsTag(), typename bit_index::Make<BUCKETS()>::Type(),
+				bits...);
+	}
+
+	constexpr static SelfType from_range(Size start, Size length)
+	{
+		return SelfType(RangeTag(), typename bit_index::Make<BUCKETS()>::Type(),
+				start, start + length);
+	}
+
+	//'1' sets the bit at its position, any other character clears it
+	template<std::size_t Length>
+	constexpr static SelfType from_string(const char (&text)[Length])
+	{
+		return SelfType(StringTag(), typename bit_index::Make<BUCKETS()>::Type(),
+				text, Length - 1);
+	}
+
+	//evaluates a bitwise expression in a single pass
+	template<typename Expression>
 	__func__attr__
-	BitArray(const SelfType& source)
+	BitArray(const BitExpression<Expression>& expression)
 	{
-		this->array = source.array;
+		*this = expression;
 	}
 
+	SelfType& operator=(const SelfType& source) = default;
+
+	//The expression may refer to this array: word i only reads word i.
+	template<typename Expression>
 	__func__attr__
-	~BitArray()
+	SelfType& operator=(const BitExpression<Expression>& expression)
+	{
+		assert(expression.self().buckets() == BUCKETS());
+		evaluate_bit_expression(this->array.data(), expression, BUCKETS());
+		return *this;
+	}
+
+	constexpr static Size buckets()
 	{
+		return BUCKETS();
 	}
 
-	template<typename OtherInt>
-	__func__attr__ bool is_collide(const SelfType& other) const
+	__func__attr__
+	BaseInt* data()
 	{
-		for (Size index = 0; index < BUCKETS(); ++index)
-			if (this->array[index] & other.array[index])
-				return true;
-		return false;
+		return this->array.data();
+	}
+
+	__func__attr__
+	constexpr const BaseInt* data() const
+	{
+		return this->array.data();
+	}
+
+	__func__attr__
+	constexpr bool is_collide(const SelfType& other) const
+	{
+		return R_CONSTANT_EVALUATED() ? collide_words(other, 0, BUCKETS()) :
+				Algorithm::is_collide(this->array.data(), other.array.data(),
+						BUCKETS());
 	}
 
 	__func__attr__
 	void merge(const SelfType& other)
 	{
-		for (int index = 0; index < BUCKETS(); ++index)
-			this->array[index] |= other.array[index];
+		Algorithm::merge(this->array.data(), other.array.data(), BUCKETS());
 	}
 
 	__func__attr__
 	void intersect(const SelfType& other)
 	{
-		for (int index = 0; index < BUCKETS(); ++index)
-			this->array[index] &= other.array[index];
+		Algorithm::intersect(this->array.data(), other.array.data(), BUCKETS());
 	}
 
 	__func__attr__
-	bool get_bit(Size index) const
+	constexpr bool get_bit(Size index) const
 	{
-		auto bucket = bucket_index(index);
-		auto sub = sub_index(index);
-		auto checker = mark_bit(sub);
-
-		return !!(checker & this->array[bucket]);
+		return !!(mark_bit(sub_index(index)) & this->array[bucket_index(index)]);
 	}
 
 	__func__attr__
@@ -165,51 +412,79 @@ public:
 	__func__attr__
 	void set_range(Size start, Size length)
 	{
-		Size start_offset = sub_index(start);
-		Size current_bucket = bucket_index(start);
+		Algorithm::set_range(this->array.data(), start, length);
+	}
 
-		if (start_offset > 0)
-		{
-			Size current_fill = std::min(length + start_offset, BIT_COUNT())
-					- start_offset;
-			BaseInt current_mask = fill_left(current_fill) >> start_offset;
-			this->array[current_bucket++] |= current_mask;
-			length -= current_fill;
-			start_offset = 0;
-		}
+	__func__attr__
+	void clear_range(Size start, Size length)
+	{
+		Algorithm::clear_range(this->array.data(), start, length);
+	}
 
-		while (length > 0)
-		{
-			Size current_fill = std::min(length, BIT_COUNT());
-			BaseInt current_mask = fill_left(current_fill);
-			this->array[current_bucket++] |= current_mask;
-			length -= current_fill;
-		}
+	//number of set bits
+	__func__attr__
+	constexpr Size count() const
+	{
+		return R_CONSTANT_EVALUATED() ? count_words(0, BUCKETS()) :
+				Algorithm::count(this->array.data(), BUCKETS());
 	}
 
+	//Find functions follow the get_bit order and return TotalBits if not found.
 	__func__attr__
-	void clear_range(Size start, Size length)
+	Size find_first_set() const
 	{
-		Size start_offset = sub_index(start);
-		Size current_bucket = bucket_index(start);
+		return Algorithm::template find_from<true>(this->array.data(),
+				BUCKETS(), 0);
+	}
 
-		if (start_offset > 0)
-		{
-			Size current_fill = std::min(length + start_offset, BIT_COUNT())
-					- start_offset;
-			BaseInt current_mask = fill_left(current_fill) >> start_offset;
-			this->array[current_bucket++] &= (~current_mask);
-			length -= current_fill;
-			start_offset = 0;
-		}
+	//first set bit strictly after pos
+	__func__attr__
+	Size find_next_set(Size pos) const
+	{
+		return Algorithm::template find_from<true>(this->array.data(),
+				BUCKETS(), pos + 1);
+	}
 
-		while (length > 0)
-		{
-			Size current_fill = std::min(length, BIT_COUNT());
-			BaseInt current_mask = fill_left(current_fill);
-			this->array[current_bucket++] &= (~current_mask);
-			length -= current_fill;
-		}
+	__func__attr__
+	Size find_first_zero() const
+	{
+		return Algorithm::template find_from<false>(this->array.data(),
+				BUCKETS(), 0);
+	}
+
+	//first clear bit strictly after pos
+	__func__attr__
+	Size find_next_zero(Size pos) const
+	{
+		return Algorithm::template find_from<false>(this->array.data(),
+				BUCKETS(), pos + 1);
+	}
+
+	//Finds the first clear run of at least length bits, searching from hint
+	//and wrapping around to the beginning. Returns TotalBits if none.
+	__func__attr__
+	Size find_zero_run(Size length, Size hint = 0) const
+	{
+		return Algorithm::find_zero_run(this->array.data(), TotalBits, length,
+				hint);
+	}
+
+	//Sets the run found by find_zero_run and returns its start.
+	__func__attr__
+	Size reserve_run(Size length, Size hint = 0)
+	{
+		Size found = find_zero_run(length, hint);
+		if (found != TotalBits)
+			this->set_range(found, length);
+		return found;
+	}
+
+	//calls fn(index) for every set bit, in ascending index order
+	template<typename Function>
+	__func__attr__ void for_each_set_bit(Function && fn) const
+	{
+		Algorithm::for_each_set_bit(this->array.data(), BUCKETS(),
+				std::forward<Function>(fn));
 	}
 
 	__func__attr__
@@ -224,27 +499,42 @@ public:
 		array.fill(MASK());
 	}
 
-	bool operator==(const SelfType& other) const
+	constexpr bool operator==(const SelfType& other) const
 	{
-		return this->array == other.array;
+		return R_CONSTANT_EVALUATED() ? equal_words(other, 0, BUCKETS()) :
+				Algorithm::equal(this->array.data(), other.array.data(),
+						BUCKETS());
 	}
 
-	bool operator!=(const SelfType& other) const
+	constexpr bool operator!=(const SelfType& other) const
 	{
-		return this->array != other.array;
+		return !(*this == other);
 	}
 
 	friend std::ostream& operator<<(std::ostream& os, const SelfType& me)
 	{
 		for (Size k = 0; k < TotalBits; ++k)
 		{
-			bool ret = me->get_bit(k);
+			bool ret = me.get_bit(k);
 			os << ret;
 		}
 		return os;
 	}
 };
 
+template<typename BaseInt, std::size_t TotalBits>
+struct BitOperand<BitArray<BaseInt, TotalBits> >
+{
+	static constexpr bool value = true;
+	typedef BitTerminal<BaseInt> Node;
+
+	__func__attr__
+	static Node make(const BitArray<BaseInt, TotalBits>& operand)
+	{
+		return Node(operand.data(), operand.buckets());
+	}
+};
+
 }
 
 #ifdef __func__attr__
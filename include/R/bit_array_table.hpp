@@ -0,0 +1,253 @@
+/*
+ * bit_array_table.hpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef INCLUDE_R_BIT_ARRAY_TABLE_HPP_
+#define INCLUDE_R_BIT_ARRAY_TABLE_HPP_
+
+#include <cstring>
+#include <vector>
+#include <algorithm>
+
+#include <R/bit_array.hpp>
+#include <R/bit_kernel.hpp>
+
+namespace R
+{
+
+//Table of N BitArrays stored bucket-major (structure of arrays), so one
+//query mask is tested against many entries at once: for every non-zero
+//bucket of the query, the matching column is AND-ed with the query word
+//and OR-ed into a per-entry accumulator by the SIMD kernels.
+//Entries are scanned in blocks; with the summary enabled each block keeps
+//the OR of its entries per bucket and blocks that cannot collide are skipped.
+template<typename BaseInt, std::size_t TotalBits>
+class BitArrayTable
+{
+public:
+	typedef std::size_t Size;
+	typedef BitArray<BaseInt, TotalBits> Mask;
+private:
+	constexpr static Size BUCKETS()
+	{
+		return Mask::buckets();
+	}
+	//entries scanned together; the accumulator stays in L1
+	constexpr static Size BLOCK()
+	{
+		return ((Size) 256);
+	}
+	constexpr static Size PATTERN_BYTES()
+	{
+		return ((Size) 64);
+	}
+
+	struct QueryBucket
+	{
+		Size bucket;
+		BaseInt word;
+		unsigned char pattern[64];
+	};
+
+	std::vector<std::vector<BaseInt> > _columns;
+	std::vector<BaseInt> _summary; //[block * BUCKETS() + bucket]
+	Size _size;
+	bool _use_summary;
+
+	void refresh_summary(Size block)
+	{
+		if (!_use_summary)
+			return;
+		Size first = block * BLOCK();
+		Size last = std::min(first + BLOCK(), _size);
+		for (Size bucket = 0; bucket < BUCKETS(); ++bucket)
+		{
+			BaseInt word = 0;
+			for (Size index = first; index < last; ++index)
+				word |= _columns[bucket][index];
+			_summary[block * BUCKETS() + bucket] = word;
+		}
+	}
+
+	static std::vector<QueryBucket> prepare(const Mask& query)
+	{
+		std::vector<QueryBucket> active;
+		for (Size bucket = 0; bucket < BUCKETS(); ++bucket)
+		{
+			BaseInt word = query.data()[bucket];
+			if (!word)
+				continue;
+			QueryBucket entry;
+			entry.bucket = bucket;
+			entry.word = word;
+			for (Size offset = 0; offset < PATTERN_BYTES(); offset += sizeof(BaseInt))
+				std::memcpy(entry.pattern + offset, &word, sizeof(BaseInt));
+			active.push_back(entry);
+		}
+		return active;
+	}
+
+	//Calls fn(index) for colliding entries in index order until it returns false.
+	template<typename Function>
+	void scan(const Mask& query, Function && fn) const
+	{
+		std::vector<QueryBucket> active = prepare(query);
+		if (active.empty())
+			return;
+		const bit_kernel::Table& kernel = bit_kernel::active();
+		BaseInt acc[BLOCK()];
+
+		for (Size first = 0; first < _size; first += BLOCK())
+		{
+			Size block = first / BLOCK();
+			Size length = std::min(BLOCK(), _size - first);
+			Size bytes = length * sizeof(BaseInt);
+			bool touched = false;
+
+			for (const QueryBucket& entry : active)
+			{
+				if (_use_summary
+						&& !(_summary[block * BUCKETS() + entry.bucket] & entry.word))
+					continue;
+				if (!touched)
+				{
+					std::memset(acc, 0, bytes);
+					touched = true;
+				}
+				kernel.and_or(acc, _columns[entry.bucket].data() + first,
+						entry.pattern, bytes);
+			}
+			if (!touched || !kernel.is_collide(acc, acc, bytes))
+				continue;
+			for (Size index = 0; index < length; ++index)
+				if (acc[index] && !fn(first + index))
+					return;
+		}
+	}
+
+public:
+	explicit BitArrayTable(bool use_summary = true) :
+			_columns(BUCKETS()), _size(0), _use_summary(use_summary)
+	{
+	}
+
+	Size size() const
+	{
+		return _size;
+	}
+
+	void reserve(Size entries)
+	{
+		for (auto& column : _columns)
+			column.reserve(entries);
+		if (_use_summary)
+			_summary.reserve((entries + BLOCK() - 1) / BLOCK() * BUCKETS());
+	}
+
+	void clear()
+	{
+		for (auto& column : _columns)
+			column.clear();
+		_summary.clear();
+		_size = 0;
+	}
+
+	//appends a mask and returns its index
+	Size push_back(const Mask& mask)
+	{
+		Size index = _size++;
+		if (_use_summary && index % BLOCK() == 0)
+			_summary.resize(_summary.size() + BUCKETS(), 0);
+		for (Size bucket = 0; bucket < BUCKETS(); ++bucket)
+		{
+			BaseInt word = mask.data()[bucket];
+			_columns[bucket].push_back(word);
+			if (_use_summary)
+				_summary[index / BLOCK() * BUCKETS() + bucket] |= word;
+		}
+		return index;
+	}
+
+	void set(Size index, const Mask& mask)
+	{
+		for (Size bucket = 0; bucket < BUCKETS(); ++bucket)
+			_columns[bucket][index] = mask.data()[bucket];
+		refresh_summary(index / BLOCK());
+	}
+
+	Mask get(Size index) const
+	{
+		Mask ret(false);
+		for (Size bucket = 0; bucket < BUCKETS(); ++bucket)
+			ret.data()[bucket] = _columns[bucket][index];
+		return ret;
+	}
+
+	//Removes an entry by moving the last one into its place.
+	void remove(Size index)
+	{
+		Size last = _size - 1;
+		for (auto& column : _columns)
+		{
+			column[index] = column[last];
+			column.pop_back();
+		}
+		_size = last;
+		if (_use_summary && last % BLOCK() == 0)
+			_summary.resize(_summary.size() - BUCKETS());
+		if (last % BLOCK() != 0)
+			refresh_summary(last / BLOCK());
+		if (index < _size && index / BLOCK() != last / BLOCK())
+			refresh_summary(index / BLOCK());
+	}
+
+	bool any_collision(const Mask& query) const
+	{
+		bool found = false;
+		scan(query, [&found](Size)
+		{
+			found = true;
+			return false;
+		});
+		return found;
+	}
+
+	//index of the first colliding entry, or size() if none
+	Size first_collision(const Mask& query) const
+	{
+		Size found = _size;
+		scan(query, [&found](Size index)
+		{
+			found = index;
+			return false;
+		});
+		return found;
+	}
+
+	std::vector<Size> all_collisions(const Mask& query) const
+	{
+		std::vector<Size> found;
+		scan(query, [&found](Size index)
+		{
+			found.push_back(index);
+			return true;
+		});
+		return found;
+	}
+
+	template<typename Function>
+	void for_each_collision(const Mask& query, Function && fn) const
+	{
+		scan(query, [&fn](Size index)
+		{
+			fn(index);
+			return true;
+		});
+	}
+};
+
+}
+
+#endif /* INCLUDE_R_BIT_ARRAY_TABLE_HPP_ */
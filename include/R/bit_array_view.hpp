@@ -0,0 +1,278 @@
+/*
+ * bit_array_view.hpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef INCLUDE_R_BIT_ARRAY_VIEW_HPP_
+#define INCLUDE_R_BIT_ARRAY_VIEW_HPP_
+
+#include <type_traits>
+#include <algorithm>
+#include <ostream>
+#include <utility>
+#include <cassert>
+
+#include <R/bit_algorithm.hpp>
+#include <R/bit_array.hpp>
+#include <R/bit_vector.hpp>
+
+namespace R
+{
+
+//Non-owning BitArray over external storage (shared memory, packet
+//buffers, mapped files). BaseInt may be const for a read-only view.
+//Bits past size() in the last bucket belong to the caller: they are
+//never read as members and never written.
+template<typename BaseInt>
+class BitArrayView
+{
+public:
+	typedef std::size_t Size;
+	typedef typename std::remove_const<BaseInt>::type Word;
+	typedef BitArrayView<const Word> ConstView;
+private:
+	static_assert(std::is_integral<Word>::value, "Integer type required.");
+	static_assert(std::is_unsigned<Word>::value, "Unsigned type required.");
+
+	typedef BitAlgorithm<Word> Algorithm;
+
+	template<typename OtherInt>
+	friend class BitArrayView;
+
+	BaseInt* _array;
+	Size _bits;
+
+	//buckets without foreign padding bits
+	Size full_buckets() const
+	{
+		return Algorithm::bucket_index(_bits);
+	}
+
+	//valid bits of the partial last bucket, if any
+	Word tail_mask() const
+	{
+		return Algorithm::fill_left(Algorithm::sub_index(_bits));
+	}
+
+	bool has_tail() const
+	{
+		return Algorithm::sub_index(_bits) != 0;
+	}
+
+public:
+	BitArrayView() :
+			_array(nullptr), _bits(0)
+	{
+	}
+
+	BitArrayView(BaseInt* array, Size bits) :
+			_array(array), _bits(bits)
+	{
+	}
+
+	//a mutable view converts to a read-only one
+	template<typename OtherInt, typename = typename std::enable_if<
+			std::is_same<const OtherInt, BaseInt>::value>::type>
+	BitArrayView(const BitArrayView<OtherInt>& other) :
+			_array(other._array), _bits(other._bits)
+	{
+	}
+
+	template<std::size_t TotalBits>
+	BitArrayView(BitArray<Word, TotalBits>& bits) :
+			_array(bits.data()), _bits(TotalBits)
+	{
+	}
+
+	template<std::size_t TotalBits>
+	BitArrayView(const BitArray<Word, TotalBits>& bits) :
+			_array(bits.data()), _bits(TotalBits)
+	{
+	}
+
+	BitArrayView(BitVector<Word>& bits) :
+			_array(bits.data()), _bits(bits.size())
+	{
+	}
+
+	BitArrayView(const BitVector<Word>& bits) :
+			_array(bits.data()), _bits(bits.size())
+	{
+	}
+
+	Size size() const
+	{
+		return _bits;
+	}
+
+	Size buckets() const
+	{
+		return Algorithm::buckets_for(_bits);
+	}
+
+	BaseInt* data() const
+	{
+		return _array;
+	}
+
+	bool is_collide(const ConstView& other) const
+	{
+		assert(_bits == other._bits);
+		if (Algorithm::is_collide(_array, other._array, full_buckets()))
+			return true;
+		return has_tail()
+				&& (_array[full_buckets()] & other._array[full_buckets()]
+						& tail_mask());
+	}
+
+	void merge(const ConstView& other) const
+	{
+		assert(_bits == other._bits);
+		Algorithm::merge(_array, other._array, full_buckets());
+		if (has_tail())
+			_array[full_buckets()] |= other._array[full_buckets()] & tail_mask();
+	}
+
+	void intersect(const ConstView& other) const
+	{
+		assert(_bits == other._bits);
+		Algorithm::intersect(_array, other._array, full_buckets());
+		if (has_tail())
+			_array[full_buckets()] &= other._array[full_buckets()]
+					| (Word) ~tail_mask();
+	}
+
+	bool get_bit(Size index) const
+	{
+		return Algorithm::get_bit(_array, index);
+	}
+
+	void set_bit(Size index) const
+	{
+		Algorithm::set_bit(_array, index);
+	}
+
+	void clear_bit(Size index) const
+	{
+		Algorithm::clear_bit(_array, index);
+	}
+
+	void set_range(Size start, Size length) const
+	{
+		Algorithm::set_range(_array, start, length);
+	}
+
+	void clear_range(Size start, Size length) const
+	{
+		Algorithm::clear_range(_array, start, length);
+	}
+
+	Size count() const
+	{
+		Size total = Algorithm::count(_array, full_buckets());
+		if (has_tail())
+			total += bit_word::popcount(
+					(Word) (_array[full_buckets()] & tail_mask()));
+		return total;
+	}
+
+	//Find functions follow the get_bit order and return size() if not found.
+	Size find_first_set() const
+	{
+		return std::min(_bits,
+				Algorithm::template find_from<true>(_array, buckets(), 0));
+	}
+
+	Size find_next_set(Size pos) const
+	{
+		return std::min(_bits,
+				Algorithm::template find_from<true>(_array, buckets(), pos + 1));
+	}
+
+	Size find_first_zero() const
+	{
+		return std::min(_bits,
+				Algorithm::template find_from<false>(_array, buckets(), 0));
+	}
+
+	Size find_next_zero(Size pos) const
+	{
+		return std::min(_bits,
+				Algorithm::template find_from<false>(_array, buckets(), pos + 1));
+	}
+
+	Size find_zero_run(Size length, Size hint = 0) const
+	{
+		return Algorithm::find_zero_run(_array, _bits, length, hint);
+	}
+
+	Size reserve_run(Size length, Size hint = 0) const
+	{
+		Size found = find_zero_run(length, hint);
+		if (found != _bits)
+			this->set_range(found, length);
+		return found;
+	}
+
+	template<typename Function>
+	void for_each_set_bit(Function && fn) const
+	{
+		Size bits = _bits;
+		Algorithm::for_each_set_bit(_array, buckets(), [bits, &fn](Size index)
+		{
+			if (index < bits)
+				fn(index);
+		});
+	}
+
+	void clear() const
+	{
+		this->clear_range(0, _bits);
+	}
+
+	void fill() const
+	{
+		this->set_range(0, _bits);
+	}
+
+	//copies the bits of another view of the same size
+	void assign(const ConstView& other) const
+	{
+		assert(_bits == other._bits);
+		std::copy(other._array, other._array + full_buckets(), _array);
+		if (has_tail())
+			_array[full_buckets()] = (Word) ((_array[full_buckets()]
+					& (Word) ~tail_mask())
+					| (other._array[full_buckets()] & tail_mask()));
+	}
+
+	bool operator==(const ConstView& other) const
+	{
+		if (_bits != other._bits
+				|| !Algorithm::equal(_array, other._array, full_buckets()))
+			return false;
+		return !has_tail()
+				|| !((_array[full_buckets()] ^ other._array[full_buckets()])
+						& tail_mask());
+	}
+
+	bool operator!=(const ConstView& other) const
+	{
+		return !(*this == other);
+	}
+
+	friend std::ostream& operator<<(std::ostream& os, const BitArrayView& me)
+	{
+		for (Size k = 0; k < me._bits; ++k)
+		{
+			bool ret = me.get_bit(k);
+			os << ret;
+		}
+		return os;
+	}
+};
+
+}
+
+#endif /* INCLUDE_R_BIT_ARRAY_VIEW_HPP_ */
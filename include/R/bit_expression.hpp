@@ -0,0 +1,315 @@
+/*
+ * bit_expression.hpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef INCLUDE_R_BIT_EXPRESSION_HPP_
+#define INCLUDE_R_BIT_EXPRESSION_HPP_
+
+#include <type_traits>
+#include <cassert>
+
+#include <R/bit_word.hpp>
+
+#ifdef FUNC_ATTR
+#define __func__attr__ FUNC_ATTR
+#else
+#define __func__attr__
+#endif
+
+namespace R
+{
+
+//Expression templates for the non-mutating bitwise operators.
+//(a & b) | (c & ~d) builds a tree of lightweight nodes which is evaluated
+//word by word in one pass when it is assigned to a bitmap or reduced by
+//count(), any() or is_collide(). Leaves refer to their operands, so an
+//expression must not outlive them: evaluate it in the same statement.
+template<typename Derived>
+class BitExpression
+{
+public:
+	typedef std::size_t Size;
+
+	__func__attr__
+	const Derived& self() const
+	{
+		return static_cast<const Derived&>(*this);
+	}
+
+	__func__attr__
+	Size count() const
+	{
+		const Derived& expression = self();
+		Size total = 0;
+		for (Size index = 0; index < expression.buckets(); ++index)
+			total += bit_word::popcount(expression.word(index));
+		return total;
+	}
+
+	//stops at the first non-zero block of words
+	__func__attr__
+	bool any() const
+	{
+		typedef typename Derived::Word Word;
+		const Size BLOCK = 64 / sizeof(Word);
+		const Derived& expression = self();
+		Size buckets = expression.buckets();
+		Size index = 0;
+		for (; index + BLOCK <= buckets; index += BLOCK)
+		{
+			Word acc = 0;
+			for (Size k = 0; k < BLOCK; ++k)
+				acc |= expression.word(index + k);
+			if (acc)
+				return true;
+		}
+		for (; index < buckets; ++index)
+			if (expression.word(index))
+				return true;
+		return false;
+	}
+
+	__func__attr__
+	bool none() const
+	{
+		return !any();
+	}
+
+	template<typename Other>
+	__func__attr__ bool is_collide(const Other& other) const
+	{
+		return (self() & other).any();
+	}
+};
+
+//leaf over a contiguous bucket array
+template<typename BaseInt>
+class BitTerminal: public BitExpression<BitTerminal<BaseInt> >
+{
+public:
+	typedef std::size_t Size;
+	typedef BaseInt Word;
+private:
+	const BaseInt* _array;
+	Size _buckets;
+public:
+	__func__attr__
+	BitTerminal(const BaseInt* array, Size buckets) :
+			_array(array), _buckets(buckets)
+	{
+	}
+
+	__func__attr__
+	Word word(Size index) const
+	{
+		return _array[index];
+	}
+
+	__func__attr__
+	Size buckets() const
+	{
+		return _buckets;
+	}
+};
+
+namespace bit_op
+{
+
+struct And
+{
+	template<typename Word>
+	__func__attr__ static Word apply(Word left, Word right)
+	{
+		return (Word) (left & right);
+	}
+};
+
+struct Or
+{
+	template<typename Word>
+	__func__attr__ static Word apply(Word left, Word right)
+	{
+		return (Word) (left | right);
+	}
+};
+
+struct Xor
+{
+	template<typename Word>
+	__func__attr__ static Word apply(Word left, Word right)
+	{
+		return (Word) (left ^ right);
+	}
+};
+
+struct AndNot
+{
+	template<typename Word>
+	__func__attr__ static Word apply(Word left, Word right)
+	{
+		return (Word) (left & ~right);
+	}
+};
+
+}
+
+template<typename Op, typename Left, typename Right>
+class BitBinary: public BitExpression<BitBinary<Op, Left, Right> >
+{
+	static_assert(std::is_same<typename Left::Word,
+			typename Right::Word>::value, "Operands must share BaseInt.");
+public:
+	typedef std::size_t Size;
+	typedef typename Left::Word Word;
+private:
+	Left _left;
+	Right _right;
+public:
+	__func__attr__
+	BitBinary(const Left& left, const Right& right) :
+			_left(left), _right(right)
+	{
+		assert(left.buckets() == right.buckets());
+	}
+
+	__func__attr__
+	Word word(Size index) const
+	{
+		return Op::apply(_left.word(index), _right.word(index));
+	}
+
+	__func__attr__
+	Size buckets() const
+	{
+		return _left.buckets();
+	}
+};
+
+template<typename Operand>
+class BitInvert: public BitExpression<BitInvert<Operand> >
+{
+public:
+	typedef std::size_t Size;
+	typedef typename Operand::Word Word;
+private:
+	Operand _operand;
+public:
+	__func__attr__
+	explicit BitInvert(const Operand& operand) :
+			_operand(operand)
+	{
+	}
+
+	__func__attr__
+	Word word(Size index) const
+	{
+		return (Word) ~_operand.word(index);
+	}
+
+	__func__attr__
+	Size buckets() const
+	{
+		return _operand.buckets();
+	}
+};
+
+//Maps an operator argument to its node type. Containers specialize this
+//to turn themselves into a BitTerminal.
+template<typename Type>
+struct BitOperand
+{
+	static constexpr bool value = std::is_base_of<BitExpression<Type>, Type>::value;
+	typedef Type Node;
+
+	__func__attr__
+	static const Type& make(const Type& operand)
+	{
+		return operand;
+	}
+};
+
+template<typename Left, typename Right>
+struct BitOperands
+{
+	static constexpr bool value = BitOperand<Left>::value
+			&& BitOperand<Right>::value;
+};
+
+template<typename Op, typename Left, typename Right>
+__func__attr__ inline BitBinary<Op, typename BitOperand<Left>::Node,
+		typename BitOperand<Right>::Node> make_bit_binary(const Left& left,
+		const Right& right)
+{
+	return BitBinary<Op, typename BitOperand<Left>::Node,
+			typename BitOperand<Right>::Node>(BitOperand<Left>::make(left),
+			BitOperand<Right>::make(right));
+}
+
+template<typename Left, typename Right>
+__func__attr__ inline typename std::enable_if<BitOperands<Left, Right>::value,
+		BitBinary<bit_op::And, typename BitOperand<Left>::Node,
+				typename BitOperand<Right>::Node> >::type operator&(
+		const Left& left, const Right& right)
+{
+	return make_bit_binary<bit_op::And>(left, right);
+}
+
+template<typename Left, typename Right>
+__func__attr__ inline typename std::enable_if<BitOperands<Left, Right>::value,
+		BitBinary<bit_op::Or, typename BitOperand<Left>::Node,
+				typename BitOperand<Right>::Node> >::type operator|(
+		const Left& left, const Right& right)
+{
+	return make_bit_binary<bit_op::Or>(left, right);
+}
+
+template<typename Left, typename Right>
+__func__attr__ inline typename std::enable_if<BitOperands<Left, Right>::value,
+		BitBinary<bit_op::Xor, typename BitOperand<Left>::Node,
+				typename BitOperand<Right>::Node> >::type operator^(
+		const Left& left, const Right& right)
+{
+	return make_bit_binary<bit_op::Xor>(left, right);
+}
+
+//left & ~right without the intermediate node
+template<typename Left, typename Right>
+__func__attr__ inline typename std::enable_if<BitOperands<Left, Right>::value,
+		BitBinary<bit_op::AndNot, typename BitOperand<Left>::Node,
+				typename BitOperand<Right>::Node> >::type andnot(
+		const Left& left, const Right& right)
+{
+	return make_bit_binary<bit_op::AndNot>(left, right);
+}
+
+template<typename Operand>
+__func__attr__ inline typename std::enable_if<BitOperand<Operand>::value,
+		BitInvert<typename BitOperand<Operand>::Node> >::type operator~(
+		const Operand& operand)
+{
+	return BitInvert<typename BitOperand<Operand>::Node>(
+			BitOperand<Operand>::make(operand));
+}
+
+//Writes the expression into buckets words of array in a single pass.
+//A compile-time buckets lets the loop vectorize.
+template<typename BaseInt, typename Derived>
+__func__attr__ inline void evaluate_bit_expression(BaseInt* array,
+		const BitExpression<Derived>& expression, std::size_t buckets)
+{
+	static_assert(std::is_same<BaseInt, typename Derived::Word>::value,
+			"Expression must share BaseInt.");
+	const Derived& source = expression.self();
+	for (std::size_t index = 0; index < buckets; ++index)
+		array[index] = source.word(index);
+}
+
+}
+
+#ifdef __func__attr__
+#undef __func__attr__
+#endif
+
+#endif /* INCLUDE_R_BIT_EXPRESSION_HPP_ */
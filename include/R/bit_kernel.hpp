@@ -0,0 +1,589 @@
+/*
+ * bit_kernel.hpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef INCLUDE_R_BIT_KERNEL_HPP_
+#define INCLUDE_R_BIT_KERNEL_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <atomic>
+
+//SIMD kernels are only built for x86 host code on GCC/Clang.
+//FUNC_ATTR builds (e.g. device code) and R_NO_SIMD fall back to scalar loops.
+#if !defined(FUNC_ATTR) && !defined(R_NO_SIMD) && defined(__GNUC__) \
+	&& (defined(__x86_64__) || defined(__i386__))
+#define R_BIT_KERNEL_X86 1
+#include <immintrin.h>
+#define R_BIT_KERNEL_TARGET(isa) __attribute__((target(isa)))
+//Intrinsics in target("avx2") functions without -mavx2 need GCC 4.9 or
+//Clang 3.8; older <immintrin.h> only declares them under __AVX2__.
+//Those compilers get the SSE2 kernels in the AVX2 and AVX512 slots and
+//never select either.
+#if defined(__clang__) ? (__clang_major__ > 3 \
+	|| (__clang_major__ == 3 && __clang_minor__ >= 8)) \
+	: (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#define R_BIT_KERNEL_AVX2 1
+#endif
+//AVX-512F intrinsics came with GCC 4.9 and Clang 3.9; older compilers
+//get the AVX2 kernels in the AVX512 slot and never select it
+#if defined(__clang__) ? (__clang_major__ > 3 \
+	|| (__clang_major__ == 3 && __clang_minor__ >= 9)) \
+	: (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#define R_BIT_KERNEL_AVX512 1
+#endif
+#endif
+
+namespace R
+{
+
+namespace bit_kernel
+{
+
+typedef std::size_t Size;
+
+enum class Backend
+{
+	SCALAR = 0, SSE2, AVX2, AVX512, COUNT
+};
+
+struct Table
+{
+	Backend backend;
+	const char* name;
+	void (*merge)(void* dst, const void* src, Size bytes);
+	void (*intersect)(void* dst, const void* src, Size bytes);
+	bool (*is_collide)(const void* a, const void* b, Size bytes);
+	bool (*equal)(const void* a, const void* b, Size bytes);
+	//acc |= src & pattern, where pattern is 64 bytes repeating every 8 bytes
+	void (*and_or)(void* acc, const void* src, const void* pattern, Size bytes);
+	//dst &= ~src
+	void (*andnot)(void* dst, const void* src, Size bytes);
+};
+
+namespace scalar
+{
+
+//Processes 8 bytes at a time, then the remaining bytes one by one.
+inline void merge(void* dst, const void* src, Size bytes)
+{
+	unsigned char* d = (unsigned char*) dst;
+	const unsigned char* s = (const unsigned char*) src;
+	Size index = 0;
+	for (; index + sizeof(uint64_t) <= bytes; index += sizeof(uint64_t))
+	{
+		uint64_t x, y;
+		std::memcpy(&x, d + index, sizeof(x));
+		std::memcpy(&y, s + index, sizeof(y));
+		x |= y;
+		std::memcpy(d + index, &x, sizeof(x));
+	}
+	for (; index < bytes; ++index)
+		d[index] |= s[index];
+}
+
+inline void intersect(void* dst, const void* src, Size bytes)
+{
+	unsigned char* d = (unsigned char*) dst;
+	const unsigned char* s = (const unsigned char*) src;
+	Size index = 0;
+	for (; index + sizeof(uint64_t) <= bytes; index += sizeof(uint64_t))
+	{
+		uint64_t x, y;
+		std::memcpy(&x, d + index, sizeof(x));
+		std::memcpy(&y, s + index, sizeof(y));
+		x &= y;
+		std::memcpy(d + index, &x, sizeof(x));
+	}
+	for (; index < bytes; ++index)
+		d[index] &= s[index];
+}
+
+inline void andnot(void* dst, const void* src, Size bytes)
+{
+	unsigned char* d = (unsigned char*) dst;
+	const unsigned char* s = (const unsigned char*) src;
+	Size index = 0;
+	for (; index + sizeof(uint64_t) <= bytes; index += sizeof(uint64_t))
+	{
+		uint64_t x, y;
+		std::memcpy(&x, d + index, sizeof(x));
+		std::memcpy(&y, s + index, sizeof(y));
+		x &= ~y;
+		std::memcpy(d + index, &x, sizeof(x));
+	}
+	for (; index < bytes; ++index)
+		d[index] &= (unsigned char) ~s[index];
+}
+
+inline bool is_collide(const void* a, const void* b, Size bytes)
+{
+	const unsigned char* p = (const unsigned char*) a;
+	const unsigned char* q = (const unsigned char*) b;
+	Size index = 0;
+	for (; index + sizeof(uint64_t) <= bytes; index += sizeof(uint64_t))
+	{
+		uint64_t x, y;
+		std::memcpy(&x, p + index, sizeof(x));
+		std::memcpy(&y, q + index, sizeof(y));
+		if (x & y)
+			return true;
+	}
+	for (; index < bytes; ++index)
+		if (p[index] & q[index])
+			return true;
+	return false;
+}
+
+inline bool equal(const void* a, const void* b, Size bytes)
+{
+	return bytes == 0 || std::memcmp(a, b, bytes) == 0;
+}
+
+inline void and_or(void* acc, const void* src, const void* pattern, Size bytes)
+{
+	unsigned char* d = (unsigned char*) acc;
+	const unsigned char* s = (const unsigned char*) src;
+	const unsigned char* m = (const unsigned char*) pattern;
+	uint64_t mask;
+	std::memcpy(&mask, m, sizeof(mask));
+	Size index = 0;
+	for (; index + sizeof(uint64_t) <= bytes; index += sizeof(uint64_t))
+	{
+		uint64_t x, y;
+		std::memcpy(&x, d + index, sizeof(x));
+		std::memcpy(&y, s + index, sizeof(y));
+		x |= y & mask;
+		std::memcpy(d + index, &x, sizeof(x));
+	}
+	for (; index < bytes; ++index)
+		d[index] |= s[index] & m[index % sizeof(uint64_t)];
+}
+
+}
+
+#ifdef R_BIT_KERNEL_X86
+
+namespace sse2
+{
+
+R_BIT_KERNEL_TARGET("sse2")
+inline void merge(void* dst, const void* src, Size bytes)
+{
+	unsigned char* d = (unsigned char*) dst;
+	const unsigned char* s = (const unsigned char*) src;
+	Size index = 0;
+	for (; index + 16 <= bytes; index += 16)
+	{
+		__m128i x = _mm_loadu_si128((const __m128i *) (d + index));
+		__m128i y = _mm_loadu_si128((const __m128i *) (s + index));
+		_mm_storeu_si128((__m128i *) (d + index), _mm_or_si128(x, y));
+	}
+	scalar::merge(d + index, s + index, bytes - index);
+}
+
+R_BIT_KERNEL_TARGET("sse2")
+inline void intersect(void* dst, const void* src, Size bytes)
+{
+	unsigned char* d = (unsigned char*) dst;
+	const unsigned char* s = (const unsigned char*) src;
+	Size index = 0;
+	for (; index + 16 <= bytes; index += 16)
+	{
+		__m128i x = _mm_loadu_si128((const __m128i *) (d + index));
+		__m128i y = _mm_loadu_si128((const __m128i *) (s + index));
+		_mm_storeu_si128((__m128i *) (d + index), _mm_and_si128(x, y));
+	}
+	scalar::intersect(d + index, s + index, bytes - index);
+}
+
+R_BIT_KERNEL_TARGET("sse2")
+inline void andnot(void* dst, const void* src, Size bytes)
+{
+	unsigned char* d = (unsigned char*) dst;
+	const unsigned char* s = (const unsigned char*) src;
+	Size index = 0;
+	for (; index + 16 <= bytes; index += 16)
+	{
+		__m128i x = _mm_loadu_si128((const __m128i *) (d + index));
+		__m128i y = _mm_loadu_si128((const __m128i *) (s + index));
+		_mm_storeu_si128((__m128i *) (d + index), _mm_andnot_si128(y, x));
+	}
+	scalar::andnot(d + index, s + index, bytes - index);
+}
+
+R_BIT_KERNEL_TARGET("sse2")
+inline bool is_collide(const void* a, const void* b, Size bytes)
+{
+	const unsigned char* p = (const unsigned char*) a;
+	const unsigned char* q = (const unsigned char*) b;
+	const __m128i zero = _mm_setzero_si128();
+	Size index = 0;
+	for (; index + 16 <= bytes; index += 16)
+	{
+		__m128i x = _mm_loadu_si128((const __m128i *) (p + index));
+		__m128i y = _mm_loadu_si128((const __m128i *) (q + index));
+		__m128i both = _mm_cmpeq_epi8(_mm_and_si128(x, y), zero);
+		if (_mm_movemask_epi8(both) != 0xFFFF)
+			return true;
+	}
+	return scalar::is_collide(p + index, q + index, bytes - index);
+}
+
+R_BIT_KERNEL_TARGET("sse2")
+inline bool equal(const void* a, const void* b, Size bytes)
+{
+	const unsigned char* p = (const unsigned char*) a;
+	const unsigned char* q = (const unsigned char*) b;
+	Size index = 0;
+	for (; index + 16 <= bytes; index += 16)
+	{
+		__m128i x = _mm_loadu_si128((const __m128i *) (p + index));
+		__m128i y = _mm_loadu_si128((const __m128i *) (q + index));
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) != 0xFFFF)
+			return false;
+	}
+	return scalar::equal(p + index, q + index, bytes - index);
+}
+
+R_BIT_KERNEL_TARGET("sse2")
+inline void and_or(void* acc, const void* src, const void* pattern, Size bytes)
+{
+	unsigned char* d = (unsigned char*) acc;
+	const unsigned char* s = (const unsigned char*) src;
+	const __m128i mask = _mm_loadu_si128((const __m128i *) pattern);
+	Size index = 0;
+	for (; index + 16 <= bytes; index += 16)
+	{
+		__m128i x = _mm_loadu_si128((const __m128i *) (d + index));
+		__m128i y = _mm_loadu_si128((const __m128i *) (s + index));
+		_mm_storeu_si128((__m128i *) (d + index), _mm_or_si128(x, _mm_and_si128(y, mask)));
+	}
+	scalar::and_or(d + index, s + index, pattern, bytes - index);
+}
+
+}
+
+#ifdef R_BIT_KERNEL_AVX2
+namespace avx2
+{
+
+R_BIT_KERNEL_TARGET("avx2")
+inline void merge(void* dst, const void* src, Size bytes)
+{
+	unsigned char* d = (unsigned char*) dst;
+	const unsigned char* s = (const unsigned char*) src;
+	Size index = 0;
+	for (; index + 32 <= bytes; index += 32)
+	{
+		__m256i x = _mm256_loadu_si256((const __m256i *) (d + index));
+		__m256i y = _mm256_loadu_si256((const __m256i *) (s + index));
+		_mm256_storeu_si256((__m256i *) (d + index), _mm256_or_si256(x, y));
+	}
+	sse2::merge(d + index, s + index, bytes - index);
+}
+
+R_BIT_KERNEL_TARGET("avx2")
+inline void intersect(void* dst, const void* src, Size bytes)
+{
+	unsigned char* d = (unsigned char*) dst;
+	const unsigned char* s = (const unsigned char*) src;
+	Size index = 0;
+	for (; index + 32 <= bytes; index += 32)
+	{
+		__m256i x = _mm256_loadu_si256((const __m256i *) (d + index));
+		__m256i y = _mm256_loadu_si256((const __m256i *) (s + index));
+		_mm256_storeu_si256((__m256i *) (d + index), _mm256_and_si256(x, y));
+	}
+	sse2::intersect(d + index, s + index, bytes - index);
+}
+
+R_BIT_KERNEL_TARGET("avx2")
+inline void andnot(void* dst, const void* src, Size bytes)
+{
+	unsigned char* d = (unsigned char*) dst;
+	const unsigned char* s = (const unsigned char*) src;
+	Size index = 0;
+	for (; index + 32 <= bytes; index += 32)
+	{
+		__m256i x = _mm256_loadu_si256((const __m256i *) (d + index));
+		__m256i y = _mm256_loadu_si256((const __m256i *) (s + index));
+		_mm256_storeu_si256((__m256i *) (d + index), _mm256_andnot_si256(y, x));
+	}
+	sse2::andnot(d + index, s + index, bytes - index);
+}
+
+R_BIT_KERNEL_TARGET("avx2")
+inline bool is_collide(const void* a, const void* b, Size bytes)
+{
+	const unsigned char* p = (const unsigned char*) a;
+	const unsigned char* q = (const unsigned char*) b;
+	Size index = 0;
+	for (; index + 32 <= bytes; index += 32)
+	{
+		__m256i x = _mm256_loadu_si256((const __m256i *) (p + index));
+		__m256i y = _mm256_loadu_si256((const __m256i *) (q + index));
+		if (!_mm256_testz_si256(x, y))
+			return true;
+	}
+	return sse2::is_collide(p + index, q + index, bytes - index);
+}
+
+R_BIT_KERNEL_TARGET("avx2")
+inline bool equal(const void* a, const void* b, Size bytes)
+{
+	const unsigned char* p = (const unsigned char*) a;
+	const unsigned char* q = (const unsigned char*) b;
+	Size index = 0;
+	for (; index + 32 <= bytes; index += 32)
+	{
+		__m256i x = _mm256_loadu_si256((const __m256i *) (p + index));
+		__m256i y = _mm256_loadu_si256((const __m256i *) (q + index));
+		__m256i diff = _mm256_xor_si256(x, y);
+		if (!_mm256_testz_si256(diff, diff))
+			return false;
+	}
+	return sse2::equal(p + index, q + index, bytes - index);
+}
+
+R_BIT_KERNEL_TARGET("avx2")
+inline void and_or(void* acc, const void* src, const void* pattern, Size bytes)
+{
+	unsigned char* d = (unsigned char*) acc;
+	const unsigned char* s = (const unsigned char*) src;
+	const __m256i mask = _mm256_loadu_si256((const __m256i *) pattern);
+	Size index = 0;
+	for (; index + 32 <= bytes; index += 32)
+	{
+		__m256i x = _mm256_loadu_si256((const __m256i *) (d + index));
+		__m256i y = _mm256_loadu_si256((const __m256i *) (s + index));
+		_mm256_storeu_si256((__m256i *) (d + index), _mm256_or_si256(x, _mm256_and_si256(y, mask)));
+	}
+	sse2::and_or(d + index, s + index, pattern, bytes - index);
+}
+
+}
+
+#ifdef R_BIT_KERNEL_AVX512
+namespace avx512
+{
+
+R_BIT_KERNEL_TARGET("avx512f")
+inline void merge(void* dst, const void* src, Size bytes)
+{
+	unsigned char* d = (unsigned char*) dst;
+	const unsigned char* s = (const unsigned char*) src;
+	Size index = 0;
+	for (; index + 64 <= bytes; index += 64)
+	{
+		__m512i x = _mm512_loadu_si512((const void *) (d + index));
+		__m512i y = _mm512_loadu_si512((const void *) (s + index));
+		_mm512_storeu_si512((void *) (d + index), _mm512_or_si512(x, y));
+	}
+	avx2::merge(d + index, s + index, bytes - index);
+}
+
+R_BIT_KERNEL_TARGET("avx512f")
+inline void intersect(void* dst, const void* src, Size bytes)
+{
+	unsigned char* d = (unsigned char*) dst;
+	const unsigned char* s = (const unsigned char*) src;
+	Size index = 0;
+	for (; index + 64 <= bytes; index += 64)
+	{
+		__m512i x = _mm512_loadu_si512((const void *) (d + index));
+		__m512i y = _mm512_loadu_si512((const void *) (s + index));
+		_mm512_storeu_si512((void *) (d + index), _mm512_and_si512(x, y));
+	}
+	avx2::intersect(d + index, s + index, bytes - index);
+}
+
+R_BIT_KERNEL_TARGET("avx512f")
+inline void andnot(void* dst, const void* src, Size bytes)
+{
+	unsigned char* d = (unsigned char*) dst;
+	const unsigned char* s = (const unsigned char*) src;
+	const __m512i ones = _mm512_set1_epi64(-1);
+	Size index = 0;
+	for (; index + 64 <= bytes; index += 64)
+	{
+		__m512i x = _mm512_loadu_si512((const void *) (d + index));
+		__m512i y = _mm512_loadu_si512((const void *) (s + index));
+		//_mm512_andnot_si512 trips -Wmaybe-uninitialized in GCC 12
+		_mm512_storeu_si512((void *) (d + index),
+				_mm512_and_si512(x, _mm512_xor_si512(y, ones)));
+	}
+	avx2::andnot(d + index, s + index, bytes - index);
+}
+
+R_BIT_KERNEL_TARGET("avx512f")
+inline bool is_collide(const void* a, const void* b, Size bytes)
+{
+	const unsigned char* p = (const unsigned char*) a;
+	const unsigned char* q = (const unsigned char*) b;
+	Size index = 0;
+	for (; index + 64 <= bytes; index += 64)
+	{
+		__m512i x = _mm512_loadu_si512((const void *) (p + index));
+		__m512i y = _mm512_loadu_si512((const void *) (q + index));
+		if (_mm512_test_epi64_mask(x, y))
+			return true;
+	}
+	return avx2::is_collide(p + index, q + index, bytes - index);
+}
+
+R_BIT_KERNEL_TARGET("avx512f")
+inline bool equal(const void* a, const void* b, Size bytes)
+{
+	const unsigned char* p = (const unsigned char*) a;
+	const unsigned char* q = (const unsigned char*) b;
+	Size index = 0;
+	for (; index + 64 <= bytes; index += 64)
+	{
+		__m512i x = _mm512_loadu_si512((const void *) (p + index));
+		__m512i y = _mm512_loadu_si512((const void *) (q + index));
+		if (_mm512_cmpneq_epi64_mask(x, y))
+			return false;
+	}
+	return avx2::equal(p + index, q + index, bytes - index);
+}
+
+R_BIT_KERNEL_TARGET("avx512f")
+inline void and_or(void* acc, const void* src, const void* pattern, Size bytes)
+{
+	unsigned char* d = (unsigned char*) acc;
+	const unsigned char* s = (const unsigned char*) src;
+	const __m512i mask = _mm512_loadu_si512(pattern);
+	Size index = 0;
+	for (; index + 64 <= bytes; index += 64)
+	{
+		__m512i x = _mm512_loadu_si512((const void *) (d + index));
+		__m512i y = _mm512_loadu_si512((const void *) (s + index));
+		_mm512_storeu_si512((void *) (d + index), _mm512_or_si512(x, _mm512_and_si512(y, mask)));
+	}
+	avx2::and_or(d + index, s + index, pattern, bytes - index);
+}
+
+}
+#endif /* R_BIT_KERNEL_AVX512 */
+#endif /* R_BIT_KERNEL_AVX2 */
+
+#endif /* R_BIT_KERNEL_X86 */
+
+inline const Table& table(Backend backend)
+{
+	static const Table tables[] =
+	{
+	{ Backend::SCALAR, "scalar", scalar::merge, scalar::intersect,
+			scalar::is_collide, scalar::equal, scalar::and_or, scalar::andnot },
+#ifdef R_BIT_KERNEL_X86
+	{ Backend::SSE2, "sse2", sse2::merge, sse2::intersect, sse2::is_collide,
+			sse2::equal, sse2::and_or, sse2::andnot },
+#ifdef R_BIT_KERNEL_AVX2
+	{ Backend::AVX2, "avx2", avx2::merge, avx2::intersect, avx2::is_collide,
+			avx2::equal, avx2::and_or, avx2::andnot },
+#ifdef R_BIT_KERNEL_AVX512
+	{ Backend::AVX512, "avx512", avx512::merge, avx512::intersect,
+			avx512::is_collide, avx512::equal, avx512::and_or, avx512::andnot },
+#else
+	{ Backend::AVX2, "avx2", avx2::merge, avx2::intersect, avx2::is_collide,
+			avx2::equal, avx2::and_or, avx2::andnot },
+#endif
+#else
+	{ Backend::SSE2, "sse2", sse2::merge, sse2::intersect, sse2::is_collide,
+			sse2::equal, sse2::and_or, sse2::andnot },
+	{ Backend::SSE2, "sse2", sse2::merge, sse2::intersect, sse2::is_collide,
+			sse2::equal, sse2::and_or, sse2::andnot },
+#endif
+#else
+	//no SIMD kernels: every backend slot runs the scalar loops
+	{ Backend::SCALAR, "scalar", scalar::merge, scalar::intersect,
+			scalar::is_collide, scalar::equal, scalar::and_or, scalar::andnot },
+	{ Backend::SCALAR, "scalar", scalar::merge, scalar::intersect,
+			scalar::is_collide, scalar::equal, scalar::and_or, scalar::andnot },
+	{ Backend::SCALAR, "scalar", scalar::merge, scalar::intersect,
+			scalar::is_collide, scalar::equal, scalar::and_or, scalar::andnot },
+#endif
+	};
+	static_assert(sizeof(tables) / sizeof(tables[0]) == (Size) Backend::COUNT,
+			"One table per backend required.");
+	return tables[(Size) backend];
+}
+
+inline bool is_supported(Backend backend)
+{
+	switch (backend)
+	{
+	case Backend::SCALAR:
+		return true;
+#ifdef R_BIT_KERNEL_X86
+	case Backend::SSE2:
+		return __builtin_cpu_supports("sse2");
+#ifdef R_BIT_KERNEL_AVX2
+	case Backend::AVX2:
+		return __builtin_cpu_supports("avx2");
+#ifdef R_BIT_KERNEL_AVX512
+	case Backend::AVX512:
+		return __builtin_cpu_supports("avx512f");
+#endif
+#endif
+#endif
+	default:
+		return false;
+	}
+}
+
+inline Backend best_backend()
+{
+	for (Size index = (Size) Backend::COUNT; index-- > 0;)
+		if (is_supported((Backend) index))
+			return (Backend) index;
+	return Backend::SCALAR;
+}
+
+inline std::atomic<const Table*>& active_table_slot()
+{
+	static std::atomic<const Table*> active(&table(best_backend()));
+	return active;
+}
+
+//The dispatch table used by BitArray; chosen once by CPU feature detection.
+inline const Table& active()
+{
+	return *active_table_slot().load(std::memory_order_relaxed);
+}
+
+//Overrides runtime detection (tests and benchmarks). Fails if unsupported.
+inline bool set_backend(Backend backend)
+{
+	if (!is_supported(backend))
+		return false;
+	active_table_slot().store(&table(backend), std::memory_order_relaxed);
+	return true;
+}
+
+inline Backend current_backend()
+{
+	return active().backend;
+}
+
+#ifdef R_BIT_KERNEL_AVX2
+//whether callers with their own target("avx2") code should take it
+inline bool use_avx2()
+{
+	return current_backend() >= Backend::AVX2;
+}
+#endif
+
+}
+
+}
+
+#ifdef R_BIT_KERNEL_TARGET
+#undef R_BIT_KERNEL_TARGET
+#endif
+
+#endif /* INCLUDE_R_BIT_KERNEL_HPP_ */
@@ -0,0 +1,249 @@
+/*
+ * bit_matrix.hpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef INCLUDE_R_BIT_MATRIX_HPP_
+#define INCLUDE_R_BIT_MATRIX_HPP_
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+#include <R/bit_algorithm.hpp>
+#include <R/bit_array_view.hpp>
+#include <R/bit_vector.hpp>
+#include <R/memory_allocator.hpp>
+
+namespace R
+{
+
+namespace bit_matrix
+{
+
+typedef std::size_t Size;
+typedef uint64_t Word;
+
+//One round of the recursive block transpose: swaps the off-diagonal
+//Half x Half sub-blocks of every 2Half x 2Half block. The inner loop
+//has a constant trip count and is vectorized for Half >= 2.
+template<Size Half>
+inline void transpose_round(Word block[64], Word mask)
+{
+	for (Size base = 0; base < 64; base += 2 * Half)
+		for (Size index = 0; index < Half; ++index)
+		{
+			Word& upper = block[base + index];
+			Word& lower = block[base + index + Half];
+			Word swap = (upper ^ (lower >> Half)) & mask;
+			upper ^= swap;
+			lower ^= swap << Half;
+		}
+}
+
+//In-place transpose of a 64 x 64 block in get_bit order: bit c of word r
+//(counted from the top) moves to bit r of word c.
+inline void transpose64(Word block[64])
+{
+	transpose_round<32>(block, 0x00000000FFFFFFFFULL);
+	transpose_round<16>(block, 0x0000FFFF0000FFFFULL);
+	transpose_round<8>(block, 0x00FF00FF00FF00FFULL);
+	transpose_round<4>(block, 0x0F0F0F0F0F0F0F0FULL);
+	transpose_round<2>(block, 0x3333333333333333ULL);
+	transpose_round<1>(block, 0x5555555555555555ULL);
+}
+
+}
+
+//Rows x Cols bit matrix. Each row starts on a cache line and is padded
+//to whole lines with clear bits; rows are exposed as BitArrayViews.
+template<std::size_t Rows, std::size_t Cols>
+class BitMatrix
+{
+public:
+	typedef std::size_t Size;
+	typedef uint64_t Word;
+	typedef BitArrayView<Word> Row;
+	typedef BitArrayView<const Word> ConstRow;
+private:
+	typedef BitAlgorithm<Word> Algorithm;
+
+	template<std::size_t OtherRows, std::size_t OtherCols>
+	friend class BitMatrix;
+
+	//words per row, rounded up to a cache line
+	constexpr static Size STRIDE()
+	{
+		return (Cols + 511) / 512 * (CACHE_LINE_SIZE / sizeof(Word));
+	}
+
+	BitVector<Word> _bits;
+
+	Word* row_data(Size row)
+	{
+		return _bits.data() + row * STRIDE();
+	}
+
+	const Word* row_data(Size row) const
+	{
+		return _bits.data() + row * STRIDE();
+	}
+
+	//Loads the 64 x 64 block at (row_block, word), rows past Rows read as
+	//zero, and transposes it.
+	void load_transposed(Size row_block, Size word, Word block[64]) const
+	{
+		Size first = row_block * 64;
+		for (Size index = 0; index < 64; ++index)
+			block[index] = (first + index < Rows) ?
+					row_data(first + index)[word] : 0;
+		bit_matrix::transpose64(block);
+	}
+
+	static BitVector<Word> complement(const BitVector<Word>& used)
+	{
+		BitVector<Word> result(Cols, true, used.allocator());
+		for (Size index = 0; index < used.buckets(); ++index)
+			result.data()[index] &= ~used.data()[index];
+		return result;
+	}
+
+public:
+	explicit BitMatrix(Allocator& allocator = default_allocator()) :
+			_bits(Rows * STRIDE() * Algorithm::BIT_COUNT(), false, allocator)
+	{
+	}
+
+	constexpr static Size rows()
+	{
+		return Rows;
+	}
+
+	constexpr static Size cols()
+	{
+		return Cols;
+	}
+
+	bool get_bit(Size row, Size col) const
+	{
+		return Algorithm::get_bit(row_data(row), col);
+	}
+
+	void set_bit(Size row, Size col)
+	{
+		Algorithm::set_bit(row_data(row), col);
+	}
+
+	void clear_bit(Size row, Size col)
+	{
+		Algorithm::clear_bit(row_data(row), col);
+	}
+
+	Row row(Size index)
+	{
+		return Row(row_data(index), Cols);
+	}
+
+	ConstRow row(Size index) const
+	{
+		return ConstRow(row_data(index), Cols);
+	}
+
+	void clear()
+	{
+		_bits.clear();
+	}
+
+	Size count() const
+	{
+		return _bits.count();
+	}
+
+	Size row_count(Size row) const
+	{
+		return Algorithm::count(row_data(row), STRIDE());
+	}
+
+	Size column_count(Size col) const
+	{
+		Size total = 0;
+		for (Size row = 0; row < Rows; ++row)
+			total += get_bit(row, col);
+		return total;
+	}
+
+	//popcount of every column, 64 x 64 blocks at a time
+	std::vector<Size> column_counts() const
+	{
+		std::vector<Size> counts(Cols, 0);
+		Word block[64];
+		for (Size word = 0; word < Algorithm::buckets_for(Cols); ++word)
+			for (Size row_block = 0; row_block < (Rows + 63) / 64; ++row_block)
+			{
+				load_transposed(row_block, word, block);
+				Size last = std::min<Size>(64, Cols - word * 64);
+				for (Size index = 0; index < last; ++index)
+					counts[word * 64 + index] += bit_word::popcount(block[index]);
+			}
+		return counts;
+	}
+
+	BitMatrix<Cols, Rows> transpose() const
+	{
+		BitMatrix<Cols, Rows> result(_bits.allocator());
+		Word block[64];
+		for (Size word = 0; word < Algorithm::buckets_for(Cols); ++word)
+			for (Size row_block = 0; row_block < (Rows + 63) / 64; ++row_block)
+			{
+				load_transposed(row_block, word, block);
+				Size last = std::min<Size>(64, Cols - word * 64);
+				for (Size index = 0; index < last; ++index)
+					result.row_data(word * 64 + index)[row_block] = block[index];
+			}
+		return result;
+	}
+
+	//calls fn(row) for every row sharing a bit with the Cols-bit mask
+	template<typename Function>
+	void for_each_colliding_row(const ConstRow& mask, Function && fn) const
+	{
+		for (Size index = 0; index < Rows; ++index)
+			if (row(index).is_collide(mask))
+				fn(index);
+	}
+
+	std::vector<Size> colliding_rows(const ConstRow& mask) const
+	{
+		std::vector<Size> found;
+		for_each_colliding_row(mask, [&found](Size index)
+		{
+			found.push_back(index);
+		});
+		return found;
+	}
+
+	//columns clear in every row
+	BitVector<Word> free_columns() const
+	{
+		BitVector<Word> used(Cols, false, _bits.allocator());
+		for (Size index = 0; index < Rows; ++index)
+			Algorithm::merge(used.data(), row_data(index), used.buckets());
+		return complement(used);
+	}
+
+	//columns clear in every row selected by the Rows-bit mask
+	BitVector<Word> free_columns(const BitArrayView<const Word>& selected) const
+	{
+		BitVector<Word> used(Cols, false, _bits.allocator());
+		selected.for_each_set_bit([this, &used](Size index)
+		{
+			Algorithm::merge(used.data(), row_data(index), used.buckets());
+		});
+		return complement(used);
+	}
+};
+
+}
+
+#endif /* INCLUDE_R_BIT_MATRIX_HPP_ */
@@ -0,0 +1,206 @@
+/*
+ * bit_parallel.hpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef INCLUDE_R_BIT_PARALLEL_HPP_
+#define INCLUDE_R_BIT_PARALLEL_HPP_
+
+#include <cstring>
+#include <cassert>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <R/bit_algorithm.hpp>
+#include <R/bit_array.hpp>
+#include <R/bit_vector.hpp>
+#include <R/thread_pool.hpp>
+
+namespace R
+{
+
+//Bulk BitArray / BitVector operations split across a ThreadPool.
+//
+//The buckets are cut into CHUNK_BYTES() chunks and every thread of the
+//pool takes a contiguous run of chunks, processing one chunk at a time
+//with the SIMD kernels. The split depends only on the size and the pool,
+//so in a BitVector from make_vector(), whose pages are first written
+//through the pool, each chunk is later read by the thread that placed its
+//pages. That holds across calls when the pool pins its threads, as
+//default_pool() does. Operations below the serial cutoff stay on the
+//calling thread.
+namespace bit_parallel
+{
+
+typedef std::size_t Size;
+
+//page multiple sized for L2
+constexpr Size CHUNK_BYTES()
+{
+	return ((Size) 1) << 18;
+}
+
+constexpr Size SERIAL_BYTES()
+{
+	return ((Size) 1) << 22;
+}
+
+//the pool shared by callers that do not bring their own
+inline ThreadPool& default_pool()
+{
+	static ThreadPool pool(ThreadPool::default_threads(), true);
+	return pool;
+}
+
+template<typename Bits>
+struct WordOf
+{
+	typedef typename std::remove_const<
+			typename std::remove_pointer<
+					decltype(std::declval<Bits&>().data())>::type>::type Type;
+};
+
+template<typename BaseInt>
+inline Size bit_size(const BitVector<BaseInt>& bits)
+{
+	return bits.size();
+}
+
+template<typename BaseInt, std::size_t TotalBits>
+inline Size bit_size(const BitArray<BaseInt, TotalBits>&)
+{
+	return TotalBits;
+}
+
+//Calls fn(thread, begin, end) for bucket ranges of at most one chunk.
+//Every thread index sees its own ranges in ascending order.
+template<typename BaseInt, typename Function>
+inline void for_each_chunk(ThreadPool& pool, Size buckets, Size serial_bytes,
+		Function && fn)
+{
+	Size bytes = buckets * sizeof(BaseInt);
+	if (bytes == 0)
+		return;
+	if (bytes < serial_bytes || pool.size() == 1)
+	{
+		fn((Size) 0, (Size) 0, buckets);
+		return;
+	}
+	const Size words = CHUNK_BYTES() / sizeof(BaseInt);
+	Size chunks = (buckets + words - 1) / words;
+	Size threads = pool.size();
+	pool.run([&](Size thread)
+	{
+		Size first = chunks * thread / threads;
+		Size last = chunks * (thread + 1) / threads;
+		for (Size chunk = first; chunk < last; ++chunk)
+			fn(thread, chunk * words, std::min(buckets, (chunk + 1) * words));
+	});
+}
+
+template<typename Bits>
+inline void merge(ThreadPool& pool, Bits& array, const Bits& other,
+		Size serial_bytes = SERIAL_BYTES())
+{
+	typedef typename WordOf<Bits>::Type BaseInt;
+	assert(bit_size(array) == bit_size(other));
+	BaseInt* dst = array.data();
+	const BaseInt* src = other.data();
+	for_each_chunk<BaseInt>(pool, array.buckets(), serial_bytes,
+			[dst, src](Size, Size begin, Size end)
+			{
+				BitAlgorithm<BaseInt>::merge(dst + begin, src + begin, end - begin);
+			});
+}
+
+template<typename Bits>
+inline void intersect(ThreadPool& pool, Bits& array, const Bits& other,
+		Size serial_bytes = SERIAL_BYTES())
+{
+	typedef typename WordOf<Bits>::Type BaseInt;
+	assert(bit_size(array) == bit_size(other));
+	BaseInt* dst = array.data();
+	const BaseInt* src = other.data();
+	for_each_chunk<BaseInt>(pool, array.buckets(), serial_bytes,
+			[dst, src](Size, Size begin, Size end)
+			{
+				BitAlgorithm<BaseInt>::intersect(dst + begin, src + begin,
+						end - begin);
+			});
+}
+
+template<typename Bits>
+inline Size count(ThreadPool& pool, const Bits& array,
+		Size serial_bytes = SERIAL_BYTES())
+{
+	typedef typename WordOf<Bits>::Type BaseInt;
+	const BaseInt* src = array.data();
+	//one cache line per thread keeps the partial sums from false sharing
+	Size stride = CACHE_LINE_SIZE / sizeof(Size);
+	std::vector<Size> partial(pool.size() * stride, 0);
+	for_each_chunk<BaseInt>(pool, array.buckets(), serial_bytes,
+			[src, &partial, stride](Size thread, Size begin, Size end)
+			{
+				partial[thread * stride] += BitAlgorithm<BaseInt>::count(
+						src + begin, end - begin);
+			});
+	Size total = 0;
+	for (Size thread = 0; thread < pool.size(); ++thread)
+		total += partial[thread * stride];
+	return total;
+}
+
+//sets every bit; the padding of a BitVector stays clear
+template<typename Bits>
+inline void fill(ThreadPool& pool, Bits& array,
+		Size serial_bytes = SERIAL_BYTES())
+{
+	typedef typename WordOf<Bits>::Type BaseInt;
+	typedef BitAlgorithm<BaseInt> Algorithm;
+	BaseInt* dst = array.data();
+	for_each_chunk<BaseInt>(pool, array.buckets(), serial_bytes,
+			[dst](Size, Size begin, Size end)
+			{
+				std::memset(dst + begin, 0xFF, (end - begin) * sizeof(BaseInt));
+			});
+	Size sub = Algorithm::sub_index(bit_size(array));
+	if (sub > 0)
+		dst[array.buckets() - 1] &= Algorithm::fill_left(sub);
+}
+
+template<typename Bits>
+inline void clear(ThreadPool& pool, Bits& array,
+		Size serial_bytes = SERIAL_BYTES())
+{
+	typedef typename WordOf<Bits>::Type BaseInt;
+	BaseInt* dst = array.data();
+	for_each_chunk<BaseInt>(pool, array.buckets(), serial_bytes,
+			[dst](Size, Size begin, Size end)
+			{
+				std::memset(dst + begin, 0, (end - begin) * sizeof(BaseInt));
+			});
+}
+
+//A BitVector of bits set to initial whose pages are first written, and so
+//placed, by the pool threads that later process them.
+template<typename BaseInt>
+inline BitVector<BaseInt> make_vector(ThreadPool& pool, Size bits,
+		bool initial = false, Allocator& allocator = default_allocator())
+{
+	BitVector<BaseInt> vector(bits,
+			typename BitVector<BaseInt>::Unwritten(), allocator);
+	if (initial)
+		fill(pool, vector, 0);
+	else
+		clear(pool, vector, 0);
+	return vector;
+}
+
+}
+
+}
+
+#endif /* INCLUDE_R_BIT_PARALLEL_HPP_ */
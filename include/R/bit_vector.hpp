@@ -0,0 +1,379 @@
+/*
+ * bit_vector.hpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef INCLUDE_R_BIT_VECTOR_HPP_
+#define INCLUDE_R_BIT_VECTOR_HPP_
+
+#include <type_traits>
+#include <algorithm>
+#include <ostream>
+#include <utility>
+#include <cstring>
+#include <cassert>
+#include <new>
+
+#include <R/bit_algorithm.hpp>
+#include <R/memory_allocator.hpp>
+
+namespace R
+{
+
+//Runtime-sized counterpart of BitArray with the same bit order and
+//operations. Storage is cache-line aligned and comes from an R::Allocator.
+//Bits past size() in the last bucket are always kept clear.
+template<typename BaseInt>
+class BitVector
+{
+	static_assert(std::is_integral<BaseInt>::value, "Integer type required.");
+	static_assert(std::is_unsigned<BaseInt>::value, "Unsigned type required.");
+public:
+	typedef std::size_t Size;
+private:
+	typedef BitVector<BaseInt> SelfType;
+	typedef BitAlgorithm<BaseInt> Algorithm;
+
+	Allocator* _allocator;
+	Allocator::Aux _aux;
+	BaseInt* _array;
+	Size _bits;
+	Size _capacity; //in buckets
+
+	constexpr static Size BIT_COUNT()
+	{
+		return Algorithm::BIT_COUNT();
+	}
+
+	//rounds the allocation up to whole cache lines
+	constexpr static Size capacity_for(Size buckets)
+	{
+		return ((buckets * sizeof(BaseInt) + CACHE_LINE_SIZE - 1)
+				/ CACHE_LINE_SIZE) * CACHE_LINE_SIZE / sizeof(BaseInt);
+	}
+
+	//With touch false only the slack past buckets is cleared; the rest is
+	//left unwritten (and, for fresh pages, unplaced) for the caller.
+	void reallocate(Size buckets, bool touch = true)
+	{
+		Size capacity = capacity_for(buckets);
+		Allocator::Ptr addr = Allocator::NullPtr;
+		Allocator::Aux aux = Allocator::NullPtr;
+		if (capacity > 0)
+		{
+			aux = allocate_aligned(*_allocator, capacity * sizeof(BaseInt),
+					CACHE_LINE_SIZE, addr);
+			if (addr == Allocator::NullPtr)
+				throw std::bad_alloc();
+		}
+		BaseInt* array = (BaseInt*) addr;
+		Size keep = std::min(this->buckets(), capacity);
+		if (keep > 0)
+			std::memcpy(array, _array, keep * sizeof(BaseInt));
+		Size from = touch ? keep : std::max(keep, std::min(buckets, capacity));
+		if (capacity > from)
+			std::memset(array + from, 0, (capacity - from) * sizeof(BaseInt));
+		release();
+		_aux = aux;
+		_array = array;
+		_capacity = capacity;
+	}
+
+	void release()
+	{
+		if (_array != nullptr)
+			_allocator->deallocate(_aux);
+		_aux = Allocator::NullPtr;
+		_array = nullptr;
+		_capacity = 0;
+	}
+
+	//re-establishes the clear-padding invariant
+	void clear_padding()
+	{
+		Size sub = Algorithm::sub_index(_bits);
+		if (sub > 0)
+			_array[buckets() - 1] &= Algorithm::fill_left(sub);
+	}
+
+public:
+	//tag for the constructor that leaves the storage unwritten
+	struct Unwritten
+	{
+	};
+
+	explicit BitVector(Size bits = 0, bool initial = false,
+			Allocator& allocator = default_allocator()) :
+			_allocator(&allocator), _aux(Allocator::NullPtr), _array(nullptr),
+					_bits(0), _capacity(0)
+	{
+		resize(bits, initial);
+	}
+
+	//Allocates bits without writing them, so each page is placed by the
+	//thread that first writes it (see bit_parallel::make_vector). Every
+	//bucket must be written, e.g. by bit_parallel::clear, before use.
+	BitVector(Size bits, Unwritten, Allocator& allocator = default_allocator()) :
+			_allocator(&allocator), _aux(Allocator::NullPtr), _array(nullptr),
+					_bits(0), _capacity(0)
+	{
+		reallocate(Algorithm::buckets_for(bits), false);
+		_bits = bits;
+	}
+
+	BitVector(const SelfType& source) :
+			_allocator(source._allocator), _aux(Allocator::NullPtr),
+					_array(nullptr), _bits(0), _capacity(0)
+	{
+		reallocate(source.buckets());
+		_bits = source._bits;
+		if (buckets() > 0)
+			std::memcpy(_array, source._array, buckets() * sizeof(BaseInt));
+	}
+
+	//takes over the storage; source becomes empty
+	BitVector(SelfType&& source) noexcept :
+			_allocator(source._allocator), _aux(source._aux),
+					_array(source._array), _bits(source._bits),
+					_capacity(source._capacity)
+	{
+		source._aux = Allocator::NullPtr;
+		source._array = nullptr;
+		source._bits = 0;
+		source._capacity = 0;
+	}
+
+	~BitVector()
+	{
+		release();
+	}
+
+	SelfType& operator=(const SelfType& source)
+	{
+		if (this == &source)
+			return *this;
+		if (_capacity < source.buckets())
+			reallocate(source.buckets());
+		else if (_capacity > 0)
+			std::memset(_array, 0, _capacity * sizeof(BaseInt));
+		_bits = source._bits;
+		if (buckets() > 0)
+			std::memcpy(_array, source._array, buckets() * sizeof(BaseInt));
+		return *this;
+	}
+
+	SelfType& operator=(SelfType&& source) noexcept
+	{
+		if (this == &source)
+			return *this;
+		release();
+		std::swap(_allocator, source._allocator);
+		std::swap(_aux, source._aux);
+		std::swap(_array, source._array);
+		std::swap(_bits, source._bits);
+		std::swap(_capacity, source._capacity);
+		return *this;
+	}
+
+	Size size() const
+	{
+		return _bits;
+	}
+
+	Size buckets() const
+	{
+		return Algorithm::buckets_for(_bits);
+	}
+
+	//capacity in bits
+	Size capacity() const
+	{
+		return _capacity * BIT_COUNT();
+	}
+
+	BaseInt* data()
+	{
+		return _array;
+	}
+
+	const BaseInt* data() const
+	{
+		return _array;
+	}
+
+	Allocator& allocator() const
+	{
+		return *_allocator;
+	}
+
+	void reserve(Size bits)
+	{
+		if (Algorithm::buckets_for(bits) > _capacity)
+			reallocate(Algorithm::buckets_for(bits));
+	}
+
+	//Changes the size; new bits take the given value. Storage grows
+	//geometrically and is only reallocated when the capacity is exceeded.
+	void resize(Size bits, bool value = false)
+	{
+		Size old_bits = _bits;
+		Size needed = Algorithm::buckets_for(bits);
+		if (needed > _capacity)
+			reallocate(std::max(needed, _capacity * 2));
+
+		if (bits < old_bits)
+		{
+			_bits = bits;
+			Size from = buckets();
+			Size to = Algorithm::buckets_for(old_bits);
+			if (to > from)
+				std::memset(_array + from, 0, (to - from) * sizeof(BaseInt));
+			if (_bits > 0)
+				clear_padding();
+			return;
+		}
+		_bits = bits;
+		if (value && bits > old_bits)
+			Algorithm::set_range(_array, old_bits, bits - old_bits);
+	}
+
+	//returns unused capacity to the allocator
+	void shrink_to_fit()
+	{
+		if (capacity_for(buckets()) < _capacity)
+			reallocate(buckets());
+	}
+
+	bool is_collide(const SelfType& other) const
+	{
+		assert(_bits == other._bits);
+		return Algorithm::is_collide(_array, other._array, buckets());
+	}
+
+	void merge(const SelfType& other)
+	{
+		assert(_bits == other._bits);
+		Algorithm::merge(_array, other._array, buckets());
+	}
+
+	void intersect(const SelfType& other)
+	{
+		assert(_bits == other._bits);
+		Algorithm::intersect(_array, other._array, buckets());
+	}
+
+	bool get_bit(Size index) const
+	{
+		return Algorithm::get_bit(_array, index);
+	}
+
+	void set_bit(Size index)
+	{
+		Algorithm::set_bit(_array, index);
+	}
+
+	void clear_bit(Size index)
+	{
+		Algorithm::clear_bit(_array, index);
+	}
+
+	void set_range(Size start, Size length)
+	{
+		Algorithm::set_range(_array, start, length);
+	}
+
+	void clear_range(Size start, Size length)
+	{
+		Algorithm::clear_range(_array, start, length);
+	}
+
+	Size count() const
+	{
+		return Algorithm::count(_array, buckets());
+	}
+
+	//Find functions follow the get_bit order and return size() if not found.
+	Size find_first_set() const
+	{
+		return std::min(_bits,
+				Algorithm::template find_from<true>(_array, buckets(), 0));
+	}
+
+	Size find_next_set(Size pos) const
+	{
+		return std::min(_bits,
+				Algorithm::template find_from<true>(_array, buckets(), pos + 1));
+	}
+
+	Size find_first_zero() const
+	{
+		return std::min(_bits,
+				Algorithm::template find_from<false>(_array, buckets(), 0));
+	}
+
+	Size find_next_zero(Size pos) const
+	{
+		return std::min(_bits,
+				Algorithm::template find_from<false>(_array, buckets(), pos + 1));
+	}
+
+	Size find_zero_run(Size length, Size hint = 0) const
+	{
+		return Algorithm::find_zero_run(_array, _bits, length, hint);
+	}
+
+	Size reserve_run(Size length, Size hint = 0)
+	{
+		Size found = find_zero_run(length, hint);
+		if (found != _bits)
+			this->set_range(found, length);
+		return found;
+	}
+
+	template<typename Function>
+	void for_each_set_bit(Function && fn) const
+	{
+		Algorithm::for_each_set_bit(_array, buckets(),
+				std::forward<Function>(fn));
+	}
+
+	void clear()
+	{
+		if (buckets() > 0)
+			std::memset(_array, 0, buckets() * sizeof(BaseInt));
+	}
+
+	void fill()
+	{
+		if (buckets() == 0)
+			return;
+		std::memset(_array, 0xFF, buckets() * sizeof(BaseInt));
+		clear_padding();
+	}
+
+	bool operator==(const SelfType& other) const
+	{
+		return _bits == other._bits
+				&& Algorithm::equal(_array, other._array, buckets());
+	}
+
+	bool operator!=(const SelfType& other) const
+	{
+		return !(*this == other);
+	}
+
+	friend std::ostream& operator<<(std::ostream& os, const SelfType& me)
+	{
+		for (Size k = 0; k < me._bits; ++k)
+		{
+			bool ret = me.get_bit(k);
+			os << ret;
+		}
+		return os;
+	}
+};
+
+}
+
+#endif /* INCLUDE_R_BIT_VECTOR_HPP_ */
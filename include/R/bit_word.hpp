@@ -0,0 +1,139 @@
+/*
+ * bit_word.hpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef INCLUDE_R_BIT_WORD_HPP_
+#define INCLUDE_R_BIT_WORD_HPP_
+
+#include <cstddef>
+#include <climits>
+#include <type_traits>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+#ifdef FUNC_ATTR
+#define __func__attr__ FUNC_ATTR
+#else
+#define __func__attr__
+#endif
+
+namespace R
+{
+
+//Word-level helpers shared by the bitmap containers.
+//Results are undefined for a zero word in clz/ctz, like the builtins.
+namespace bit_word
+{
+
+typedef std::size_t Size;
+
+template<typename Word>
+__func__attr__ inline constexpr Size bits()
+{
+	return sizeof(Word) * CHAR_BIT;
+}
+
+template<typename Word>
+__func__attr__ inline Size popcount(Word word)
+{
+	static_assert(std::is_unsigned<Word>::value, "Unsigned type required.");
+#if defined(__GNUC__)
+	return (Size) __builtin_popcountll((unsigned long long) word);
+#else
+	Size count = 0;
+	for (; word; word &= (Word) (word - 1))
+		++count;
+	return count;
+#endif
+}
+
+//number of zero bits above the highest set bit, counted in Word width
+template<typename Word>
+__func__attr__ inline Size clz(Word word)
+{
+	static_assert(std::is_unsigned<Word>::value, "Unsigned type required.");
+#if defined(__GNUC__)
+	return (Size) __builtin_clzll((unsigned long long) word)
+			- (bits<unsigned long long>() - bits<Word>());
+#else
+	Size count = 0;
+	for (Word flag = (Word) ((Word) 1 << (bits<Word>() - 1));
+			!(word & flag); flag >>= 1)
+		++count;
+	return count;
+#endif
+}
+
+//number of zero bits below the lowest set bit
+template<typename Word>
+__func__attr__ inline Size ctz(Word word)
+{
+	static_assert(std::is_unsigned<Word>::value, "Unsigned type required.");
+#if defined(__GNUC__)
+	return (Size) __builtin_ctzll((unsigned long long) word);
+#else
+	Size count = 0;
+	for (; !(word & (Word) 1); word >>= 1)
+		++count;
+	return count;
+#endif
+}
+
+//clz/ctz which return the word width for a zero word
+template<typename Word>
+__func__attr__ inline Size clz_or_bits(Word word)
+{
+	return word ? clz(word) : bits<Word>();
+}
+
+template<typename Word>
+__func__attr__ inline Size ctz_or_bits(Word word)
+{
+	return word ? ctz(word) : bits<Word>();
+}
+
+//position (counted like clz) of the k-th set bit from the top, k < popcount
+template<typename Word>
+__func__attr__ inline Size select(Word word, Size k)
+{
+	static_assert(std::is_unsigned<Word>::value, "Unsigned type required.");
+#if defined(__BMI2__) && defined(__x86_64__)
+	//pdep deposits a single bit onto the (popcount - 1 - k)-th lowest set bit
+	Size rank = popcount(word) - 1 - k;
+	unsigned long long bit = _pdep_u64(1ULL << rank, (unsigned long long) word);
+	return bits<Word>() - 1 - (Size) __builtin_ctzll(bit);
+#else
+	//skip whole bytes from the top, then walk the remaining byte
+	Size shift = bits<Word>();
+	for (;;)
+	{
+		shift -= CHAR_BIT;
+		Size count = popcount((unsigned char) (word >> shift));
+		if (k < count)
+			break;
+		k -= count;
+	}
+	Size pos = bits<Word>() - CHAR_BIT - shift;
+	for (unsigned char byte = (unsigned char) (word >> shift);; byte <<= 1, ++pos)
+		if (byte & 0x80)
+		{
+			if (k == 0)
+				return pos;
+			--k;
+		}
+#endif
+}
+
+}
+
+}
+
+#ifdef __func__attr__
+#undef __func__attr__
+#endif
+
+#endif /* INCLUDE_R_BIT_WORD_HPP_ */
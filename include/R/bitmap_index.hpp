@@ -0,0 +1,620 @@
+/*
+ * bitmap_index.hpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef INCLUDE_R_BITMAP_INDEX_HPP_
+#define INCLUDE_R_BITMAP_INDEX_HPP_
+
+#include <cstdint>
+#include <cstring>
+#include <cassert>
+#include <vector>
+#include <algorithm>
+#include <utility>
+
+#include <R/bit_algorithm.hpp>
+#include <R/bit_kernel.hpp>
+#include <R/bit_vector.hpp>
+#include <R/memory_allocator.hpp>
+
+namespace R
+{
+
+//Boolean query over the attributes of a BitmapIndex. Leaves select the
+//records whose value lies in an inclusive range; &, | and ~ combine them
+//and nested nodes of the same operator are flattened into one n-way node.
+class BitmapQuery
+{
+public:
+	typedef std::size_t Size;
+	enum Kind
+	{
+		RANGE, AND, OR, NOT
+	};
+private:
+	Kind _kind;
+	Size _attribute;
+	Size _low;
+	Size _high;
+	std::vector<BitmapQuery> _children;
+
+	explicit BitmapQuery(Kind kind) :
+			_kind(kind), _attribute(0), _low(0), _high(0)
+	{
+	}
+
+	void append(const BitmapQuery& child)
+	{
+		if (child._kind == _kind)
+			_children.insert(_children.end(), child._children.begin(),
+					child._children.end());
+		else
+			_children.push_back(child);
+	}
+
+	static BitmapQuery combine(Kind kind, const BitmapQuery& left,
+			const BitmapQuery& right)
+	{
+		BitmapQuery result(kind);
+		result.append(left);
+		result.append(right);
+		return result;
+	}
+
+public:
+	static BitmapQuery equal(Size attribute, Size value)
+	{
+		return range(attribute, value, value);
+	}
+
+	//records with low <= value <= high
+	static BitmapQuery range(Size attribute, Size low, Size high)
+	{
+		BitmapQuery result(RANGE);
+		result._attribute = attribute;
+		result._low = low;
+		result._high = high;
+		return result;
+	}
+
+	Kind kind() const
+	{
+		return _kind;
+	}
+
+	Size attribute() const
+	{
+		return _attribute;
+	}
+
+	Size low() const
+	{
+		return _low;
+	}
+
+	Size high() const
+	{
+		return _high;
+	}
+
+	const std::vector<BitmapQuery>& children() const
+	{
+		return _children;
+	}
+
+	friend BitmapQuery operator&(const BitmapQuery& left,
+			const BitmapQuery& right)
+	{
+		return combine(AND, left, right);
+	}
+
+	friend BitmapQuery operator|(const BitmapQuery& left,
+			const BitmapQuery& right)
+	{
+		return combine(OR, left, right);
+	}
+
+	friend BitmapQuery operator~(const BitmapQuery& operand)
+	{
+		BitmapQuery result(NOT);
+		result._children.push_back(operand);
+		return result;
+	}
+};
+
+//Secondary index with one bitmap per attribute value (or per bin of
+//values) over a fixed set of records.
+//
+//Equality encoding sets a record in the bitmap of its bin; a range leaf
+//is the OR of its bins. Range encoding sets it in every bin >= its own,
+//so any range leaf is a single AND-NOT of two bitmaps at the price of
+//denser bitmaps and slower updates. With bin_width > 1 a leaf covers
+//whole bins and may return records just outside its bounds; callers
+//check those candidates against the base data.
+//
+//Queries are compiled into a plan first: constant and empty branches are
+//folded, AND operands are ordered by ascending cardinality with negated
+//operands last (fused into AND-NOT). The plan is then evaluated one chunk
+//of records at a time so the working buffers stay in L1, and an AND stops
+//reading operands as soon as its chunk is empty.
+class BitmapIndex
+{
+public:
+	typedef std::size_t Size;
+	typedef uint64_t Word;
+	typedef BitVector<Word> Bitmap;
+
+	enum Encoding
+	{
+		EQUALITY, RANGE
+	};
+private:
+	typedef BitAlgorithm<Word> Algorithm;
+
+	//words evaluated per chunk: 16384 records, 2KB per buffer
+	constexpr static Size CHUNK_WORDS()
+	{
+		return ((Size) 256);
+	}
+
+	struct Attribute
+	{
+		Encoding encoding;
+		Size cardinality;
+		Size bin_width;
+		std::vector<Bitmap> bitmaps;
+		std::vector<Size> counts;
+	};
+
+	struct Plan
+	{
+		enum Kind
+		{
+			EMPTY, ALL, BITMAP, AND, OR, NOT
+		};
+		Kind kind;
+		const Word* data;
+		Size estimate; //cardinality, exact for BITMAP
+		std::vector<Plan> children;
+
+		explicit Plan(Kind kind, Size estimate = 0, const Word* data = nullptr) :
+				kind(kind), data(data), estimate(estimate)
+		{
+		}
+	};
+
+	Allocator* _allocator;
+	Size _records;
+	std::vector<Attribute> _attributes;
+
+	Size bins(const Attribute& attribute) const
+	{
+		return (attribute.cardinality + attribute.bin_width - 1)
+				/ attribute.bin_width;
+	}
+
+	Plan bitmap_plan(const Attribute& attribute, Size bin) const
+	{
+		Size count = attribute.counts[bin];
+		if (count == 0)
+			return Plan(Plan::EMPTY);
+		if (count == _records)
+			return Plan(Plan::ALL, _records);
+		return Plan(Plan::BITMAP, count, attribute.bitmaps[bin].data());
+	}
+
+	Plan negate(Plan inner) const
+	{
+		if (inner.kind == Plan::EMPTY)
+			return Plan(Plan::ALL, _records);
+		if (inner.kind == Plan::ALL)
+			return Plan(Plan::EMPTY);
+		if (inner.kind == Plan::NOT)
+		{
+			Plan result = std::move(inner.children[0]);
+			return result;
+		}
+		Plan result(Plan::NOT, _records - inner.estimate);
+		result.children.push_back(std::move(inner));
+		return result;
+	}
+
+	Plan compile_range(const BitmapQuery& query) const
+	{
+		assert(query.attribute() < _attributes.size());
+		const Attribute& attribute = _attributes[query.attribute()];
+		Size high = std::min(query.high(), attribute.cardinality - 1);
+		if (attribute.cardinality == 0 || query.low() > high)
+			return Plan(Plan::EMPTY);
+		Size first = query.low() / attribute.bin_width;
+		Size last = high / attribute.bin_width;
+
+		if (attribute.encoding == RANGE)
+		{
+			Plan upper = bitmap_plan(attribute, last);
+			if (first == 0)
+				return upper;
+			std::vector<Plan> operands;
+			operands.push_back(std::move(upper));
+			operands.push_back(negate(bitmap_plan(attribute, first - 1)));
+			return combine(Plan::AND, std::move(operands));
+		}
+		std::vector<Plan> operands;
+		for (Size bin = first; bin <= last; ++bin)
+			operands.push_back(bitmap_plan(attribute, bin));
+		return combine(Plan::OR, std::move(operands));
+	}
+
+	//Folds constants, flattens nested nodes of the same kind and orders
+	//the operands of an AND.
+	Plan combine(Plan::Kind kind, std::vector<Plan> operands) const
+	{
+		//the operand that decides the node on its own, and the neutral one
+		Plan::Kind absorbing = (kind == Plan::AND) ? Plan::EMPTY : Plan::ALL;
+		Plan::Kind neutral = (kind == Plan::AND) ? Plan::ALL : Plan::EMPTY;
+
+		Plan result(kind);
+		for (Plan& operand : operands)
+		{
+			if (operand.kind == absorbing)
+				return absorbing == Plan::ALL ? Plan(Plan::ALL, _records) : Plan(Plan::EMPTY);
+			if (operand.kind == neutral)
+				continue;
+			if (operand.kind == kind)
+				for (Plan& child : operand.children)
+					result.children.push_back(std::move(child));
+			else
+				result.children.push_back(std::move(operand));
+		}
+		if (result.children.empty())
+			return neutral == Plan::ALL ? Plan(Plan::ALL, _records) : Plan(Plan::EMPTY);
+		if (result.children.size() == 1)
+		{
+			Plan single = std::move(result.children[0]);
+			return single;
+		}
+
+		if (kind == Plan::AND)
+		{
+			//sparsest positive operand first, then the negated operands
+			//that remove the most records
+			std::stable_sort(result.children.begin(), result.children.end(),
+					[](const Plan& left, const Plan& right)
+					{
+						bool left_not = left.kind == Plan::NOT;
+						bool right_not = right.kind == Plan::NOT;
+						if (left_not != right_not)
+							return right_not;
+						return left.estimate < right.estimate;
+					});
+			result.estimate = result.children[0].estimate;
+		}
+		else
+		{
+			for (const Plan& child : result.children)
+				result.estimate += child.estimate;
+			result.estimate = std::min(result.estimate, _records);
+		}
+		return result;
+	}
+
+	Plan compile(const BitmapQuery& query) const
+	{
+		if (query.kind() == BitmapQuery::RANGE)
+			return compile_range(query);
+		if (query.kind() == BitmapQuery::NOT)
+			return negate(compile(query.children()[0]));
+
+		std::vector<Plan> operands;
+		for (const BitmapQuery& child : query.children())
+			operands.push_back(compile(child));
+		return combine(query.kind() == BitmapQuery::AND ? Plan::AND : Plan::OR,
+				std::move(operands));
+	}
+
+	static Size depth(const Plan& plan)
+	{
+		Size deepest = 0;
+		for (const Plan& child : plan.children)
+			deepest = std::max(deepest, depth(child));
+		return plan.children.empty() ? 0 : deepest + 1;
+	}
+
+	//keeps bits past the last record clear in the last chunk
+	void clear_tail(Size first, Size words, Word* out) const
+	{
+		Size sub = Algorithm::sub_index(_records);
+		if (sub > 0 && first + words == Algorithm::buckets_for(_records))
+			out[words - 1] &= Algorithm::fill_left(sub);
+	}
+
+	bool fill(Size first, Size words, Word* out) const
+	{
+		std::memset(out, 0xFF, words * sizeof(Word));
+		clear_tail(first, words, out);
+		return true;
+	}
+
+	static bool any(const Word* chunk, Size words)
+	{
+		return bit_kernel::active().is_collide(chunk, chunk, words * sizeof(Word));
+	}
+
+	//Evaluates words [first, first + words) of the plan into out. scratch
+	//holds CHUNK_WORDS() words per tree level below the node. Returns
+	//false when the chunk of the result is all clear.
+	bool run(const Plan& plan, Size first, Size words, Word* out,
+			Word* scratch) const
+	{
+		switch (plan.kind)
+		{
+		case Plan::EMPTY:
+			std::memset(out, 0, words * sizeof(Word));
+			return false;
+		case Plan::ALL:
+			return fill(first, words, out);
+		case Plan::BITMAP:
+			std::memcpy(out, plan.data + first, words * sizeof(Word));
+			return any(out, words);
+		case Plan::NOT:
+		{
+			const Word* inner = operand(plan.children[0], first, words, scratch);
+			fill(first, words, out);
+			bit_kernel::active().andnot(out, inner, words * sizeof(Word));
+			return any(out, words);
+		}
+		case Plan::AND:
+			return run_and(plan, first, words, out, scratch);
+		case Plan::OR:
+			return run_or(plan, first, words, out, scratch);
+		}
+		return false;
+	}
+
+	//Leaves are read in place; other operands are evaluated into scratch.
+	const Word* operand(const Plan& plan, Size first, Size words,
+			Word* scratch) const
+	{
+		if (plan.kind == Plan::BITMAP)
+			return plan.data + first;
+		run(plan, first, words, scratch, scratch + CHUNK_WORDS());
+		return scratch;
+	}
+
+	bool run_and(const Plan& plan, Size first, Size words, Word* out,
+			Word* scratch) const
+	{
+		const bit_kernel::Table& kernel = bit_kernel::active();
+		Size bytes = words * sizeof(Word);
+		std::vector<Plan>::const_iterator child = plan.children.begin();
+		//only negated operands: start from every record
+		bool found = (child->kind == Plan::NOT) ?
+				fill(first, words, out) :
+				run(*child++, first, words, out, scratch);
+		for (; found && child != plan.children.end(); ++child)
+		{
+			if (child->kind == Plan::NOT)
+				kernel.andnot(out,
+						operand(child->children[0], first, words, scratch), bytes);
+			else
+				kernel.intersect(out, operand(*child, first, words, scratch),
+						bytes);
+			found = any(out, words);
+		}
+		return found;
+	}
+
+	bool run_or(const Plan& plan, Size first, Size words, Word* out,
+			Word* scratch) const
+	{
+		const bit_kernel::Table& kernel = bit_kernel::active();
+		std::vector<Plan>::const_iterator child = plan.children.begin();
+		run(*child++, first, words, out, scratch);
+		for (; child != plan.children.end(); ++child)
+			kernel.merge(out, operand(*child, first, words, scratch),
+					words * sizeof(Word));
+		return any(out, words);
+	}
+
+	//calls fn(first, words, chunk) for every non-empty chunk of the result
+	template<typename Function>
+	void for_each_chunk(const BitmapQuery& query, Function && fn) const
+	{
+		Plan plan = compile(query);
+		if (plan.kind == Plan::EMPTY)
+			return;
+		std::vector<Word> buffer((depth(plan) + 2) * CHUNK_WORDS());
+		Size buckets = Algorithm::buckets_for(_records);
+		for (Size first = 0; first < buckets; first += CHUNK_WORDS())
+		{
+			Size words = std::min(CHUNK_WORDS(), buckets - first);
+			if (run(plan, first, words, buffer.data(),
+					buffer.data() + CHUNK_WORDS()))
+				fn(first, words, (const Word*) buffer.data());
+		}
+	}
+
+public:
+	explicit BitmapIndex(Size records = 0,
+			Allocator& allocator = default_allocator()) :
+			_allocator(&allocator), _records(records)
+	{
+	}
+
+	Size records() const
+	{
+		return _records;
+	}
+
+	Size attributes() const
+	{
+		return _attributes.size();
+	}
+
+	//Adds an attribute with values in [0, cardinality), one bitmap per
+	//bin_width consecutive values. Returns the attribute id.
+	Size add_attribute(Size cardinality, Encoding encoding = EQUALITY,
+			Size bin_width = 1)
+	{
+		assert(bin_width > 0);
+		Attribute attribute;
+		attribute.encoding = encoding;
+		attribute.cardinality = cardinality;
+		attribute.bin_width = bin_width;
+		attribute.bitmaps.reserve(bins(attribute));
+		for (Size bin = 0; bin < bins(attribute); ++bin)
+			attribute.bitmaps.push_back(Bitmap(_records, false, *_allocator));
+		attribute.counts.assign(bins(attribute), 0);
+		_attributes.push_back(std::move(attribute));
+		return _attributes.size() - 1;
+	}
+
+	Size bins(Size attribute) const
+	{
+		return bins(_attributes[attribute]);
+	}
+
+	const Bitmap& bitmap(Size attribute, Size bin) const
+	{
+		return _attributes[attribute].bitmaps[bin];
+	}
+
+	//The record must not hold a value for the attribute; clear it first
+	//when updating.
+	void set(Size attribute, Size record, Size value)
+	{
+		assert(attribute < _attributes.size() && record < _records);
+		Attribute& target = _attributes[attribute];
+		assert(value < target.cardinality);
+		Size bin = value / target.bin_width;
+		Size last = (target.encoding == RANGE) ? bins(target) : bin + 1;
+		for (; bin < last; ++bin)
+			if (!target.bitmaps[bin].get_bit(record))
+			{
+				target.bitmaps[bin].set_bit(record);
+				++target.counts[bin];
+			}
+	}
+
+	void clear(Size attribute, Size record)
+	{
+		assert(attribute < _attributes.size() && record < _records);
+		Attribute& target = _attributes[attribute];
+		for (Size bin = 0; bin < bins(target); ++bin)
+			if (target.bitmaps[bin].get_bit(record))
+			{
+				target.bitmaps[bin].clear_bit(record);
+				--target.counts[bin];
+			}
+	}
+
+	//New records hold no value; dropped records leave every bitmap.
+	void resize(Size records)
+	{
+		for (Attribute& attribute : _attributes)
+			for (Size bin = 0; bin < bins(attribute); ++bin)
+			{
+				attribute.bitmaps[bin].resize(records);
+				if (records < _records)
+					attribute.counts[bin] = attribute.bitmaps[bin].count();
+			}
+		_records = records;
+	}
+
+	Bitmap evaluate(const BitmapQuery& query) const
+	{
+		Bitmap result(_records, false, *_allocator);
+		Word* out = result.data();
+		for_each_chunk(query, [out](Size first, Size words, const Word* chunk)
+		{
+			std::memcpy(out + first, chunk, words * sizeof(Word));
+		});
+		return result;
+	}
+
+	Size count(const BitmapQuery& query) const
+	{
+		Size total = 0;
+		for_each_chunk(query, [&total](Size, Size words, const Word* chunk)
+		{
+			total += Algorithm::count(chunk, words);
+		});
+		return total;
+	}
+
+	//calls fn(record) for every match in ascending order without
+	//materializing the result
+	template<typename Function>
+	void for_each(const BitmapQuery& query, Function && fn) const
+	{
+		for_each_chunk(query, [&fn](Size first, Size words, const Word* chunk)
+		{
+			Size base = first * Algorithm::BIT_COUNT();
+			Algorithm::for_each_set_bit(chunk, words, [&fn, base](Size index)
+			{
+				fn(base + index);
+			});
+		});
+	}
+
+	//Pulls matches one at a time, evaluating a chunk whenever the current
+	//one is exhausted. The index must not change while a cursor is in use.
+	class Cursor
+	{
+		friend class BitmapIndex;
+
+		const BitmapIndex* _index;
+		Plan _plan;
+		std::vector<Word> _buffer;
+		Size _first; //bucket of the current chunk
+		Size _words;
+		Size _position; //next bit to inspect in the chunk
+
+		Cursor(const BitmapIndex& index, const BitmapQuery& query) :
+				_index(&index), _plan(index.compile(query)),
+						_buffer((depth(_plan) + 2) * CHUNK_WORDS()), _first(0),
+						_words(0), _position(0)
+		{
+		}
+
+	public:
+		//stores the next matching record, returns false when exhausted
+		bool next(Size& record)
+		{
+			Size buckets = Algorithm::buckets_for(_index->_records);
+			while (true)
+			{
+				Size found = Algorithm::template find_from<true>(
+						_buffer.data(), _words, _position);
+				if (found < _words * Algorithm::BIT_COUNT())
+				{
+					_position = found + 1;
+					record = _first * Algorithm::BIT_COUNT() + found;
+					return true;
+				}
+				_first += _words;
+				_position = 0;
+				_words = 0;
+				if (_plan.kind == Plan::EMPTY || _first >= buckets)
+					return false;
+				Size words = std::min(CHUNK_WORDS(), buckets - _first);
+				if (_index->run(_plan, _first, words, _buffer.data(),
+						_buffer.data() + CHUNK_WORDS()))
+					_words = words;
+				else
+					_first += words;
+			}
+		}
+	};
+
+	Cursor cursor(const BitmapQuery& query) const
+	{
+		return Cursor(*this, query);
+	}
+};
+
+}
+
+#endif /* INCLUDE_R_BITMAP_INDEX_HPP_ */
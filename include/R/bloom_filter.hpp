@@ -0,0 +1,381 @@
+/*
+ * bloom_filter.hpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef INCLUDE_R_BLOOM_FILTER_HPP_
+#define INCLUDE_R_BLOOM_FILTER_HPP_
+
+#include <cstdint>
+#include <cmath>
+#include <atomic>
+#include <algorithm>
+#include <new>
+
+#include <R/bit_algorithm.hpp>
+#include <R/bit_kernel.hpp>
+#include <R/bit_vector.hpp>
+#include <R/hash_batch.hpp>
+#include <R/memory_allocator.hpp>
+
+namespace R
+{
+
+//Split-block Bloom filter layout shared by the plain and atomic filters.
+//A key hash selects one 512-bit block (a cache line) with its high half
+//and sets one bit in each of the block's eight words with its low half,
+//so a lookup touches exactly one line. Bits follow the BitVector order.
+namespace bloom_block
+{
+
+typedef std::size_t Size;
+typedef uint64_t Word;
+
+constexpr Size WORDS = 8;
+constexpr Size BITS = WORDS * 64;
+
+//odd multipliers, one per word; one array for the whole program, since
+//the inline functions below use it
+inline const uint32_t* salt()
+{
+	alignas(32) static const uint32_t SALT[WORDS] =
+	{ 0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU, 0x705495c7U,
+			0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U };
+	return SALT;
+}
+
+//block index in [0, blocks) without a division
+inline Size block_of(uint64_t hash, Size blocks)
+{
+	return (Size) (((hash >> 32) * (uint64_t) blocks) >> 32);
+}
+
+//One bit per word from the top 6 bits of (low * salt). The fixed-count
+//loop is vectorized by the compiler.
+inline void make_masks(uint64_t hash, Word masks[WORDS])
+{
+	uint32_t low = (uint32_t) hash;
+	for (Size index = 0; index < WORDS; ++index)
+		masks[index] = BitAlgorithm<Word>::mark_bit(
+				(uint32_t) (low * salt()[index]) >> 26);
+}
+
+inline bool contains(const Word* block, uint64_t hash)
+{
+	Word masks[WORDS];
+	make_masks(hash, masks);
+	Word missing = 0;
+	for (Size index = 0; index < WORDS; ++index)
+		missing |= masks[index] & ~block[index];
+	return missing == 0;
+}
+
+inline void insert(Word* block, uint64_t hash)
+{
+	Word masks[WORDS];
+	make_masks(hash, masks);
+	for (Size index = 0; index < WORDS; ++index)
+		block[index] |= masks[index];
+}
+
+#ifdef R_BIT_KERNEL_AVX2
+//all eight masks in two ymm registers: mullo, shift and variable shift
+__attribute__((target("avx2")))
+inline void make_masks_avx2(uint64_t hash, __m256i& low_words,
+		__m256i& high_words)
+{
+	__m256i products = _mm256_mullo_epi32(_mm256_set1_epi32((int) hash),
+			_mm256_load_si256((const __m256i *) salt()));
+	__m256i shifts = _mm256_srli_epi32(products, 26);
+	__m256i top = _mm256_set1_epi64x(
+			(long long) BitAlgorithm<Word>::HIGH_FLAG());
+	low_words = _mm256_srlv_epi64(top,
+			_mm256_cvtepu32_epi64(_mm256_castsi256_si128(shifts)));
+	high_words = _mm256_srlv_epi64(top,
+			_mm256_cvtepu32_epi64(_mm256_extracti128_si256(shifts, 1)));
+}
+
+__attribute__((target("avx2")))
+inline bool contains_avx2(const Word* block, uint64_t hash)
+{
+	__m256i low_words, high_words;
+	make_masks_avx2(hash, low_words, high_words);
+	return _mm256_testc_si256(_mm256_load_si256((const __m256i *) block),
+			low_words)
+			&& _mm256_testc_si256(
+					_mm256_load_si256((const __m256i *) (block + 4)),
+					high_words);
+}
+
+__attribute__((target("avx2")))
+inline void insert_avx2(Word* block, uint64_t hash)
+{
+	__m256i low_words, high_words;
+	make_masks_avx2(hash, low_words, high_words);
+	__m256i* lines = (__m256i *) block;
+	_mm256_store_si256(lines,
+			_mm256_or_si256(_mm256_load_si256(lines), low_words));
+	_mm256_store_si256(lines + 1,
+			_mm256_or_si256(_mm256_load_si256(lines + 1), high_words));
+}
+#endif
+
+//Standard Bloom estimate of the bits for keys at a false positive rate.
+//Blocking costs a little accuracy, so it is rounded up by 10%.
+inline Size bits_for(Size keys, double false_positive_rate)
+{
+	double ln2 = std::log(2.0);
+	double bits = -(double) keys * std::log(false_positive_rate) / (ln2 * ln2);
+	return (Size) (bits * 1.1) + BITS;
+}
+
+}
+
+//Blocked Bloom filter over a BitVector. Keys are given as 64-bit hashes;
+//they are mixed again, so weak hashes (e.g. identity) are fine.
+class BloomFilter
+{
+public:
+	typedef std::size_t Size;
+	typedef bloom_block::Word Word;
+private:
+	BitVector<Word> _bits;
+	Size _blocks;
+
+	friend class AtomicBloomFilter;
+
+	Word* block(uint64_t hash)
+	{
+		return _bits.data()
+				+ bloom_block::block_of(hash, _blocks) * bloom_block::WORDS;
+	}
+
+	const Word* block(uint64_t hash) const
+	{
+		return _bits.data()
+				+ bloom_block::block_of(hash, _blocks) * bloom_block::WORDS;
+	}
+
+public:
+	//bits is rounded up to whole blocks
+	explicit BloomFilter(Size bits, Allocator& allocator = default_allocator()) :
+			_bits(0, false, allocator), _blocks(
+					std::max<Size>(1,
+							(bits + bloom_block::BITS - 1) / bloom_block::BITS))
+	{
+		_bits.resize(_blocks * bloom_block::BITS);
+	}
+
+	Size size() const
+	{
+		return _bits.size();
+	}
+
+	const BitVector<Word>& bits() const
+	{
+		return _bits;
+	}
+
+	void clear()
+	{
+		_bits.clear();
+	}
+
+	void insert(uint64_t key)
+	{
+		uint64_t hash = hash_batch::mix(key);
+		bloom_block::insert(block(hash), hash);
+	}
+
+	bool contains(uint64_t key) const
+	{
+		uint64_t hash = hash_batch::mix(key);
+		return bloom_block::contains(block(hash), hash);
+	}
+
+	//Inserts count keys a batch at a time, prefetching the blocks of the
+	//batch first.
+	void insert_many(const uint64_t* keys, Size count)
+	{
+#ifdef R_BIT_KERNEL_AVX2
+		bool avx2 = bit_kernel::use_avx2();
+#endif
+		hash_batch::for_each_batch(keys, count, [this](uint64_t hash)
+		{
+			hash_batch::prefetch(block(hash), true);
+		}, [&](Size, uint64_t hash)
+		{
+#ifdef R_BIT_KERNEL_AVX2
+			if (avx2)
+			{
+				bloom_block::insert_avx2(block(hash), hash);
+				return;
+			}
+#endif
+			bloom_block::insert(block(hash), hash);
+		});
+	}
+
+	//Writes contains(keys[i]) to results[i]; returns the number of hits.
+	Size contains_many(const uint64_t* keys, Size count, bool* results) const
+	{
+#ifdef R_BIT_KERNEL_AVX2
+		bool avx2 = bit_kernel::use_avx2();
+#endif
+		Size hits = 0;
+		hash_batch::for_each_batch(keys, count, [this](uint64_t hash)
+		{
+			hash_batch::prefetch(block(hash));
+		}, [&](Size index, uint64_t hash)
+		{
+			bool found;
+#ifdef R_BIT_KERNEL_AVX2
+			if (avx2)
+				found = bloom_block::contains_avx2(block(hash), hash);
+			else
+#endif
+				found = bloom_block::contains(block(hash), hash);
+			results[index] = found;
+			hits += found;
+		});
+		return hits;
+	}
+
+	//filters must have the same size
+	void merge(const BloomFilter& other)
+	{
+		_bits.merge(other._bits);
+	}
+};
+
+//Bloom filter that accepts concurrent inserts and lookups. Inserts only
+//issue fetch_or for words that miss a bit, so hot keys stay read-only.
+class AtomicBloomFilter
+{
+public:
+	typedef std::size_t Size;
+	typedef bloom_block::Word Word;
+private:
+	Allocator* _allocator;
+	Allocator::Aux _aux;
+	std::atomic<Word>* _words;
+	Size _blocks;
+
+	std::atomic<Word>* block(uint64_t hash) const
+	{
+		return _words + bloom_block::block_of(hash, _blocks) * bloom_block::WORDS;
+	}
+
+	void insert_hash(uint64_t hash, std::memory_order order)
+	{
+		Word masks[bloom_block::WORDS];
+		bloom_block::make_masks(hash, masks);
+		std::atomic<Word>* words = block(hash);
+		for (Size index = 0; index < bloom_block::WORDS; ++index)
+			if ((words[index].load(std::memory_order_relaxed) & masks[index])
+					!= masks[index])
+				words[index].fetch_or(masks[index], order);
+	}
+
+	bool contains_hash(uint64_t hash, std::memory_order order) const
+	{
+		Word masks[bloom_block::WORDS];
+		bloom_block::make_masks(hash, masks);
+		std::atomic<Word>* words = block(hash);
+		Word missing = 0;
+		for (Size index = 0; index < bloom_block::WORDS; ++index)
+			missing |= masks[index] & ~words[index].load(order);
+		return missing == 0;
+	}
+
+public:
+	explicit AtomicBloomFilter(Size bits,
+			Allocator& allocator = default_allocator()) :
+			_allocator(&allocator), _aux(Allocator::NullPtr), _words(nullptr),
+					_blocks(std::max<Size>(1,
+							(bits + bloom_block::BITS - 1) / bloom_block::BITS))
+	{
+		Size words = _blocks * bloom_block::WORDS;
+		Allocator::Ptr addr = Allocator::NullPtr;
+		_aux = allocate_aligned(allocator, words * sizeof(std::atomic<Word>),
+				CACHE_LINE_SIZE, addr);
+		if (addr == Allocator::NullPtr)
+			throw std::bad_alloc();
+		_words = (std::atomic<Word>*) addr;
+		for (Size index = 0; index < words; ++index)
+			new (_words + index) std::atomic<Word>(0);
+	}
+
+	AtomicBloomFilter(const AtomicBloomFilter&) = delete;
+	AtomicBloomFilter& operator=(const AtomicBloomFilter&) = delete;
+
+	~AtomicBloomFilter()
+	{
+		_allocator->deallocate(_aux);
+	}
+
+	Size size() const
+	{
+		return _blocks * bloom_block::BITS;
+	}
+
+	//not safe against concurrent inserts
+	void clear()
+	{
+		for (Size index = 0; index < _blocks * bloom_block::WORDS; ++index)
+			_words[index].store(0, std::memory_order_relaxed);
+	}
+
+	void insert(uint64_t key, std::memory_order order = std::memory_order_release)
+	{
+		insert_hash(hash_batch::mix(key), order);
+	}
+
+	bool contains(uint64_t key,
+			std::memory_order order = std::memory_order_acquire) const
+	{
+		return contains_hash(hash_batch::mix(key), order);
+	}
+
+	void insert_many(const uint64_t* keys, Size count,
+			std::memory_order order = std::memory_order_release)
+	{
+		hash_batch::for_each_batch(keys, count, [this](uint64_t hash)
+		{
+			hash_batch::prefetch(block(hash), true);
+		}, [this, order](Size, uint64_t hash)
+		{
+			insert_hash(hash, order);
+		});
+	}
+
+	Size contains_many(const uint64_t* keys, Size count, bool* results,
+			std::memory_order order = std::memory_order_acquire) const
+	{
+		Size hits = 0;
+		hash_batch::for_each_batch(keys, count, [this](uint64_t hash)
+		{
+			hash_batch::prefetch(block(hash));
+		}, [this, order, results, &hits](Size index, uint64_t hash)
+		{
+			results[index] = contains_hash(hash, order);
+			hits += results[index];
+		});
+		return hits;
+	}
+
+	//copies the current bits into a plain filter of the same size
+	BloomFilter snapshot(Allocator& allocator = default_allocator()) const
+	{
+		BloomFilter copy(size(), allocator);
+		Word* words = copy._bits.data();
+		for (Size index = 0; index < _blocks * bloom_block::WORDS; ++index)
+			words[index] = _words[index].load(std::memory_order_acquire);
+		return copy;
+	}
+};
+
+}
+
+#endif /* INCLUDE_R_BLOOM_FILTER_HPP_ */
@@ -0,0 +1,485 @@
+/*
+ * channel.hpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef INCLUDE_R_CHANNEL_HPP_
+#define INCLUDE_R_CHANNEL_HPP_
+
+#include <cstdint>
+#include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <R/fiber_sync.hpp>
+
+namespace R
+{
+
+inline namespace R_COROUTINE_NAMESPACE
+{
+
+class Select;
+
+namespace fiber_sync
+{
+
+//The part of a channel a Select works with, whatever the element type.
+//The *_locked operations run with the lock held and either complete at
+//once, handing back in woken a waiter to wake once the lock is released,
+//or return false when the caller would have to wait.
+class ChannelBase
+{
+protected:
+	SpinLock _lock;
+	WaitList _senders; //value points at the element to move from
+	WaitList _receivers; //value points at the slot to move into
+	bool _closed;
+
+	friend class R::Select;
+
+	ChannelBase() :
+			_closed(false)
+	{
+	}
+
+	virtual ~ChannelBase()
+	{
+	}
+
+	virtual bool send_locked(void* value, bool& ok, Waiter*& woken) = 0;
+	virtual bool receive_locked(void* slot, bool& ok, Waiter*& woken) = 0;
+
+public:
+	ChannelBase(const ChannelBase&) = delete;
+	ChannelBase& operator=(const ChannelBase&) = delete;
+
+	//Wakes every waiting sender and receiver. Sends fail from now on;
+	//receives drain the buffer, then fail.
+	void close()
+	{
+		_lock.lock();
+		_closed = true;
+		Waiter* senders = _senders.pop_all();
+		Waiter* receivers = _receivers.pop_all();
+		for (Waiter* waiter = senders; waiter != nullptr; waiter = waiter->next)
+			waiter->ok = false;
+		for (Waiter* waiter = receivers; waiter != nullptr;
+				waiter = waiter->next)
+			waiter->ok = false;
+		_lock.unlock();
+		wake_all(senders);
+		wake_all(receivers);
+	}
+
+	bool closed()
+	{
+		std::lock_guard<SpinLock> lock(_lock);
+		return _closed;
+	}
+};
+
+}
+
+//Channel of T between fibers, as in Go. A sender finding the buffer full
+//and a receiver finding it empty are suspended in FIFO order; the other
+//side moves the element straight between their stacks and readies them,
+//so a hand-off costs no system call and no lock beyond a spin lock held
+//for a few instructions. Capacity 0 makes every send a rendezvous with a
+//receiver, UNBOUNDED never lets a send wait. Threads outside of fibers
+//may use channels too, and block. Select waits on several at once.
+template<typename T>
+class Channel : public fiber_sync::ChannelBase
+{
+public:
+	typedef std::size_t Size;
+	static constexpr Size UNBOUNDED = std::numeric_limits<Size>::max();
+private:
+	typedef fiber_sync::Waiter Waiter;
+
+	std::deque<T> _buffer;
+	Size _capacity;
+
+	bool send_locked(void* value, bool& ok, Waiter*& woken) override final
+	{
+		T& element = *(T*) value;
+		ok = !_closed;
+		if (!ok)
+			return true;
+		if (Waiter* receiver = _receivers.pop())
+		{
+			*(T*) receiver->value = std::move(element);
+			woken = receiver;
+			return true;
+		}
+		if (_buffer.size() >= _capacity)
+			return false;
+		_buffer.push_back(std::move(element));
+		return true;
+	}
+
+	bool receive_locked(void* slot, bool& ok, Waiter*& woken) override final
+	{
+		T& into = *(T*) slot;
+		ok = true;
+		if (!_buffer.empty())
+		{
+			into = std::move(_buffer.front());
+			_buffer.pop_front();
+			//the first waiting sender takes the freed place
+			if (Waiter* sender = _senders.pop())
+			{
+				_buffer.push_back(std::move(*(T*) sender->value));
+				woken = sender;
+			}
+			return true;
+		}
+		if (Waiter* sender = _senders.pop())
+		{
+			into = std::move(*(T*) sender->value);
+			woken = sender;
+			return true;
+		}
+		ok = !_closed;
+		return !ok;
+	}
+
+	//waits in list for the other side, which sets waiter.ok
+	bool wait(fiber_sync::WaitList& list, void* value)
+	{
+		Waiter waiter;
+		waiter.value = value;
+		list.push(&waiter);
+		fiber_sync::park(waiter, [this]()
+		{
+			_lock.unlock();
+		});
+		return waiter.ok;
+	}
+
+	bool wait_until(fiber_sync::WaitList& list, void* value,
+			Scheduler::Clock::time_point deadline)
+	{
+		Waiter waiter;
+		waiter.value = value;
+		list.push(&waiter);
+		return fiber_sync::park_until(waiter, list, _lock, [this]()
+		{
+			_lock.unlock();
+		}, deadline) && waiter.ok;
+	}
+
+	bool finish(bool ok, Waiter* woken)
+	{
+		_lock.unlock();
+		if (woken != nullptr)
+			fiber_sync::wake(woken);
+		return ok;
+	}
+
+public:
+	explicit Channel(Size capacity = 0) :
+			_capacity(capacity)
+	{
+	}
+
+	//Waits while the buffer is full. False if the channel is closed,
+	//value then being dropped.
+	bool send(T value)
+	{
+		bool ok;
+		Waiter* woken = nullptr;
+		_lock.lock();
+		if (Channel::send_locked(&value, ok, woken))
+			return finish(ok, woken);
+		return wait(_senders, &value);
+	}
+
+	//Moves from value only if it is sent now. False when the channel is
+	//full or closed.
+	bool try_send(T& value)
+	{
+		bool ok;
+		Waiter* woken = nullptr;
+		_lock.lock();
+		if (Channel::send_locked(&value, ok, woken))
+			return finish(ok, woken);
+		_lock.unlock();
+		return false;
+	}
+
+	//Waits while the buffer is empty. False once the channel is closed
+	//and drained.
+	bool receive(T& value)
+	{
+		bool ok;
+		Waiter* woken = nullptr;
+		_lock.lock();
+		if (Channel::receive_locked(&value, ok, woken))
+			return finish(ok, woken);
+		return wait(_receivers, &value);
+	}
+
+	//false when nothing is there to take now
+	bool try_receive(T& value)
+	{
+		bool ok;
+		Waiter* woken = nullptr;
+		_lock.lock();
+		if (Channel::receive_locked(&value, ok, woken))
+			return finish(ok, woken);
+		_lock.unlock();
+		return false;
+	}
+
+	//Moves from value only if it is sent. False when the channel is closed
+	//or still full at deadline.
+	bool send_until(T& value, Scheduler::Clock::time_point deadline)
+	{
+		bool ok;
+		Waiter* woken = nullptr;
+		_lock.lock();
+		if (Channel::send_locked(&value, ok, woken))
+			return finish(ok, woken);
+		return wait_until(_senders, &value, deadline);
+	}
+
+	//false when the channel is closed and drained, or empty at deadline
+	bool receive_until(T& value, Scheduler::Clock::time_point deadline)
+	{
+		bool ok;
+		Waiter* woken = nullptr;
+		_lock.lock();
+		if (Channel::receive_locked(&value, ok, woken))
+			return finish(ok, woken);
+		return wait_until(_receivers, &value, deadline);
+	}
+
+	template<typename Rep, typename Period>
+	bool send_for(T& value, const std::chrono::duration<Rep, Period>& duration)
+	{
+		return send_until(value, Scheduler::Clock::now()
+				+ std::chrono::duration_cast<Scheduler::Clock::duration>(duration));
+	}
+
+	template<typename Rep, typename Period>
+	bool receive_for(T& value,
+			const std::chrono::duration<Rep, Period>& duration)
+	{
+		return receive_until(value, Scheduler::Clock::now()
+				+ std::chrono::duration_cast<Scheduler::Clock::duration>(duration));
+	}
+
+	Size capacity() const
+	{
+		return _capacity;
+	}
+
+	//buffered elements
+	Size size()
+	{
+		std::lock_guard<fiber_sync::SpinLock> lock(_lock);
+		return _buffer.size();
+	}
+};
+
+template<typename T>
+constexpr typename Channel<T>::Size Channel<T>::UNBOUNDED;
+
+//Waits for the first of several channel operations that can complete, as
+//Go's select. Cases are added once and the Select reused:
+//
+//	Select select;
+//	select.receive(requests, request).receive(quit, signal);
+//	while (select.wait() == 0)
+//		...
+//
+//wait() returns the index of the case that completed, in the order they
+//were added, wait_until() and poll() NONE if none did in time; ok() tells
+//whether it moved an element or found its channel closed. The channels
+//are locked together in address order, so selects over the same
+//channels cannot deadlock, and the scan starts one case further on every
+//call, so a busy channel cannot starve the others.
+class Select
+{
+public:
+	typedef std::size_t Size;
+	static constexpr Size NONE = std::numeric_limits<Size>::max();
+private:
+	typedef fiber_sync::Waiter Waiter;
+	typedef fiber_sync::ChannelBase ChannelBase;
+
+	struct Case
+	{
+		ChannelBase* channel;
+		void* value;
+		bool send;
+	};
+
+	std::vector<Case> _cases;
+	std::vector<ChannelBase*> _channels; //sorted, without duplicates
+	std::vector<Waiter> _waiters;
+	Size _start;
+	bool _ok;
+
+	void add(ChannelBase* channel, void* value, bool send)
+	{
+		Case entry = { channel, value, send };
+		_cases.push_back(entry);
+		std::vector<ChannelBase*>::iterator position = std::lower_bound(
+				_channels.begin(), _channels.end(), channel);
+		if (position == _channels.end() || *position != channel)
+			_channels.insert(position, channel);
+	}
+
+	void lock()
+	{
+		for (ChannelBase* channel : _channels)
+			channel->_lock.lock();
+	}
+
+	void unlock()
+	{
+		for (ChannelBase* channel : _channels)
+			channel->_lock.unlock();
+	}
+
+	//waits forever without a deadline, not at all with one in the past
+	Size run(const Scheduler::Clock::time_point* deadline)
+	{
+		Size count = _cases.size();
+		assert(count > 0);
+		lock();
+		for (Size step = 0; step < count; ++step)
+		{
+			Size index = (_start + step) % count;
+			Case& entry = _cases[index];
+			Waiter* woken = nullptr;
+			bool done = entry.send ?
+					entry.channel->send_locked(entry.value, _ok, woken) :
+					entry.channel->receive_locked(entry.value, _ok, woken);
+			if (done)
+			{
+				unlock();
+				if (woken != nullptr)
+					fiber_sync::wake(woken);
+				_start = index + 1;
+				return index;
+			}
+		}
+		if (deadline != nullptr && *deadline <= Scheduler::Clock::now())
+		{
+			unlock();
+			return NONE;
+		}
+		std::atomic<void*> winner(nullptr);
+		_waiters.assign(count, Waiter());
+		for (Size index = 0; index < count; ++index)
+		{
+			Case& entry = _cases[index];
+			Waiter& waiter = _waiters[index];
+			waiter.value = entry.value;
+			waiter.winner = &winner;
+			waiter.index = index;
+			(entry.send ? entry.channel->_senders : entry.channel->_receivers).push(
+					&waiter);
+		}
+		bool woken = true;
+		if (deadline != nullptr)
+			woken = fiber_sync::park_until(_waiters.data(), count, [this]()
+			{
+				unlock();
+			}, *deadline);
+		else
+			fiber_sync::park(_waiters.data(), count, [this]()
+			{
+				unlock();
+			});
+		//the winner was taken off its list, losers still linked are removed
+		lock();
+		for (Size index = 0; index < count; ++index)
+		{
+			Waiter& waiter = _waiters[index];
+			Case& entry = _cases[index];
+			if (waiter.linked)
+				(entry.send ? entry.channel->_senders :
+						entry.channel->_receivers).remove(&waiter);
+		}
+		unlock();
+		if (!woken)
+			return NONE;
+		Waiter* chosen = (Waiter*) winner.load(std::memory_order_acquire);
+		_ok = chosen->ok;
+		_start = chosen->index + 1;
+		return chosen->index;
+	}
+
+public:
+	Select() :
+			_start(0), _ok(false)
+	{
+	}
+
+	Select(const Select&) = delete;
+	Select& operator=(const Select&) = delete;
+
+	//value is moved from only when this case is chosen
+	template<typename T>
+	Select& send(Channel<T>& channel, T& value)
+	{
+		add(&channel, &value, true);
+		return *this;
+	}
+
+	template<typename T>
+	Select& receive(Channel<T>& channel, T& value)
+	{
+		add(&channel, &value, false);
+		return *this;
+	}
+
+	//waits until a case completes and returns its index
+	Size wait()
+	{
+		return run(nullptr);
+	}
+
+	//NONE if no case completed by deadline
+	Size wait_until(Scheduler::Clock::time_point deadline)
+	{
+		return run(&deadline);
+	}
+
+	template<typename Rep, typename Period>
+	Size wait_for(const std::chrono::duration<Rep, Period>& duration)
+	{
+		return wait_until(Scheduler::Clock::now()
+				+ std::chrono::duration_cast<Scheduler::Clock::duration>(duration));
+	}
+
+	//the index of a case that completes now, NONE if none can
+	Size poll()
+	{
+		Scheduler::Clock::time_point now = Scheduler::Clock::time_point::min();
+		return run(&now);
+	}
+
+	//false if the last completed case found its channel closed
+	bool ok() const
+	{
+		return _ok;
+	}
+};
+
+}
+
+}
+
+#endif /* INCLUDE_R_CHANNEL_HPP_ */
@@ -0,0 +1,201 @@
+/*
+ * context_switch.hpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef INCLUDE_R_CONTEXT_SWITCH_HPP_
+#define INCLUDE_R_CONTEXT_SWITCH_HPP_
+
+#include <cstdint>
+#include <cstddef>
+
+//Coroutine backends, chosen at compile time by defining R_COROUTINE_BACKEND
+//to one of these before including coroutine.hpp.
+//
+//The default is THREAD only where no user-space switch exists. The other
+//backends run coroutines on pooled R_COROUTINE_STACK_SIZE (128 KB)
+//stacks instead of full thread stacks, and overflowing one faults on its
+//guard page. Deeply recursive bodies should pass a larger stack_size to
+//CallType, raise R_COROUTINE_STACK_SIZE, or define
+//R_COROUTINE_BACKEND=R_COROUTINE_THREAD for full thread stacks.
+#define R_COROUTINE_THREAD 1   //one std::thread per coroutine
+#define R_COROUTINE_UCONTEXT 2 //swapcontext(3)
+#define R_COROUTINE_ASM 3      //hand-written x86-64 stack switch
+#define R_COROUTINE_STACKLESS 4 //C++20 coroutines; bodies must be coroutines
+
+#ifndef R_COROUTINE_BACKEND
+#if defined(__x86_64__) && defined(__GNUC__) && defined(__ELF__)
+#define R_COROUTINE_BACKEND R_COROUTINE_ASM
+#elif defined(__unix__) || defined(__APPLE__)
+#define R_COROUTINE_BACKEND R_COROUTINE_UCONTEXT
+#else
+#define R_COROUTINE_BACKEND R_COROUTINE_THREAD
+#endif
+#endif
+
+//default stack of a coroutine on the user-space backends
+#ifndef R_COROUTINE_STACK_SIZE
+#define R_COROUTINE_STACK_SIZE (128 * 1024)
+#endif
+
+//Every backend lives in its own inline namespace, so translation units
+//built with different backends link into one program.
+#if R_COROUTINE_BACKEND == R_COROUTINE_ASM
+#define R_COROUTINE_NAMESPACE coroutine_asm
+#elif R_COROUTINE_BACKEND == R_COROUTINE_UCONTEXT
+#define R_COROUTINE_NAMESPACE coroutine_ucontext
+#include <ucontext.h>
+#elif R_COROUTINE_BACKEND == R_COROUTINE_STACKLESS
+#if !defined(__cpp_impl_coroutine)
+#error "R_COROUTINE_STACKLESS needs a C++20 compiler"
+#endif
+#define R_COROUTINE_NAMESPACE coroutine_stackless
+#else
+#define R_COROUTINE_NAMESPACE coroutine_thread
+#endif
+
+namespace R
+{
+
+//Switching between stacks in user space, without the kernel scheduler.
+//
+//A Handle names a suspended context: the saved stack pointer for the
+//assembly backend, a ucontext_t kept on the suspended stack otherwise.
+//jump() saves the running context into *from and resumes to, handing it
+//data; it returns the data passed by the jump that resumes it again.
+//A context made by make() starts in entry(data) with the data of the
+//first jump into it. entry must never return: it leaves by a last jump.
+namespace context_switch
+{
+
+typedef std::size_t Size;
+typedef void* Handle;
+typedef void (*Entry)(void* data);
+
+//stack tops are kept at this alignment, as the x86-64 ABI requires
+constexpr Size STACK_ALIGN = 16;
+
+inline namespace R_COROUTINE_NAMESPACE
+{
+
+#if R_COROUTINE_BACKEND == R_COROUTINE_ASM
+
+//Pushes the callee-saved registers and the SSE/x87 control words on the
+//running stack, stores the stack pointer in *from (rdi), loads to (rsi)
+//and pops the same frame from it. data (rdx) comes back in rax and rdi,
+//so it is also the first argument of an entry function.
+//
+//Defined at file scope rather than as a naked function, which older GCCs
+//do not support on x86-64, in a COMDAT group so that every translation
+//unit may carry a copy.
+asm(".pushsection .text.R_context_switch_jump,\"axG\",@progbits,"
+		"R_context_switch_jump,comdat\n\t"
+		".weak R_context_switch_jump\n\t"
+		".type R_context_switch_jump, @function\n"
+		"R_context_switch_jump:\n\t"
+		"pushq %rbp\n\t"
+		"pushq %rbx\n\t"
+		"pushq %r12\n\t"
+		"pushq %r13\n\t"
+		"pushq %r14\n\t"
+		"pushq %r15\n\t"
+		"subq $8, %rsp\n\t"
+		"stmxcsr (%rsp)\n\t"
+		"fnstcw 4(%rsp)\n\t"
+		"movq %rsp, (%rdi)\n\t"
+		"movq %rsi, %rsp\n\t"
+		"ldmxcsr (%rsp)\n\t"
+		"fldcw 4(%rsp)\n\t"
+		"addq $8, %rsp\n\t"
+		"popq %r15\n\t"
+		"popq %r14\n\t"
+		"popq %r13\n\t"
+		"popq %r12\n\t"
+		"popq %rbx\n\t"
+		"popq %rbp\n\t"
+		"movq %rdx, %rax\n\t"
+		"movq %rdx, %rdi\n\t"
+		"ret\n\t"
+		".size R_context_switch_jump, .-R_context_switch_jump\n\t"
+		".popsection");
+
+extern "C" void* R_context_switch_jump(Handle* from, Handle to, void* data);
+
+inline void* jump(Handle* from, Handle to, void* data)
+{
+	return R_context_switch_jump(from, to, data);
+}
+
+//Lays out the frame jump() pops: the control words, six zeroed
+//registers, then entry as the return address over a null one, so entry
+//starts with the stack aligned as after a call.
+inline Handle make(void* base, Size size, Entry entry)
+{
+	std::uintptr_t top = ((std::uintptr_t) base + size)
+			& ~(std::uintptr_t) (STACK_ALIGN - 1);
+	void** frame = (void**) top;
+	frame[-1] = nullptr;
+	frame[-2] = (void*) entry;
+	for (Size index = 3; index <= 8; ++index)
+		frame[-(std::ptrdiff_t) index] = nullptr;
+	uint32_t* control = (uint32_t*) (frame - 9);
+	control[0] = 0x1F80; //MXCSR: all exceptions masked, round to nearest
+	control[1] = 0x037F; //x87: the same, extended precision
+	return frame - 9;
+}
+
+#elif R_COROUTINE_BACKEND == R_COROUTINE_UCONTEXT
+
+//a suspended context and the data handed to it when it is resumed
+struct Frame
+{
+	ucontext_t context;
+	void* data;
+	Entry entry;
+};
+
+//makecontext only passes int arguments, so the frame comes in two halves
+inline void start(unsigned int high, unsigned int low)
+{
+	Frame* frame = (Frame*) (((std::uintptr_t) high << 32) | low);
+	frame->entry(frame->data);
+}
+
+inline void* jump(Handle* from, Handle to, void* data)
+{
+	Frame here;
+	*from = &here;
+	Frame* target = (Frame*) to;
+	target->data = data;
+	swapcontext(&here.context, &target->context);
+	return here.data;
+}
+
+//the first frame sits at the top of the stack, below it the entry runs
+inline Handle make(void* base, Size size, Entry entry)
+{
+	std::uintptr_t top = ((std::uintptr_t) base + size - sizeof(Frame))
+			& ~(std::uintptr_t) (STACK_ALIGN - 1);
+	Frame* frame = (Frame*) top;
+	frame->data = nullptr;
+	frame->entry = entry;
+	getcontext(&frame->context);
+	frame->context.uc_stack.ss_sp = base;
+	frame->context.uc_stack.ss_size = top - (std::uintptr_t) base;
+	frame->context.uc_link = nullptr;
+	std::uintptr_t value = (std::uintptr_t) frame;
+	makecontext(&frame->context, (void (*)(void)) start, 2,
+			(unsigned int) (value >> 32), (unsigned int) value);
+	return frame;
+}
+
+#endif
+
+}
+
+}
+
+}
+
+#endif /* INCLUDE_R_CONTEXT_SWITCH_HPP_ */
@@ -15,20 +15,37 @@
 #include <exception>
 #include <cassert>
 #include <functional>
+#include <new>
+#include <type_traits>
+
+#include <R/context_switch.hpp>
+#include <R/memory_allocator.hpp>
+
+//pooled stacks need mmap, which the thread backend does without
+#if R_COROUTINE_BACKEND == R_COROUTINE_STACKLESS
+#include <coroutine>
+#elif R_COROUTINE_BACKEND != R_COROUTINE_THREAD
+#include <R/stack_pool.hpp>
+#endif
 
 namespace R
 {
 
+class InterruptedException
+{
+
+};
+
+inline namespace R_COROUTINE_NAMESPACE
+{
+
 template<typename CallData>
 class CallType;
 
 template<typename YieldData>
 class YieldType;
 
-class InterruptedException
-{
-
-};
+#if R_COROUTINE_BACKEND == R_COROUTINE_THREAD
 
 class Context
 {
@@ -59,6 +76,7 @@ protected:
 		__inner_lock = new std::unique_lock<std::mutex>(*_mutex, std::defer_lock);
 		_is_started = false;
 	}
+	//the thread backend keeps the default thread stack
 	void __start(std::function<void(void)> && body_function)
 	{
 		auto lock = std::unique_lock<std::mutex>(*_mutex, std::defer_lock);
@@ -159,6 +177,377 @@ protected:
 	}
 };
 
+#elif R_COROUTINE_BACKEND == R_COROUTINE_STACKLESS
+
+class Context;
+
+//What the body of a coroutine returns on the stackless backend. Bodies
+//are C++20 coroutines that suspend with co_await yield() and only in
+//their own frame, not in functions they call. Frames come from the
+//Allocator given to the CallType, which leaves it for the frame's
+//operator new right before it invokes the body, with a header behind to
+//give them back.
+class Body
+{
+public:
+	struct promise_type
+	{
+	private:
+		struct Header
+		{
+			Allocator* allocator;
+			Allocator::Aux aux;
+		};
+
+		//the header sits behind the frame
+		static std::size_t header_offset(std::size_t size)
+		{
+			return (size + alignof(Header) - 1) & ~(alignof(Header) - 1);
+		}
+
+		static Header* header(void* frame, std::size_t size)
+		{
+			return (Header*) ((char*) frame + header_offset(size));
+		}
+
+	public:
+		//hands control back to whoever resumed the chain, as a yield
+		struct Final
+		{
+			bool await_ready() const noexcept
+			{
+				return false;
+			}
+
+			void await_suspend(std::coroutine_handle<promise_type> handle) const
+					noexcept;
+
+			void await_resume() const noexcept
+			{
+			}
+		};
+
+		std::exception_ptr exception;
+		Context* context;
+
+		static void* operator new(std::size_t size);
+
+		static void operator delete(void* frame, std::size_t size) noexcept
+		{
+			Header* behind = header(frame, size);
+			behind->allocator->deallocate(behind->aux);
+		}
+
+		Body get_return_object() noexcept
+		{
+			return Body(std::coroutine_handle<promise_type>::from_promise(*this));
+		}
+
+		//the body starts with the first call, as on the other backends
+		std::suspend_always initial_suspend() const noexcept
+		{
+			return std::suspend_always();
+		}
+
+		//kept until the CallType goes, so it can still tell it finished
+		Final final_suspend() const noexcept
+		{
+			return Final();
+		}
+
+		void return_void() const noexcept
+		{
+		}
+
+		void unhandled_exception() noexcept
+		{
+			exception = std::current_exception();
+		}
+	};
+
+	typedef std::coroutine_handle<promise_type> Handle;
+private:
+	Handle _handle;
+
+	explicit Body(Handle handle) noexcept :
+			_handle(handle)
+	{
+	}
+
+public:
+	Body(Body&& other) noexcept :
+			_handle(other._handle)
+	{
+		other._handle = nullptr;
+	}
+
+	Body(const Body&) = delete;
+	Body& operator=(const Body&) = delete;
+
+	~Body()
+	{
+		if (_handle)
+			_handle.destroy();
+	}
+
+	Handle release() noexcept
+	{
+		Handle handle = _handle;
+		_handle = nullptr;
+		return handle;
+	}
+};
+
+//A suspended body is a heap frame of its live locals, and run() is a
+//plain call into it, so nothing but the frame is allocated per coroutine.
+//Destroying a suspended coroutine destroys its frame and the locals in it
+//without resuming it.
+//
+//A transfer resumes the other coroutine from await_suspend, which the
+//compiler turns into a tail call. Every suspension notes its coroutine
+//for this thread, so run() rethrows what the last one of a chain threw.
+class Context
+{
+private:
+	Body::Handle _handle;
+	bool _is_active; //running, or resuming another coroutine
+
+	friend struct Body::promise_type;
+	template<typename> friend class YieldType;
+
+	static Context*& __suspended() noexcept
+	{
+		static thread_local Context* context = nullptr;
+		return context;
+	}
+
+	//for the next frame allocated on this thread, nullptr for the default
+	static Allocator*& __frame_allocator() noexcept
+	{
+		static thread_local Allocator* allocator = nullptr;
+		return allocator;
+	}
+
+	void __leave() noexcept
+	{
+		_is_active = false;
+		__suspended() = this;
+	}
+
+	//Pre: this has not finished and is not on the chain of resumers
+	std::coroutine_handle<> __enter() noexcept
+	{
+		assert(_handle && !_handle.done() && !_is_active);
+		_is_active = true;
+		return _handle;
+	}
+
+protected:
+	Context() noexcept :
+			_handle(nullptr), _is_active(false)
+	{
+	}
+
+	//call right before the body is invoked, so its frame comes from
+	//allocator
+	static void __allocator(Allocator& allocator) noexcept
+	{
+		__frame_allocator() = &allocator;
+	}
+
+	void __start(Body&& body) noexcept
+	{
+		assert(!_handle);
+		_handle = body.release();
+		_handle.promise().context = this;
+	}
+
+	void __destroy() noexcept
+	{
+		if (_handle)
+			_handle.destroy();
+		_handle = nullptr;
+	}
+
+	virtual ~Context() noexcept
+	{
+		__destroy();
+	}
+
+	void run()
+	{
+		assert(_handle && !_is_active);
+		Context* last = this;
+		if (!_handle.done())
+		{
+			__enter().resume();
+			last = __suspended();
+		}
+		if (last->_handle.promise().exception)
+			std::rethrow_exception(last->_handle.promise().exception);
+	}
+
+	bool is_running() noexcept
+	{
+		return is_running_unsafe();
+	}
+
+	bool is_running_unsafe() noexcept
+	{
+		return _handle && !_handle.done();
+	}
+
+	void safe_run(std::function<void(void)> fn) noexcept
+	{
+		fn();
+	}
+};
+
+inline void Body::promise_type::Final::await_suspend(
+		std::coroutine_handle<promise_type> handle) const noexcept
+{
+	handle.promise().context->__leave();
+}
+
+#else
+
+//Runs the body on its own stack in the thread that resumes it. run() and
+//__yield() are plain stack switches, so a round trip costs a few dozen
+//instructions instead of two thread handoffs. Destroying a suspended
+//coroutine resumes it once more with InterruptedException thrown from
+//its yield, which unwinds its stack.
+//
+//__transfer() switches straight to another coroutine, which takes over
+//the resumer of this one: its next yield, or its end, returns there. A
+//switch back passes the coroutine that made it, so run() rethrows what
+//the last coroutine of a chain threw.
+class Context
+{
+public:
+	typedef std::size_t Size;
+private:
+	context_switch::Handle _self; //the coroutine, while suspended
+	context_switch::Handle _caller; //whoever resumed it, while it runs
+	StackPool* _pool;
+	StackPool::Stack _stack;
+	std::function<void(void)> _body;
+	std::exception_ptr _exception;
+	bool _interrupted;
+	bool __inner_finished;
+	bool _is_started;
+	bool _is_entered;
+	bool _is_active; //running, or resuming another coroutine
+
+	static void __entry(void* data)
+	{
+		Context* self = (Context*) data;
+		try
+		{
+			self->_body();
+		}
+		catch (const InterruptedException& e)
+		{
+		}
+		catch (...)
+		{
+			self->_exception = std::current_exception();
+		}
+		self->__inner_finished = true;
+		self->_is_active = false;
+		context_switch::jump(&self->_self, self->_caller, self);
+	}
+
+protected:
+	Context() noexcept :
+			_self(nullptr), _caller(nullptr), _pool(nullptr), _stack(),
+					_interrupted(false), __inner_finished(false),
+					_is_started(false), _is_entered(false), _is_active(false)
+	{
+	}
+
+	void __start(std::function<void(void)> && body_function,
+			Size stack_size, StackPool& pool)
+	{
+		assert(!_is_started);
+		_stack = pool.allocate(stack_size);
+		_pool = &pool;
+		_body = std::move(body_function);
+		_self = context_switch::make(_stack.base, _stack.size, __entry);
+		_is_started = true;
+	}
+
+	virtual ~Context() noexcept
+	{
+		if (_is_entered)
+		{
+			_interrupted = true;
+			while (!__inner_finished)
+			{
+				_is_active = true;
+				context_switch::jump(&_caller, _self, this);
+			}
+		}
+		if (_is_started)
+			_pool->deallocate(_stack);
+	}
+
+	//only a yield back to the resumer of other (this) is supported
+	void __yield(Context* other)
+	{
+		assert(other == this);
+		_is_active = false;
+		context_switch::jump(&_self, _caller, this);
+		if (_interrupted)
+			throw InterruptedException();
+	}
+
+	//Pre: other has not finished and is not on the chain of resumers
+	//that leads here.
+	void __transfer(Context* other)
+	{
+		assert(other != this && other->_is_started);
+		assert(!other->__inner_finished && !other->_is_active);
+		other->_caller = _caller;
+		other->_is_entered = true;
+		other->_is_active = true;
+		_is_active = false;
+		context_switch::jump(&_self, other->_self, other);
+		if (_interrupted)
+			throw InterruptedException();
+	}
+
+	void run()
+	{
+		assert(_is_started && !_is_active);
+		Context* last = this;
+		if (!__inner_finished)
+		{
+			_is_entered = true;
+			_is_active = true;
+			last = (Context*) context_switch::jump(&_caller, _self, this);
+		}
+		if (last->_exception)
+			std::rethrow_exception(last->_exception);
+	}
+
+	bool is_running() noexcept
+	{
+		return is_running_unsafe();
+	}
+
+	bool is_running_unsafe() noexcept
+	{
+		return !this->_interrupted && !this->__inner_finished && this->_is_started;
+	}
+
+	void safe_run(std::function<void(void)> fn) noexcept
+	{
+		fn();
+	}
+};
+
+#endif
+
 template<typename Data>
 struct __data_holder
 {
@@ -175,11 +564,18 @@ template< typename CallData >
 class CallType : public Context
 {
 public:
+#if R_COROUTINE_BACKEND == R_COROUTINE_STACKLESS
+	typedef std::function<R::Body(YieldType<CallData>&)> Body;
+#else
 	typedef std::function<void(YieldType<CallData>&)> Body;
+#endif
 private:
 	bool _not_a_coro;
 	YieldType<CallData>* _child;
 	__data_holder<CallData> _data;
+#if R_COROUTINE_BACKEND == R_COROUTINE_STACKLESS
+	Body _function; //the frame refers to it, the lambda captures in particular
+#endif
 
 public:
 	//not a coro
@@ -189,10 +585,29 @@ public:
 		_child = nullptr;
 	}
 
-	//Creates a coroutine which will execute fn
+#if R_COROUTINE_BACKEND == R_COROUTINE_STACKLESS
+	//Creates a coroutine which will execute fn, a coroutine returning
+	//symmetric_coroutine<CallData>::body_type, in a frame from allocator
+	template<typename Function>
+	CallType(Function && fn, Allocator& allocator = default_allocator()) :
+			CallType()
+	{
+		static_assert(std::is_same<decltype(fn(std::declval<YieldType<CallData>&>())),
+				R::Body>::value, "The body must be a coroutine returning body_type.");
+		_not_a_coro = false;
+		_child = new YieldType<CallData>(this);
+		_function = std::forward<Function>(fn);
+		__allocator(allocator);
+		__start(_function(*_child));
+	}
+#elif R_COROUTINE_BACKEND == R_COROUTINE_THREAD
+	//Creates a coroutine which will execute fn on a thread of its own;
+	//stack_size is accepted for the other backends and ignored
 	template<typename Function>
-	CallType(Function && fn) : CallType()
+	CallType(Function && fn, std::size_t stack_size = R_COROUTINE_STACK_SIZE) :
+			CallType()
     {
+		(void) stack_size;
 		_not_a_coro = false;
     	_child = new YieldType<CallData>(this);
 
@@ -200,9 +615,28 @@ public:
     		fn(*_child);
     	});
     }
+#else
+	//Creates a coroutine which will execute fn on a stack of at least
+	//stack_size bytes taken from pool
+	template<typename Function>
+	CallType(Function && fn, std::size_t stack_size = R_COROUTINE_STACK_SIZE,
+			StackPool& pool = default_stack_pool()) : CallType()
+    {
+		_not_a_coro = false;
+    	_child = new YieldType<CallData>(this);
+
+    	__start([this,fn](){
+    		fn(*_child);
+    	}, stack_size, pool);
+    }
+#endif
 
     virtual ~CallType()
     {
+#if R_COROUTINE_BACKEND == R_COROUTINE_STACKLESS
+    	//the frame goes first: its locals may refer to the captures
+    	this->__destroy();
+#endif
     	delete _child;
     }
 
@@ -244,7 +678,7 @@ public:
 
 private:
 
-    friend class YieldType<CallData>;
+    template<typename> friend class YieldType;
 };
 
 template< typename YieldData >
@@ -291,6 +725,75 @@ public:
 		}
 	}
 
+#if R_COROUTINE_BACKEND == R_COROUTINE_STACKLESS
+    //Pre: *this is not a not-a-coroutine.
+    //co_await yield() transfers execution control back to the caller.
+    [[nodiscard]] YieldType& operator()()
+    {
+    	return *this;
+    }
+
+    bool await_ready() const noexcept
+    {
+    	return false;
+    }
+
+    void await_suspend(std::coroutine_handle<>) const noexcept
+    {
+    	_parent->__leave();
+    }
+
+    void await_resume() const noexcept
+    {
+    }
+
+    //what co_await yield(other, x) waits on
+    class Transfer
+    {
+    private:
+    	Context* _from;
+    	Context* _to;
+    public:
+    	Transfer(Context* from, Context* to) noexcept :
+    			_from(from), _to(to)
+    	{
+    	}
+
+    	bool await_ready() const noexcept
+    	{
+    		return false;
+    	}
+
+    	std::coroutine_handle<> await_suspend(std::coroutine_handle<>) const
+    			noexcept
+    	{
+    		_from->__leave();
+    		return _to->__enter();
+    	}
+
+    	void await_resume() const noexcept
+    	{
+    	}
+    };
+
+    //Pre: *this is not a not-a-coroutine, other has not finished and is
+    //not on the chain of resumers.
+    //co_await yield(other, x) transfers execution control straight to
+    //other, passing x; other's next co_await yield() returns to whoever
+    //resumed this coroutine.
+    template< typename X >
+    [[nodiscard]] Transfer operator()(CallType<X>& other,
+    		const typename std::common_type<X>::type& x)
+    {
+    	other._data.value = x;
+    	return Transfer(_parent, &other);
+    }
+
+    [[nodiscard]] Transfer operator()(CallType<void>& other)
+    {
+    	return Transfer(_parent, &other);
+    }
+#else
     //Pre: *this is not a not-a-coroutine.
     //Execution control is transferred to coroutine-function
     //(no parameter is passed to the coroutine-function).
@@ -300,20 +803,27 @@ public:
     	return *this;
     }
 
-#ifdef __NOT_VERIFIED
+#if R_COROUTINE_BACKEND != R_COROUTINE_THREAD
+    //Pre: *this is not a not-a-coroutine, other has not finished and is
+    //not on the chain of resumers.
+    //Execution control is transferred straight to other, which gets x,
+    //without going back through the caller. other's next yield returns to
+    //whoever resumed this coroutine; this one goes on when it is resumed.
     template< typename X >
-    YieldType& operator()( CallType<X> & other, X & x)
+    YieldType& operator()(CallType<X>& other,
+    		const typename std::common_type<X>::type& x)
     {
     	other._data.value = x;
-    	_parent->__yield(&other);
+    	_parent->__transfer(&other);
     	return *this;
     }
 
-    YieldType& operator()( CallType<void> & other)
+    YieldType& operator()(CallType<void>& other)
     {
-    	_parent->__yield(&other);
+    	_parent->__transfer(&other);
     	return *this;
     }
+#endif
 #endif
 
     //Pre: *this is not a not-a-coroutine.
@@ -325,16 +835,42 @@ public:
     }
 
     friend class CallType<YieldData>;
+#if R_COROUTINE_BACKEND == R_COROUTINE_STACKLESS
+    friend struct Body::promise_type;
+#endif
 };
 
+#if R_COROUTINE_BACKEND == R_COROUTINE_STACKLESS
+inline void* Body::promise_type::operator new(std::size_t size)
+{
+	Allocator*& slot = Context::__frame_allocator();
+	Allocator& allocator = slot != nullptr ? *slot : default_allocator();
+	slot = nullptr;
+	Allocator::Ptr frame = Allocator::NullPtr;
+	Allocator::Aux aux = allocate_aligned(allocator,
+			header_offset(size) + sizeof(Header),
+			__STDCPP_DEFAULT_NEW_ALIGNMENT__, frame);
+	if (frame == Allocator::NullPtr)
+		throw std::bad_alloc();
+	header(frame, size)->allocator = &allocator;
+	header(frame, size)->aux = aux;
+	return frame;
+}
+#endif
+
 template<typename T>
 struct symmetric_coroutine
 {
 	typedef CallType<T> call_type;
 	typedef YieldType<T> yield_type;
+#if R_COROUTINE_BACKEND == R_COROUTINE_STACKLESS
+	typedef Body body_type;
+#endif
 };
 
 }
 
+}
+
 
 #endif /* INCLUDE_R_COROUTINE_HPP_ */
@@ -0,0 +1,344 @@
+/*
+ * count_min_sketch.hpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef INCLUDE_R_COUNT_MIN_SKETCH_HPP_
+#define INCLUDE_R_COUNT_MIN_SKETCH_HPP_
+
+#include <cstdint>
+#include <cmath>
+#include <cassert>
+#include <atomic>
+#include <algorithm>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+#include <R/bit_kernel.hpp>
+#include <R/bit_vector.hpp>
+#include <R/hash_batch.hpp>
+#include <R/memory_allocator.hpp>
+
+namespace R
+{
+
+//Row layout shared by the plain and atomic sketches. Every row is padded
+//to whole cache lines of counters and the column of a key in row r is
+//derived from one mixed hash by double hashing (h1 + r * h2).
+namespace count_min_row
+{
+
+typedef std::size_t Size;
+
+//counters per row, rounded up to whole cache lines
+template<typename Counter>
+constexpr Size stride_for(Size width)
+{
+	return (width * sizeof(Counter) + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE
+			* CACHE_LINE_SIZE / sizeof(Counter);
+}
+
+//column in [0, width) without a division
+inline Size column(uint64_t hash, Size row, Size width)
+{
+	uint32_t h1 = (uint32_t) hash;
+	uint32_t h2 = (uint32_t) (hash >> 32) | 1;
+	return (Size) (((uint64_t) (uint32_t) (h1 + (uint32_t) row * h2)
+			* (uint64_t) width) >> 32);
+}
+
+//width = ceil(e / epsilon): overestimates stay below epsilon * total
+inline Size width_for(double epsilon)
+{
+	return (Size) std::ceil(std::exp(1.0) / epsilon);
+}
+
+//depth = ceil(ln(1 / delta)): the bound holds with probability 1 - delta
+inline Size depth_for(double delta)
+{
+	return std::max<Size>(1, (Size) std::ceil(std::log(1.0 / delta)));
+}
+
+//Counter-wise add in cache-line blocks; the fixed-count inner loop is
+//vectorized by the compiler.
+template<typename Counter>
+inline void add_counters(Counter* __restrict dst, const Counter* __restrict src,
+		Size counters)
+{
+	const Size BLOCK = CACHE_LINE_SIZE / sizeof(Counter);
+	for (Size index = 0; index < counters; index += BLOCK)
+		for (Size k = 0; k < BLOCK; ++k)
+			dst[index + k] += src[index + k];
+}
+
+#ifdef R_BIT_KERNEL_AVX2
+template<typename Counter>
+__attribute__((target("avx2")))
+inline void add_counters_avx2(Counter* __restrict dst,
+		const Counter* __restrict src, Size counters)
+{
+	const Size BLOCK = CACHE_LINE_SIZE / sizeof(Counter);
+	for (Size index = 0; index < counters; index += BLOCK)
+		for (Size k = 0; k < BLOCK; ++k)
+			dst[index + k] += src[index + k];
+}
+#endif
+
+//counters must be a multiple of a cache line
+template<typename Counter>
+inline void add(Counter* dst, const Counter* src, Size counters)
+{
+#ifdef R_BIT_KERNEL_AVX2
+	if (bit_kernel::use_avx2())
+	{
+		add_counters_avx2(dst, src, counters);
+		return;
+	}
+#endif
+	add_counters(dst, src, counters);
+}
+
+}
+
+//Count-min sketch of depth rows by width counters. estimate(key) never
+//underestimates the total added for key. Counters live in the buckets of
+//a BitVector<Counter>, one counter per bucket, and wrap on overflow.
+template<typename Counter = uint32_t>
+class CountMinSketch
+{
+	static_assert(std::is_unsigned<Counter>::value, "Unsigned type required.");
+public:
+	typedef std::size_t Size;
+private:
+	Size _width;
+	Size _depth;
+	Size _stride;
+	BitVector<Counter> _counters;
+
+	template<typename Type>
+	friend class AtomicCountMinSketch;
+
+	Counter* row(Size index)
+	{
+		return _counters.data() + index * _stride;
+	}
+
+	const Counter* row(Size index) const
+	{
+		return _counters.data() + index * _stride;
+	}
+
+	void add_hash(uint64_t hash, Counter count)
+	{
+		for (Size index = 0; index < _depth; ++index)
+			row(index)[count_min_row::column(hash, index, _width)] += count;
+	}
+
+	Counter estimate_hash(uint64_t hash) const
+	{
+		Counter found = std::numeric_limits<Counter>::max();
+		for (Size index = 0; index < _depth; ++index)
+			found = std::min(found,
+					row(index)[count_min_row::column(hash, index, _width)]);
+		return found;
+	}
+
+	void prefetch_hash(uint64_t hash, bool write) const
+	{
+		for (Size index = 0; index < _depth; ++index)
+			hash_batch::prefetch(
+					row(index) + count_min_row::column(hash, index, _width),
+					write);
+	}
+
+public:
+	CountMinSketch(Size width, Size depth,
+			Allocator& allocator = default_allocator()) :
+			_width(std::max<Size>(1, width)), _depth(std::max<Size>(1, depth)),
+					_stride(count_min_row::stride_for<Counter>(_width)),
+					_counters(0, false, allocator)
+	{
+		_counters.resize(_depth * _stride * sizeof(Counter) * 8);
+	}
+
+	Size width() const
+	{
+		return _width;
+	}
+
+	Size depth() const
+	{
+		return _depth;
+	}
+
+	void clear()
+	{
+		_counters.clear();
+	}
+
+	void add(uint64_t key, Counter count = 1)
+	{
+		add_hash(hash_batch::mix(key), count);
+	}
+
+	Counter estimate(uint64_t key) const
+	{
+		return estimate_hash(hash_batch::mix(key));
+	}
+
+	//Adds increment to every key a batch at a time, prefetching the
+	//counters of the batch first.
+	void add_many(const uint64_t* keys, Size count, Counter increment = 1)
+	{
+		hash_batch::for_each_batch(keys, count, [this](uint64_t hash)
+		{
+			prefetch_hash(hash, true);
+		}, [this, increment](Size, uint64_t hash)
+		{
+			add_hash(hash, increment);
+		});
+	}
+
+	//Writes estimate(keys[i]) to results[i].
+	void estimate_many(const uint64_t* keys, Size count, Counter* results) const
+	{
+		hash_batch::for_each_batch(keys, count, [this](uint64_t hash)
+		{
+			prefetch_hash(hash, false);
+		}, [this, results](Size index, uint64_t hash)
+		{
+			results[index] = estimate_hash(hash);
+		});
+	}
+
+	//sum of the two streams; dimensions must match
+	void merge(const CountMinSketch& other)
+	{
+		assert(_width == other._width && _depth == other._depth);
+		count_min_row::add(_counters.data(), other._counters.data(),
+				_depth * _stride);
+	}
+};
+
+//Count-min sketch accepting concurrent adds with relaxed fetch_add.
+//Estimates taken during updates may miss adds still in flight.
+template<typename Counter = uint32_t>
+class AtomicCountMinSketch
+{
+	static_assert(std::is_unsigned<Counter>::value, "Unsigned type required.");
+public:
+	typedef std::size_t Size;
+private:
+	Size _width;
+	Size _depth;
+	Size _stride;
+	Allocator* _allocator;
+	Allocator::Aux _aux;
+	std::atomic<Counter>* _counters;
+
+	Size counters() const
+	{
+		return _depth * _stride;
+	}
+
+	std::atomic<Counter>* slot(uint64_t hash, Size row) const
+	{
+		return _counters + row * _stride
+				+ count_min_row::column(hash, row, _width);
+	}
+
+	void add_hash(uint64_t hash, Counter count, std::memory_order order)
+	{
+		for (Size row = 0; row < _depth; ++row)
+			slot(hash, row)->fetch_add(count, order);
+	}
+
+public:
+	AtomicCountMinSketch(Size width, Size depth,
+			Allocator& allocator = default_allocator()) :
+			_width(std::max<Size>(1, width)), _depth(std::max<Size>(1, depth)),
+					_stride(count_min_row::stride_for<Counter>(_width)),
+					_allocator(&allocator), _aux(Allocator::NullPtr),
+					_counters(nullptr)
+	{
+		Allocator::Ptr addr = Allocator::NullPtr;
+		_aux = allocate_aligned(allocator,
+				counters() * sizeof(std::atomic<Counter>), CACHE_LINE_SIZE, addr);
+		if (addr == Allocator::NullPtr)
+			throw std::bad_alloc();
+		_counters = (std::atomic<Counter>*) addr;
+		for (Size index = 0; index < counters(); ++index)
+			new (_counters + index) std::atomic<Counter>(0);
+	}
+
+	AtomicCountMinSketch(const AtomicCountMinSketch&) = delete;
+	AtomicCountMinSketch& operator=(const AtomicCountMinSketch&) = delete;
+
+	~AtomicCountMinSketch()
+	{
+		_allocator->deallocate(_aux);
+	}
+
+	Size width() const
+	{
+		return _width;
+	}
+
+	Size depth() const
+	{
+		return _depth;
+	}
+
+	//not safe against concurrent adds
+	void clear()
+	{
+		for (Size index = 0; index < counters(); ++index)
+			_counters[index].store(0, std::memory_order_relaxed);
+	}
+
+	void add(uint64_t key, Counter count = 1,
+			std::memory_order order = std::memory_order_relaxed)
+	{
+		add_hash(hash_batch::mix(key), count, order);
+	}
+
+	void add_many(const uint64_t* keys, Size count, Counter increment = 1,
+			std::memory_order order = std::memory_order_relaxed)
+	{
+		hash_batch::for_each_batch(keys, count, [this](uint64_t hash)
+		{
+			for (Size row = 0; row < _depth; ++row)
+				hash_batch::prefetch(slot(hash, row), true);
+		}, [this, increment, order](Size, uint64_t hash)
+		{
+			add_hash(hash, increment, order);
+		});
+	}
+
+	Counter estimate(uint64_t key,
+			std::memory_order order = std::memory_order_relaxed) const
+	{
+		uint64_t hash = hash_batch::mix(key);
+		Counter found = std::numeric_limits<Counter>::max();
+		for (Size row = 0; row < _depth; ++row)
+			found = std::min(found, slot(hash, row)->load(order));
+		return found;
+	}
+
+	//copies the current counters into a plain sketch
+	CountMinSketch<Counter> snapshot(Allocator& allocator =
+			default_allocator()) const
+	{
+		CountMinSketch<Counter> copy(_width, _depth, allocator);
+		Counter* counters = copy._counters.data();
+		for (Size index = 0; index < this->counters(); ++index)
+			counters[index] = _counters[index].load(std::memory_order_relaxed);
+		return copy;
+	}
+};
+
+}
+
+#endif /* INCLUDE_R_COUNT_MIN_SKETCH_HPP_ */
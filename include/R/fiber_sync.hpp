@@ -0,0 +1,615 @@
+/*
+ * fiber_sync.hpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef INCLUDE_R_FIBER_SYNC_HPP_
+#define INCLUDE_R_FIBER_SYNC_HPP_
+
+#include <cstdint>
+#include <cassert>
+#include <cstddef>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include <R/scheduler.hpp>
+
+namespace R
+{
+
+inline namespace R_COROUTINE_NAMESPACE
+{
+
+//Building blocks of the primitives that suspend fibers instead of
+//blocking their worker thread.
+namespace fiber_sync
+{
+
+typedef std::size_t Size;
+
+//Test-and-test-and-set lock over the few instructions that touch a wait
+//list. It has no owner, so a fiber may take it and the worker release it
+//after the fiber switched out. Spinners yield the thread now and then, in
+//case the holder was preempted.
+class SpinLock
+{
+private:
+	std::atomic<bool> _locked;
+
+	static void pause()
+	{
+#if defined(__x86_64__) || defined(__i386__)
+		__builtin_ia32_pause();
+#endif
+	}
+
+public:
+	SpinLock() :
+			_locked(false)
+	{
+	}
+
+	SpinLock(const SpinLock&) = delete;
+	SpinLock& operator=(const SpinLock&) = delete;
+
+	void lock()
+	{
+		Size spins = 0;
+		while (_locked.exchange(true, std::memory_order_acquire))
+			while (_locked.load(std::memory_order_relaxed))
+			{
+				if (++spins % 64 == 0)
+					std::this_thread::yield();
+				else
+					pause();
+			}
+	}
+
+	bool try_lock()
+	{
+		return !_locked.load(std::memory_order_relaxed)
+				&& !_locked.exchange(true, std::memory_order_acquire);
+	}
+
+	void unlock()
+	{
+		_locked.store(false, std::memory_order_release);
+	}
+};
+
+//a thread outside of fibers sleeping in park()
+struct Blocker
+{
+	std::mutex mutex;
+	std::condition_variable cv;
+	bool woken;
+
+	Blocker() :
+			woken(false)
+	{
+	}
+};
+
+//A fiber or thread waiting in the list of a primitive. It lives on the
+//waiter's stack until it is woken, so wakers read what they need first.
+struct Waiter
+{
+	Waiter* prev;
+	Waiter* next;
+	Fiber* fiber;
+	Blocker* blocker; //instead of fiber outside of fibers
+	void* value; //channels: the value to send or the slot to receive into
+	std::atomic<void*>* winner; //shared by the waiters of one wait
+	Size index; //the select case
+	bool ok; //set by the waker: the operation completed
+	bool linked;
+
+	Waiter() :
+			prev(nullptr), next(nullptr), fiber(nullptr), blocker(nullptr),
+					value(nullptr), winner(nullptr), index(0), ok(true),
+					linked(false)
+	{
+	}
+
+	//The waiters of a select, or one with a deadline, may only be taken
+	//by one waker or the timeout; the others find them claimed and drop
+	//them.
+	bool claim()
+	{
+		void* none = nullptr;
+		return winner == nullptr
+				|| winner->compare_exchange_strong(none, (void*) this,
+						std::memory_order_acq_rel);
+	}
+};
+
+//FIFO of waiters, guarded by the lock of its primitive
+class WaitList
+{
+private:
+	Waiter* _head;
+	Waiter* _tail;
+public:
+	WaitList() :
+			_head(nullptr), _tail(nullptr)
+	{
+	}
+
+	bool empty() const
+	{
+		return _head == nullptr;
+	}
+
+	void push(Waiter* waiter)
+	{
+		waiter->prev = _tail;
+		waiter->next = nullptr;
+		waiter->linked = true;
+		if (_tail != nullptr)
+			_tail->next = waiter;
+		else
+			_head = waiter;
+		_tail = waiter;
+	}
+
+	void remove(Waiter* waiter)
+	{
+		assert(waiter->linked);
+		if (waiter->prev != nullptr)
+			waiter->prev->next = waiter->next;
+		else
+			_head = waiter->next;
+		if (waiter->next != nullptr)
+			waiter->next->prev = waiter->prev;
+		else
+			_tail = waiter->prev;
+		waiter->prev = waiter->next = nullptr;
+		waiter->linked = false;
+	}
+
+	//the first waiter that could be claimed, nullptr if none
+	Waiter* pop()
+	{
+		while (_head != nullptr)
+		{
+			Waiter* waiter = _head;
+			remove(waiter);
+			if (waiter->claim())
+				return waiter;
+		}
+		return nullptr;
+	}
+
+	//every waiter that could be claimed, chained through next in order
+	Waiter* pop_all()
+	{
+		Waiter* first = nullptr;
+		Waiter* last = nullptr;
+		while (Waiter* waiter = pop())
+		{
+			if (last != nullptr)
+				last->next = waiter;
+			else
+				first = waiter;
+			last = waiter;
+		}
+		return first;
+	}
+};
+
+//Parks the caller until all of its count waiters are woken once. They
+//must already be filed under the primitives' locks, which unlock()
+//releases as soon as the caller can be woken: on the worker after a fiber
+//switched out, before sleeping on a condition variable otherwise. The
+//caller may be running again as soon as the first of those locks is
+//released, so unlock() must touch nothing of the caller's after it.
+template<typename Unlock>
+inline void park(Waiter* waiters, Size count, Unlock && unlock)
+{
+	if (Scheduler::current() != nullptr)
+	{
+		Scheduler::suspend([waiters, count, &unlock](Fiber* self)
+		{
+			for (Size index = 0; index < count; ++index)
+				waiters[index].fiber = self;
+			unlock();
+		});
+		return;
+	}
+	Blocker blocker;
+	for (Size index = 0; index < count; ++index)
+		waiters[index].blocker = &blocker;
+	unlock();
+	std::unique_lock<std::mutex> lock(blocker.mutex);
+	blocker.cv.wait(lock, [&blocker]()
+	{
+		return blocker.woken;
+	});
+}
+
+template<typename Unlock>
+inline void park(Waiter& waiter, Unlock && unlock)
+{
+	park(&waiter, 1, std::forward<Unlock>(unlock));
+}
+
+//park() until deadline at the latest, for waiters sharing a winner. True
+//if one of them was claimed by a waker, false if the timeout won; the
+//caller then takes the waiters still linked off their lists. A fiber may
+//time out before a copy of unlock has run, so unlock must be copyable and
+//what it refers to must outlive the caller taking the locks back.
+template<typename Unlock>
+inline bool park_until(Waiter* waiters, Size count, Unlock && unlock,
+		Scheduler::Clock::time_point deadline)
+{
+	std::atomic<void*>* winner = waiters[0].winner;
+	assert(winner != nullptr);
+	if (Fiber* fiber = Scheduler::current())
+	{
+		Scheduler& scheduler = fiber->scheduler();
+		Scheduler::Alarm alarm;
+		alarm.winner = winner;
+		//Armed before the locks go, so no waker can resume the fiber
+		//before the alarm is in place to be disarmed. The alarm itself may
+		//resume it at once, ending this frame and the hook with it, so the
+		//hook copies unlock onto the worker's stack before arming.
+		Scheduler::suspend([&](Fiber* self)
+		{
+			for (Size index = 0; index < count; ++index)
+				waiters[index].fiber = self;
+			alarm.fiber = self;
+			typename std::decay<Unlock>::type release(unlock);
+			scheduler.arm(alarm, deadline);
+			release();
+		});
+		if (winner->load(std::memory_order_acquire) == (void*) &alarm)
+			return false;
+		scheduler.disarm(alarm);
+		return true;
+	}
+	Blocker blocker;
+	for (Size index = 0; index < count; ++index)
+		waiters[index].blocker = &blocker;
+	unlock();
+	std::unique_lock<std::mutex> lock(blocker.mutex);
+	if (blocker.cv.wait_until(lock, deadline, [&blocker]()
+	{
+		return blocker.woken;
+	}))
+		return true;
+	void* none = nullptr;
+	if (winner->compare_exchange_strong(none, (void*) &blocker,
+			std::memory_order_acq_rel))
+		return false;
+	//a waker got there first and is about to wake this thread
+	blocker.cv.wait(lock, [&blocker]()
+	{
+		return blocker.woken;
+	});
+	return true;
+}
+
+//park_until() for one waiter filed in list under lock. On timeout the
+//waiter is taken off list again.
+template<typename Unlock>
+inline bool park_until(Waiter& waiter, WaitList& list, SpinLock& lock,
+		Unlock && unlock, Scheduler::Clock::time_point deadline)
+{
+	std::atomic<void*> winner(nullptr);
+	waiter.winner = &winner;
+	if (park_until(&waiter, 1, std::forward<Unlock>(unlock), deadline))
+		return true;
+	std::lock_guard<SpinLock> guard(lock);
+	if (waiter.linked)
+		list.remove(&waiter);
+	return false;
+}
+
+//resumes a waiter taken off its list; call with no lock held
+inline void wake(Waiter* waiter)
+{
+	Fiber* fiber = waiter->fiber;
+	if (fiber != nullptr)
+	{
+		Scheduler::ready(fiber);
+		return;
+	}
+	Blocker* blocker = waiter->blocker;
+	std::lock_guard<std::mutex> lock(blocker->mutex);
+	blocker->woken = true;
+	blocker->cv.notify_one();
+}
+
+//wakes a chain made by WaitList::pop_all
+inline void wake_all(Waiter* waiter)
+{
+	while (waiter != nullptr)
+	{
+		Waiter* next = waiter->next;
+		wake(waiter);
+		waiter = next;
+	}
+}
+
+}
+
+//Mutex for fibers. A fiber that finds it locked is suspended in a FIFO
+//and the worker runs other fibers; unlock() hands the mutex straight to
+//the first waiter. Unlike std::mutex it may be held across suspensions
+//and unlocked from another thread than the one that locked it. Threads
+//outside of fibers may use it too, and block.
+class CoMutex
+{
+private:
+	fiber_sync::SpinLock _lock;
+	fiber_sync::WaitList _waiters;
+	bool _locked;
+public:
+	CoMutex() :
+			_locked(false)
+	{
+	}
+
+	CoMutex(const CoMutex&) = delete;
+	CoMutex& operator=(const CoMutex&) = delete;
+
+	void lock()
+	{
+		_lock.lock();
+		if (!_locked)
+		{
+			_locked = true;
+			_lock.unlock();
+			return;
+		}
+		fiber_sync::Waiter waiter;
+		_waiters.push(&waiter);
+		fiber_sync::park(waiter, [this]()
+		{
+			_lock.unlock();
+		});
+		//the mutex was handed over by unlock()
+	}
+
+	bool try_lock()
+	{
+		std::lock_guard<fiber_sync::SpinLock> lock(_lock);
+		if (_locked)
+			return false;
+		_locked = true;
+		return true;
+	}
+
+	//false if the mutex could not be had by deadline
+	bool try_lock_until(Scheduler::Clock::time_point deadline)
+	{
+		_lock.lock();
+		if (!_locked)
+		{
+			_locked = true;
+			_lock.unlock();
+			return true;
+		}
+		fiber_sync::Waiter waiter;
+		_waiters.push(&waiter);
+		return fiber_sync::park_until(waiter, _waiters, _lock, [this]()
+		{
+			_lock.unlock();
+		}, deadline);
+	}
+
+	template<typename Rep, typename Period>
+	bool try_lock_for(const std::chrono::duration<Rep, Period>& duration)
+	{
+		return try_lock_until(Scheduler::Clock::now()
+				+ std::chrono::duration_cast<Scheduler::Clock::duration>(duration));
+	}
+
+	void unlock()
+	{
+		_lock.lock();
+		assert(_locked);
+		fiber_sync::Waiter* next = _waiters.pop();
+		if (next == nullptr)
+			_locked = false;
+		_lock.unlock();
+		if (next != nullptr)
+			fiber_sync::wake(next);
+	}
+};
+
+//Condition variable for fibers, over any lock with lock() and unlock()
+//such as CoMutex or std::unique_lock<CoMutex>, as
+//std::condition_variable_any. Wake-ups are FIFO and never spurious.
+class CoCondition
+{
+private:
+	fiber_sync::SpinLock _lock;
+	fiber_sync::WaitList _waiters;
+public:
+	CoCondition()
+	{
+	}
+
+	CoCondition(const CoCondition&) = delete;
+	CoCondition& operator=(const CoCondition&) = delete;
+
+	//releases lock while waiting and takes it again before returning
+	template<typename Lock>
+	void wait(Lock& lock)
+	{
+		fiber_sync::Waiter waiter;
+		_lock.lock();
+		_waiters.push(&waiter);
+		//the waiter may resume once _lock is released, so lock goes first
+		fiber_sync::park(waiter, [this, &lock]()
+		{
+			lock.unlock();
+			_lock.unlock();
+		});
+		lock.lock();
+	}
+
+	template<typename Lock, typename Predicate>
+	void wait(Lock& lock, Predicate predicate)
+	{
+		while (!predicate())
+			wait(lock);
+	}
+
+	template<typename Lock>
+	std::cv_status wait_until(Lock& lock, Scheduler::Clock::time_point deadline)
+	{
+		fiber_sync::Waiter waiter;
+		_lock.lock();
+		_waiters.push(&waiter);
+		bool woken = fiber_sync::park_until(waiter, _waiters, _lock,
+				[this, &lock]()
+				{
+					lock.unlock();
+					_lock.unlock();
+				}, deadline);
+		lock.lock();
+		return woken ? std::cv_status::no_timeout : std::cv_status::timeout;
+	}
+
+	//the predicate, at deadline if it is still false
+	template<typename Lock, typename Predicate>
+	bool wait_until(Lock& lock, Scheduler::Clock::time_point deadline,
+			Predicate predicate)
+	{
+		while (!predicate())
+			if (wait_until(lock, deadline) == std::cv_status::timeout)
+				return predicate();
+		return true;
+	}
+
+	template<typename Lock, typename Rep, typename Period>
+	std::cv_status wait_for(Lock& lock,
+			const std::chrono::duration<Rep, Period>& duration)
+	{
+		return wait_until(lock, Scheduler::Clock::now()
+				+ std::chrono::duration_cast<Scheduler::Clock::duration>(duration));
+	}
+
+	template<typename Lock, typename Rep, typename Period, typename Predicate>
+	bool wait_for(Lock& lock, const std::chrono::duration<Rep, Period>& duration,
+			Predicate predicate)
+	{
+		return wait_until(lock, Scheduler::Clock::now()
+				+ std::chrono::duration_cast<Scheduler::Clock::duration>(duration),
+				predicate);
+	}
+
+	void notify_one()
+	{
+		_lock.lock();
+		fiber_sync::Waiter* waiter = _waiters.pop();
+		_lock.unlock();
+		if (waiter != nullptr)
+			fiber_sync::wake(waiter);
+	}
+
+	void notify_all()
+	{
+		_lock.lock();
+		fiber_sync::Waiter* waiters = _waiters.pop_all();
+		_lock.unlock();
+		fiber_sync::wake_all(waiters);
+	}
+};
+
+//Counts outstanding work, as Go's sync.WaitGroup: add() before starting
+//it, done() when each piece finishes, and wait() suspends until the count
+//is back to zero.
+class WaitGroup
+{
+public:
+	typedef std::size_t Size;
+private:
+	fiber_sync::SpinLock _lock;
+	fiber_sync::WaitList _waiters;
+	std::ptrdiff_t _count;
+public:
+	explicit WaitGroup(Size count = 0) :
+			_count((std::ptrdiff_t) count)
+	{
+	}
+
+	WaitGroup(const WaitGroup&) = delete;
+	WaitGroup& operator=(const WaitGroup&) = delete;
+
+	void add(std::ptrdiff_t delta = 1)
+	{
+		_lock.lock();
+		_count += delta;
+		assert(_count >= 0);
+		fiber_sync::Waiter* waiters =
+				_count == 0 ? _waiters.pop_all() : nullptr;
+		_lock.unlock();
+		fiber_sync::wake_all(waiters);
+	}
+
+	void done()
+	{
+		add(-1);
+	}
+
+	void wait()
+	{
+		_lock.lock();
+		if (_count == 0)
+		{
+			_lock.unlock();
+			return;
+		}
+		fiber_sync::Waiter waiter;
+		_waiters.push(&waiter);
+		fiber_sync::park(waiter, [this]()
+		{
+			_lock.unlock();
+		});
+	}
+
+	//false if the count was not down to zero by deadline
+	bool wait_until(Scheduler::Clock::time_point deadline)
+	{
+		_lock.lock();
+		if (_count == 0)
+		{
+			_lock.unlock();
+			return true;
+		}
+		fiber_sync::Waiter waiter;
+		_waiters.push(&waiter);
+		return fiber_sync::park_until(waiter, _waiters, _lock, [this]()
+		{
+			_lock.unlock();
+		}, deadline);
+	}
+
+	template<typename Rep, typename Period>
+	bool wait_for(const std::chrono::duration<Rep, Period>& duration)
+	{
+		return wait_until(Scheduler::Clock::now()
+				+ std::chrono::duration_cast<Scheduler::Clock::duration>(duration));
+	}
+
+	Size count()
+	{
+		std::lock_guard<fiber_sync::SpinLock> lock(_lock);
+		return (Size) _count;
+	}
+};
+
+}
+
+}
+
+#endif /* INCLUDE_R_FIBER_SYNC_HPP_ */
@@ -0,0 +1,72 @@
+/*
+ * hash_batch.hpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef INCLUDE_R_HASH_BATCH_HPP_
+#define INCLUDE_R_HASH_BATCH_HPP_
+
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+namespace R
+{
+
+//Key mixing and batched, prefetched probing shared by the hashed
+//structures (BloomFilter, HyperLogLog, CountMinSketch).
+namespace hash_batch
+{
+
+typedef std::size_t Size;
+
+//murmur3 finalizer, spreads weak hashes such as small integers
+inline uint64_t mix(uint64_t hash)
+{
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdULL;
+	hash ^= hash >> 33;
+	hash *= 0xc4ceb9fe1a85ec53ULL;
+	hash ^= hash >> 33;
+	return hash;
+}
+
+inline void prefetch(const void* address, bool write = false)
+{
+#if defined(__GNUC__)
+	if (write)
+		__builtin_prefetch(address, 1);
+	else
+		__builtin_prefetch(address, 0);
+#else
+	(void) address;
+	(void) write;
+#endif
+}
+
+//Mixes keys one batch at a time, calls touch(hash) for the whole batch so
+//its cache misses overlap, then update(index, hash) for every key.
+template<typename Touch, typename Update>
+inline void for_each_batch(const uint64_t* keys, Size count, Touch && touch,
+		Update && update)
+{
+	const Size BATCH = 32;
+	uint64_t hashes[BATCH];
+	for (Size first = 0; first < count; first += BATCH)
+	{
+		Size length = std::min(BATCH, count - first);
+		for (Size k = 0; k < length; ++k)
+			hashes[k] = mix(keys[first + k]);
+		for (Size k = 0; k < length; ++k)
+			touch(hashes[k]);
+		for (Size k = 0; k < length; ++k)
+			update(first + k, hashes[k]);
+	}
+}
+
+}
+
+}
+
+#endif /* INCLUDE_R_HASH_BATCH_HPP_ */
@@ -0,0 +1,284 @@
+/*
+ * hierarchical_bitmap.hpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef INCLUDE_R_HIERARCHICAL_BITMAP_HPP_
+#define INCLUDE_R_HIERARCHICAL_BITMAP_HPP_
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+#include <R/bit_algorithm.hpp>
+#include <R/bit_vector.hpp>
+#include <R/memory_allocator.hpp>
+
+namespace R
+{
+
+//BitVector with 64-ary "any set" and "any clear" summary levels on top.
+//Bit j of summary level L says whether word j of level L - 1 (the leaf for
+//L == 0) has a set bit (resp. a clear bit), so searches touch one word per
+//level instead of scanning the leaf.
+class HierarchicalBitmap
+{
+public:
+	typedef std::size_t Size;
+	typedef uint64_t Word;
+	typedef BitVector<Word> Level;
+private:
+	typedef BitAlgorithm<Word> Algorithm;
+
+	Level _leaf;
+	std::vector<Level> _any_set;
+	std::vector<Level> _any_clear;
+
+	constexpr static Size BIT_COUNT()
+	{
+		return Algorithm::BIT_COUNT();
+	}
+
+	//leaf word with the bits past size() reported as set
+	Word full_word(Size index) const
+	{
+		Word word = _leaf.data()[index];
+		Size sub = Algorithm::sub_index(_leaf.size());
+		if (sub > 0 && index == _leaf.buckets() - 1)
+			word |= ~Algorithm::fill_left(sub);
+		return word;
+	}
+
+	//Turns on bit index of the given pyramid and walks up while the
+	//containing word was empty before.
+	static void summary_on(std::vector<Level>& pyramid, Size index)
+	{
+		for (Size level = 0; level < pyramid.size(); ++level)
+		{
+			Word& word = pyramid[level].data()[Algorithm::bucket_index(index)];
+			Word before = word;
+			word |= Algorithm::mark_bit(Algorithm::sub_index(index));
+			if (before != 0)
+				return;
+			index = Algorithm::bucket_index(index);
+		}
+	}
+
+	//Turns off bit index and walks up while the containing word became empty.
+	static void summary_off(std::vector<Level>& pyramid, Size index)
+	{
+		for (Size level = 0; level < pyramid.size(); ++level)
+		{
+			Word& word = pyramid[level].data()[Algorithm::bucket_index(index)];
+			word &= ~Algorithm::mark_bit(Algorithm::sub_index(index));
+			if (word != 0)
+				return;
+			index = Algorithm::bucket_index(index);
+		}
+	}
+
+	//recomputes the summaries above leaf words [first, last]
+	void refresh(Size first, Size last)
+	{
+		if (_any_set.empty())
+			return;
+		for (Size index = first; index <= last; ++index)
+		{
+			Word word = _leaf.data()[index];
+			if (word != 0)
+				_any_set[0].set_bit(index);
+			else
+				_any_set[0].clear_bit(index);
+			if (~full_word(index) != 0)
+				_any_clear[0].set_bit(index);
+			else
+				_any_clear[0].clear_bit(index);
+		}
+		for (Size level = 1; level < _any_set.size(); ++level)
+		{
+			first = Algorithm::bucket_index(first);
+			last = Algorithm::bucket_index(last);
+			for (Size index = first; index <= last; ++index)
+			{
+				if (_any_set[level - 1].data()[index] != 0)
+					_any_set[level].set_bit(index);
+				else
+					_any_set[level].clear_bit(index);
+				if (_any_clear[level - 1].data()[index] != 0)
+					_any_clear[level].set_bit(index);
+				else
+					_any_clear[level].clear_bit(index);
+			}
+		}
+	}
+
+	//Word of a search level (0 is the leaf), inverted at the leaf for the
+	//clear-bit search. Padding bits then read as clear, but they come after
+	//every valid bit of the last word, so a hit on them means "not found".
+	template<bool Target>
+	Word level_word(Size level, Size index) const
+	{
+		if (level == 0)
+			return Target ? _leaf.data()[index] : ~_leaf.data()[index];
+		const std::vector<Level>& pyramid = Target ? _any_set : _any_clear;
+		return pyramid[level - 1].data()[index];
+	}
+
+	//first index >= start whose leaf bit equals the target
+	template<bool Target>
+	Size find_from(Size start) const
+	{
+		if (start >= size())
+			return size();
+		Size levels = _any_set.size() + 1;
+		Size index = start;
+		for (Size level = 0; level < levels; ++level)
+		{
+			Size bucket = Algorithm::bucket_index(index);
+			Word word = level_word<Target>(level, bucket)
+					& (Algorithm::MASK() >> Algorithm::sub_index(index));
+			if (word != 0)
+			{
+				Size pos = bucket * BIT_COUNT() + bit_word::clz(word);
+				while (level-- > 0)
+					pos = pos * BIT_COUNT()
+							+ bit_word::clz(level_word<Target>(level, pos));
+				return std::min(pos, size());
+			}
+			index = bucket + 1;
+			Size words = (level == 0) ? _leaf.buckets() :
+					(Target ? _any_set : _any_clear)[level - 1].buckets();
+			if (index >= words)
+				return size();
+		}
+		return size();
+	}
+
+public:
+	explicit HierarchicalBitmap(Size bits = 0, bool initial = false,
+			Allocator& allocator = default_allocator()) :
+			_leaf(bits, initial, allocator)
+	{
+		for (Size words = _leaf.buckets(); words > 1;
+				words = Algorithm::buckets_for(words))
+		{
+			_any_set.push_back(Level(words, initial, allocator));
+			_any_clear.push_back(Level(words, !initial, allocator));
+		}
+	}
+
+	Size size() const
+	{
+		return _leaf.size();
+	}
+
+	//number of summary levels above the leaf
+	Size levels() const
+	{
+		return _any_set.size();
+	}
+
+	const Level& leaf() const
+	{
+		return _leaf;
+	}
+
+	bool get_bit(Size index) const
+	{
+		return _leaf.get_bit(index);
+	}
+
+	void set_bit(Size index)
+	{
+		Size bucket = Algorithm::bucket_index(index);
+		Word& word = _leaf.data()[bucket];
+		Word before = word;
+		word |= Algorithm::mark_bit(Algorithm::sub_index(index));
+		if (word == before)
+			return;
+		if (before == 0)
+			summary_on(_any_set, bucket);
+		if (~full_word(bucket) == 0)
+			summary_off(_any_clear, bucket);
+	}
+
+	void clear_bit(Size index)
+	{
+		Size bucket = Algorithm::bucket_index(index);
+		bool was_full = (~full_word(bucket) == 0);
+		Word& word = _leaf.data()[bucket];
+		Word before = word;
+		word &= ~Algorithm::mark_bit(Algorithm::sub_index(index));
+		if (word == before)
+			return;
+		if (word == 0)
+			summary_off(_any_set, bucket);
+		if (was_full)
+			summary_on(_any_clear, bucket);
+	}
+
+	void set_range(Size start, Size length)
+	{
+		if (length == 0)
+			return;
+		_leaf.set_range(start, length);
+		refresh(Algorithm::bucket_index(start),
+				Algorithm::bucket_index(start + length - 1));
+	}
+
+	void clear_range(Size start, Size length)
+	{
+		if (length == 0)
+			return;
+		_leaf.clear_range(start, length);
+		refresh(Algorithm::bucket_index(start),
+				Algorithm::bucket_index(start + length - 1));
+	}
+
+	void clear()
+	{
+		clear_range(0, size());
+	}
+
+	void fill()
+	{
+		set_range(0, size());
+	}
+
+	Size count() const
+	{
+		return _leaf.count();
+	}
+
+	bool any() const
+	{
+		return _any_set.empty() ? _leaf.count() > 0 :
+				_any_set.back().data()[0] != 0;
+	}
+
+	//Find functions follow the get_bit order and return size() if not found.
+	Size find_first_set() const
+	{
+		return find_from<true>(0);
+	}
+
+	Size find_next_set(Size pos) const
+	{
+		return find_from<true>(pos + 1);
+	}
+
+	Size find_first_zero() const
+	{
+		return find_from<false>(0);
+	}
+
+	Size find_next_zero(Size pos) const
+	{
+		return find_from<false>(pos + 1);
+	}
+};
+
+}
+
+#endif /* INCLUDE_R_HIERARCHICAL_BITMAP_HPP_ */
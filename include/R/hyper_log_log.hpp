@@ -0,0 +1,394 @@
+/*
+ * hyper_log_log.hpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef INCLUDE_R_HYPER_LOG_LOG_HPP_
+#define INCLUDE_R_HYPER_LOG_LOG_HPP_
+
+#include <cstdint>
+#include <cmath>
+#include <cassert>
+#include <atomic>
+#include <new>
+
+#include <R/bit_algorithm.hpp>
+#include <R/bit_kernel.hpp>
+#include <R/bit_vector.hpp>
+#include <R/hash_batch.hpp>
+#include <R/memory_allocator.hpp>
+
+namespace R
+{
+
+//Packed 6-bit HyperLogLog registers. Ten registers share a 64-bit word,
+//register 0 in the highest field (bits 54-59) like the BitArray order;
+//the top four bits stay clear, so a register never straddles words.
+namespace hll_register
+{
+
+typedef std::size_t Size;
+typedef uint64_t Word;
+
+constexpr Size BITS = 6;
+constexpr Size PER_WORD = 10;
+constexpr Word MASK = 63;
+//words processed together by the merge loops
+constexpr Size BLOCK = 4;
+
+//fields 0, 2, .., 8 and 1, 3, .., 9, and the bit just above each of them
+constexpr Word EVEN_FIELDS = 0x0FC0FC0FC0FC0FC0ULL;
+constexpr Word EVEN_GUARDS = 0x1001001001001000ULL;
+constexpr Word ODD_FIELDS = 0x003F03F03F03F03FULL;
+constexpr Word ODD_GUARDS = 0x0040040040040040ULL;
+
+constexpr Size words_for(Size registers)
+{
+	return (registers + PER_WORD - 1) / PER_WORD;
+}
+
+constexpr Size shift(Size field)
+{
+	return (PER_WORD - 1 - field) * BITS;
+}
+
+inline Size get(Word word, Size field)
+{
+	return (Size) ((word >> shift(field)) & MASK);
+}
+
+inline Word set(Word word, Size field, Size value)
+{
+	return (word & ~(MASK << shift(field))) | ((Word) value << shift(field));
+}
+
+//Field-wise max over every other field. The cleared neighbours leave
+//room for a guard bit, so (x | guard) - y keeps the guard exactly where
+//x >= y and no borrow crosses fields.
+inline Word max_fields(Word x, Word y, Word fields, Word guards)
+{
+	x &= fields;
+	y &= fields;
+	Word ge = (((x | guards) - y) & guards) >> BITS;
+	Word select = (ge << BITS) - ge;
+	return (x & select) | (y & ~select);
+}
+
+//register-wise max of two packed words
+inline Word max(Word x, Word y)
+{
+	return max_fields(x, y, EVEN_FIELDS, EVEN_GUARDS)
+			| max_fields(x, y, ODD_FIELDS, ODD_GUARDS);
+}
+
+inline void merge_words(Word* __restrict dst, const Word* __restrict src,
+		Size words)
+{
+	Size index = 0;
+	for (; index + BLOCK <= words; index += BLOCK)
+		for (Size k = 0; k < BLOCK; ++k)
+			dst[index + k] = max(dst[index + k], src[index + k]);
+	for (; index < words; ++index)
+		dst[index] = max(dst[index], src[index]);
+}
+
+#ifdef R_BIT_KERNEL_AVX2
+//the same loop compiled for ymm registers
+__attribute__((target("avx2")))
+inline void merge_words_avx2(Word* __restrict dst, const Word* __restrict src,
+		Size words)
+{
+	Size index = 0;
+	for (; index + BLOCK <= words; index += BLOCK)
+		for (Size k = 0; k < BLOCK; ++k)
+			dst[index + k] = max(dst[index + k], src[index + k]);
+	for (; index < words; ++index)
+		dst[index] = max(dst[index], src[index]);
+}
+#endif
+
+inline void merge(Word* dst, const Word* src, Size words)
+{
+#ifdef R_BIT_KERNEL_AVX2
+	if (bit_kernel::use_avx2())
+	{
+		merge_words_avx2(dst, src, words);
+		return;
+	}
+#endif
+	merge_words(dst, src, words);
+}
+
+//Register index from the top precision bits and the rank (position of
+//the first set bit, from 1) of the rest. A guard bit caps the rank at
+//65 - precision, which fits in six bits.
+inline void locate(uint64_t hash, Size precision, Size& index, Size& rank)
+{
+	index = (Size) (hash >> (64 - precision));
+	uint64_t rest = (hash << precision) | ((uint64_t) 1 << (precision - 1));
+	rank = bit_word::clz(rest) + 1;
+}
+
+//Raw estimate with the linear counting correction for small sets.
+//Register values are read through get(index).
+template<typename Getter>
+inline double estimate(Size precision, Getter && get)
+{
+	Size registers = (Size) 1 << precision;
+	double m = (double) registers;
+	double alpha = (registers == 16) ? 0.673 : (registers == 32) ? 0.697 :
+					(registers == 64) ? 0.709 : 0.7213 / (1.0 + 1.079 / m);
+	double sum = 0;
+	Size zeros = 0;
+	for (Size index = 0; index < registers; ++index)
+	{
+		Size value = get(index);
+		sum += std::ldexp(1.0, -(int) value);
+		zeros += (value == 0);
+	}
+	double raw = alpha * m * m / sum;
+	if (raw <= 2.5 * m && zeros > 0)
+		return m * std::log(m / (double) zeros);
+	return raw;
+}
+
+}
+
+//HyperLogLog cardinality estimator with 2^precision packed registers
+//(relative error about 1.04 / sqrt(2^precision)). Keys are 64-bit hashes
+//and are mixed again, so weak hashes are fine.
+class HyperLogLog
+{
+public:
+	typedef std::size_t Size;
+	typedef hll_register::Word Word;
+
+	constexpr static Size MIN_PRECISION = 4;
+	constexpr static Size MAX_PRECISION = 18;
+private:
+	Size _precision;
+	BitVector<Word> _words;
+
+	friend class AtomicHyperLogLog;
+
+	void insert_hash(uint64_t hash)
+	{
+		Size index, rank;
+		hll_register::locate(hash, _precision, index, rank);
+		Word& word = _words.data()[index / hll_register::PER_WORD];
+		Size field = index % hll_register::PER_WORD;
+		if (hll_register::get(word, field) < rank)
+			word = hll_register::set(word, field, rank);
+	}
+
+	const Word* word_of(uint64_t hash) const
+	{
+		return _words.data()
+				+ (hash >> (64 - _precision)) / hll_register::PER_WORD;
+	}
+
+public:
+	explicit HyperLogLog(Size precision = 14,
+			Allocator& allocator = default_allocator()) :
+			_precision(precision), _words(0, false, allocator)
+	{
+		assert(precision >= MIN_PRECISION && precision <= MAX_PRECISION);
+		_words.resize(hll_register::words_for(registers()) * 64);
+	}
+
+	Size precision() const
+	{
+		return _precision;
+	}
+
+	Size registers() const
+	{
+		return (Size) 1 << _precision;
+	}
+
+	Size get(Size index) const
+	{
+		return hll_register::get(_words.data()[index / hll_register::PER_WORD],
+				index % hll_register::PER_WORD);
+	}
+
+	const BitVector<Word>& words() const
+	{
+		return _words;
+	}
+
+	void clear()
+	{
+		_words.clear();
+	}
+
+	void insert(uint64_t key)
+	{
+		insert_hash(hash_batch::mix(key));
+	}
+
+	//Inserts count keys a batch at a time, prefetching their registers.
+	void insert_many(const uint64_t* keys, Size count)
+	{
+		hash_batch::for_each_batch(keys, count, [this](uint64_t hash)
+		{
+			hash_batch::prefetch(word_of(hash), true);
+		}, [this](Size, uint64_t hash)
+		{
+			insert_hash(hash);
+		});
+	}
+
+	double estimate() const
+	{
+		return hll_register::estimate(_precision, [this](Size index)
+		{
+			return get(index);
+		});
+	}
+
+	//union of the two sets; precisions must match
+	void merge(const HyperLogLog& other)
+	{
+		assert(_precision == other._precision);
+		hll_register::merge(_words.data(), other._words.data(),
+				_words.buckets());
+	}
+};
+
+//HyperLogLog accepting concurrent inserts. A register is only written,
+//by compare-and-swap on its word, when the rank raises it, so the steady
+//state of a hot stream is read-only.
+class AtomicHyperLogLog
+{
+public:
+	typedef std::size_t Size;
+	typedef hll_register::Word Word;
+private:
+	Size _precision;
+	Allocator* _allocator;
+	Allocator::Aux _aux;
+	std::atomic<Word>* _words;
+
+	Size words() const
+	{
+		return hll_register::words_for(registers());
+	}
+
+	std::atomic<Word>* word_of(uint64_t hash) const
+	{
+		return _words + (hash >> (64 - _precision)) / hll_register::PER_WORD;
+	}
+
+	void insert_hash(uint64_t hash, std::memory_order order)
+	{
+		Size index, rank;
+		hll_register::locate(hash, _precision, index, rank);
+		std::atomic<Word>& word = _words[index / hll_register::PER_WORD];
+		Size field = index % hll_register::PER_WORD;
+		Word current = word.load(std::memory_order_relaxed);
+		while (hll_register::get(current, field) < rank)
+			if (word.compare_exchange_weak(current,
+					hll_register::set(current, field, rank), order,
+					std::memory_order_relaxed))
+				return;
+	}
+
+public:
+	explicit AtomicHyperLogLog(Size precision = 14,
+			Allocator& allocator = default_allocator()) :
+			_precision(precision), _allocator(&allocator),
+					_aux(Allocator::NullPtr), _words(nullptr)
+	{
+		assert(precision >= HyperLogLog::MIN_PRECISION
+				&& precision <= HyperLogLog::MAX_PRECISION);
+		Allocator::Ptr addr = Allocator::NullPtr;
+		_aux = allocate_aligned(allocator, words() * sizeof(std::atomic<Word>),
+				CACHE_LINE_SIZE, addr);
+		if (addr == Allocator::NullPtr)
+			throw std::bad_alloc();
+		_words = (std::atomic<Word>*) addr;
+		for (Size index = 0; index < words(); ++index)
+			new (_words + index) std::atomic<Word>(0);
+	}
+
+	AtomicHyperLogLog(const AtomicHyperLogLog&) = delete;
+	AtomicHyperLogLog& operator=(const AtomicHyperLogLog&) = delete;
+
+	~AtomicHyperLogLog()
+	{
+		_allocator->deallocate(_aux);
+	}
+
+	Size precision() const
+	{
+		return _precision;
+	}
+
+	Size registers() const
+	{
+		return (Size) 1 << _precision;
+	}
+
+	//not safe against concurrent inserts
+	void clear()
+	{
+		for (Size index = 0; index < words(); ++index)
+			_words[index].store(0, std::memory_order_relaxed);
+	}
+
+	void insert(uint64_t key, std::memory_order order = std::memory_order_release)
+	{
+		insert_hash(hash_batch::mix(key), order);
+	}
+
+	void insert_many(const uint64_t* keys, Size count,
+			std::memory_order order = std::memory_order_release)
+	{
+		hash_batch::for_each_batch(keys, count, [this](uint64_t hash)
+		{
+			hash_batch::prefetch(word_of(hash), true);
+		}, [this, order](Size, uint64_t hash)
+		{
+			insert_hash(hash, order);
+		});
+	}
+
+	//Raises the registers to those of a plain sketch; concurrent inserts
+	//are kept.
+	void merge(const HyperLogLog& other,
+			std::memory_order order = std::memory_order_release)
+	{
+		assert(_precision == other._precision);
+		const Word* source = other._words.data();
+		for (Size index = 0; index < words(); ++index)
+		{
+			Word current = _words[index].load(std::memory_order_relaxed);
+			Word merged = hll_register::max(current, source[index]);
+			while (merged != current
+					&& !_words[index].compare_exchange_weak(current, merged,
+							order, std::memory_order_relaxed))
+				merged = hll_register::max(current, source[index]);
+		}
+	}
+
+	//copies the current registers into a plain sketch
+	HyperLogLog snapshot(Allocator& allocator = default_allocator()) const
+	{
+		HyperLogLog copy(_precision, allocator);
+		Word* words = copy._words.data();
+		for (Size index = 0; index < this->words(); ++index)
+			words[index] = _words[index].load(std::memory_order_acquire);
+		return copy;
+	}
+
+	double estimate() const
+	{
+		return snapshot().estimate();
+	}
+};
+
+}
+
+#endif /* INCLUDE_R_HYPER_LOG_LOG_HPP_ */
@@ -0,0 +1,176 @@
+/*
+ * mapped_bit_array.hpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef INCLUDE_R_MAPPED_BIT_ARRAY_HPP_
+#define INCLUDE_R_MAPPED_BIT_ARRAY_HPP_
+
+#include <cerrno>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <R/bit_algorithm.hpp>
+#include <R/bit_array_view.hpp>
+
+namespace R
+{
+
+//Bitmap persisted in a file and mapped with MAP_SHARED, so views operate
+//on the page cache directly. A writable mapping creates the file and
+//extends it with zero bits as needed; sync() flushes dirty pages.
+//System call failures throw std::system_error.
+template<typename BaseInt>
+class MappedBitArray
+{
+public:
+	typedef std::size_t Size;
+	typedef BitArrayView<BaseInt> View;
+	typedef BitArrayView<const BaseInt> ConstView;
+private:
+	typedef BitAlgorithm<BaseInt> Algorithm;
+
+	int _fd;
+	void* _addr;
+	Size _bytes;
+	Size _bits;
+	bool _writable;
+
+	static void fail(const char* what)
+	{
+		throw std::system_error(errno, std::generic_category(), what);
+	}
+
+	void unmap()
+	{
+		if (_addr != nullptr)
+			munmap(_addr, _bytes);
+		if (_fd >= 0)
+			::close(_fd);
+		_fd = -1;
+		_addr = nullptr;
+		_bytes = 0;
+		_bits = 0;
+	}
+
+public:
+	MappedBitArray() :
+			_fd(-1), _addr(nullptr), _bytes(0), _bits(0), _writable(false)
+	{
+	}
+
+	MappedBitArray(const char* path, Size bits, bool writable = true) :
+			MappedBitArray()
+	{
+		open(path, bits, writable);
+	}
+
+	MappedBitArray(const MappedBitArray&) = delete;
+	MappedBitArray& operator=(const MappedBitArray&) = delete;
+
+	MappedBitArray(MappedBitArray&& source) noexcept :
+			MappedBitArray()
+	{
+		*this = std::move(source);
+	}
+
+	MappedBitArray& operator=(MappedBitArray&& source) noexcept
+	{
+		if (this == &source)
+			return *this;
+		unmap();
+		std::swap(_fd, source._fd);
+		std::swap(_addr, source._addr);
+		std::swap(_bytes, source._bytes);
+		std::swap(_bits, source._bits);
+		std::swap(_writable, source._writable);
+		return *this;
+	}
+
+	~MappedBitArray()
+	{
+		unmap();
+	}
+
+	//Maps the first bits of the file. A read-only file must be large enough.
+	void open(const char* path, Size bits, bool writable = true)
+	{
+		close();
+		_writable = writable;
+		_fd = ::open(path, writable ? (O_RDWR | O_CREAT) : O_RDONLY, 0644);
+		if (_fd < 0)
+			fail("open");
+		_bytes = Algorithm::buckets_for(bits) * sizeof(BaseInt);
+
+		struct stat info;
+		if (fstat(_fd, &info) != 0)
+			fail("fstat");
+		if ((Size) info.st_size < _bytes)
+		{
+			if (!writable)
+			{
+				errno = EINVAL;
+				fail("file too small");
+			}
+			if (ftruncate(_fd, (off_t) _bytes) != 0)
+				fail("ftruncate");
+		}
+		if (_bytes > 0)
+		{
+			void* addr = mmap(nullptr, _bytes,
+					writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED,
+					_fd, 0);
+			if (addr == MAP_FAILED)
+				fail("mmap");
+			_addr = addr;
+		}
+		_bits = bits;
+	}
+
+	//flushes, then unmaps and closes the file
+	void close()
+	{
+		if (_addr != nullptr && _writable)
+			sync();
+		unmap();
+	}
+
+	//writes dirty pages back; async only schedules the write
+	void sync(bool async = false)
+	{
+		if (_addr != nullptr
+				&& msync(_addr, _bytes, async ? MS_ASYNC : MS_SYNC) != 0)
+			fail("msync");
+	}
+
+	bool is_open() const
+	{
+		return _fd >= 0;
+	}
+
+	Size size() const
+	{
+		return _bits;
+	}
+
+	//writing through the view of a read-only mapping faults
+	View view()
+	{
+		return View((BaseInt*) _addr, _bits);
+	}
+
+	ConstView view() const
+	{
+		return ConstView((const BaseInt*) _addr, _bits);
+	}
+};
+
+}
+
+#endif /* INCLUDE_R_MAPPED_BIT_ARRAY_HPP_ */
@@ -10,6 +10,7 @@
 
 
 #include <cstdlib>
+#include <cstdint>
 
 
 #ifdef FUNC_ATTR
@@ -29,7 +30,7 @@ public:
 	typedef void* Ptr;
 	typedef std::size_t Size;
 
-	const static Ptr NullPtr = nullptr;
+	constexpr static Ptr NullPtr = nullptr;
 
 	__func__attr__ Allocator() { };
 	__func__attr__ virtual ~Allocator() { };
@@ -39,6 +40,7 @@ public:
 
 class DefaultAllocator : public Allocator
 {
+public:
 	__func__attr__ DefaultAllocator() { };
 	__func__attr__ virtual ~DefaultAllocator() { };
 	__func__attr__ virtual Aux allocate(Size size, Ptr &addr)
@@ -54,6 +56,33 @@ class DefaultAllocator : public Allocator
 	}
 };
 
+constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+//process-wide allocator used when a container is not given one
+inline Allocator& default_allocator()
+{
+	static DefaultAllocator allocator;
+	return allocator;
+}
+
+//Allocates size bytes aligned to align (a power of two) by over-allocating.
+//The returned Aux must be passed back to allocator.deallocate.
+inline Allocator::Aux allocate_aligned(Allocator& allocator, Allocator::Size size,
+		Allocator::Size align, Allocator::Ptr &addr)
+{
+	Allocator::Ptr raw = Allocator::NullPtr;
+	Allocator::Aux aux = allocator.allocate(size + align - 1, raw);
+	if (raw == Allocator::NullPtr)
+	{
+		addr = Allocator::NullPtr;
+		return aux;
+	}
+	std::uintptr_t value = (std::uintptr_t) raw;
+	value = (value + align - 1) & ~(std::uintptr_t) (align - 1);
+	addr = (Allocator::Ptr) value;
+	return aux;
+}
+
 }
 
 
@@ -0,0 +1,252 @@
+/*
+ * rank_select.hpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef INCLUDE_R_RANK_SELECT_HPP_
+#define INCLUDE_R_RANK_SELECT_HPP_
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+#include <R/bit_algorithm.hpp>
+#include <R/bit_array.hpp>
+#include <R/bit_vector.hpp>
+
+namespace R
+{
+
+//Rank/select index over a static bitmap that it does not own.
+//One 64-bit entry per 2048-bit block interleaves the set bits before the
+//block (32 bits, relative to a 2^32-bit upper block) with the counts of
+//its first three 512-bit sub-blocks (10 bits each), about 3% of the
+//bitmap. Select starts from the block of every 8192th set bit and binary
+//searches the block entries from there.
+//Bits follow the get_bit order, the padding after size() must be clear,
+//and the index must be rebuilt after the bitmap changes.
+template<typename BaseInt>
+class RankSelect
+{
+public:
+	typedef std::size_t Size;
+private:
+	typedef BitAlgorithm<BaseInt> Algorithm;
+
+	constexpr static Size BLOCK_BITS()
+	{
+		return ((Size) 2048);
+	}
+	constexpr static Size SUB_BITS()
+	{
+		return ((Size) 512);
+	}
+	constexpr static Size BLOCK_WORDS()
+	{
+		return BLOCK_BITS() / Algorithm::BIT_COUNT();
+	}
+	constexpr static Size SUB_WORDS()
+	{
+		return SUB_BITS() / Algorithm::BIT_COUNT();
+	}
+	//blocks per 2^32-bit upper block
+	constexpr static Size UPPER_BLOCKS()
+	{
+		return ((Size) 1 << 21);
+	}
+	constexpr static Size SAMPLE_RATE()
+	{
+		return ((Size) 8192);
+	}
+
+	const BaseInt* _data;
+	Size _size;
+	Size _count;
+	std::vector<uint64_t> _blocks;
+	std::vector<Size> _upper;
+	std::vector<Size> _samples;
+
+	static Size sub_block(uint64_t entry, Size sub)
+	{
+		return (Size) ((entry >> (20 - 10 * sub)) & 1023);
+	}
+
+	Size words() const
+	{
+		return Algorithm::buckets_for(_size);
+	}
+
+	//set bits before the block
+	Size block_rank(Size block) const
+	{
+		return _upper[block / UPPER_BLOCKS()] + (Size) (_blocks[block] >> 32);
+	}
+
+	Size popcount(Size first, Size last) const
+	{
+		last = std::min(last, words());
+		Size total = 0;
+		for (Size word = first; word < last; ++word)
+			total += bit_word::popcount(_data[word]);
+		return total;
+	}
+
+	void build(Size first_block)
+	{
+		Size blocks = (_size + BLOCK_BITS() - 1) / BLOCK_BITS();
+		first_block = std::min(first_block, std::min(blocks, _blocks.size()));
+		//counted from the block before, which exists even when first_block
+		//is one past the last block and nothing is rebuilt
+		Size total = (first_block > 0) ?
+				block_rank(first_block - 1)
+						+ popcount((first_block - 1) * BLOCK_WORDS(),
+								first_block * BLOCK_WORDS()) : 0;
+		_blocks.resize(blocks);
+		_upper.resize((blocks + UPPER_BLOCKS() - 1) / UPPER_BLOCKS());
+
+		//samples before the first rebuilt block keep pointing at the same block
+		Size sample = (total + SAMPLE_RATE() - 1) / SAMPLE_RATE();
+		_samples.resize(std::min(sample, _samples.size()));
+		sample = _samples.size();
+
+		for (Size block = first_block; block < blocks; ++block)
+		{
+			if (block % UPPER_BLOCKS() == 0)
+				_upper[block / UPPER_BLOCKS()] = total;
+			uint64_t entry = (uint64_t) (total
+					- _upper[block / UPPER_BLOCKS()]) << 32;
+			Size word = block * BLOCK_WORDS();
+			for (Size sub = 0; sub < 4; ++sub, word += SUB_WORDS())
+			{
+				Size count = popcount(word, word + SUB_WORDS());
+				if (sub < 3)
+					entry |= (uint64_t) count << (20 - 10 * sub);
+				total += count;
+			}
+			_blocks[block] = entry;
+			for (; sample * SAMPLE_RATE() < total; ++sample)
+				_samples.push_back(block);
+		}
+		_count = total;
+	}
+
+public:
+	RankSelect() :
+			_data(nullptr), _size(0), _count(0)
+	{
+	}
+
+	RankSelect(const BaseInt* data, Size bits) :
+			_data(data), _size(bits), _count(0)
+	{
+		this->build(0);
+	}
+
+	template<std::size_t TotalBits>
+	explicit RankSelect(const BitArray<BaseInt, TotalBits>& bits) :
+			RankSelect(bits.data(), TotalBits)
+	{
+	}
+
+	explicit RankSelect(const BitVector<BaseInt>& bits) :
+			RankSelect(bits.data(), bits.size())
+	{
+	}
+
+	//Points the index at new storage (e.g. after a BitVector resize).
+	void reset(const BaseInt* data, Size bits)
+	{
+		_data = data;
+		_size = bits;
+		_blocks.clear();
+		_upper.clear();
+		_samples.clear();
+		this->build(0);
+	}
+
+	//Recounts after bulk updates; everything before first_bit must be unchanged.
+	void rebuild(Size first_bit = 0)
+	{
+		this->build(first_bit / BLOCK_BITS());
+	}
+
+	Size size() const
+	{
+		return _size;
+	}
+
+	Size count() const
+	{
+		return _count;
+	}
+
+	//bytes used by the index itself
+	Size memory_usage() const
+	{
+		return _blocks.size() * sizeof(uint64_t)
+				+ (_upper.size() + _samples.size()) * sizeof(Size);
+	}
+
+	//number of set bits in [0, index)
+	Size rank(Size index) const
+	{
+		if (index >= _size)
+			return _count;
+		Size block = index / BLOCK_BITS();
+		Size sub = (index % BLOCK_BITS()) / SUB_BITS();
+		Size total = block_rank(block);
+		for (Size k = 0; k < sub; ++k)
+			total += sub_block(_blocks[block], k);
+
+		Size word = Algorithm::bucket_index(index);
+		total += popcount(block * BLOCK_WORDS() + sub * SUB_WORDS(), word);
+		Size bit = Algorithm::sub_index(index);
+		if (bit > 0)
+			total += bit_word::popcount(
+					(BaseInt) (_data[word] & Algorithm::fill_left(bit)));
+		return total;
+	}
+
+	//position of the k-th set bit (from 0), or size() if k >= count()
+	Size select(Size k) const
+	{
+		if (k >= _count)
+			return _size;
+		Size sample = k / SAMPLE_RATE();
+		Size low = _samples[sample];
+		Size high = (sample + 1 < _samples.size()) ?
+				_samples[sample + 1] + 1 : _blocks.size();
+		while (high - low > 1)
+		{
+			Size middle = low + (high - low) / 2;
+			if (block_rank(middle) <= k)
+				low = middle;
+			else
+				high = middle;
+		}
+
+		k -= block_rank(low);
+		Size sub = 0;
+		for (; sub < 3; ++sub)
+		{
+			Size count = sub_block(_blocks[low], sub);
+			if (k < count)
+				break;
+			k -= count;
+		}
+		Size word = low * BLOCK_WORDS() + sub * SUB_WORDS();
+		for (;; ++word)
+		{
+			Size count = bit_word::popcount(_data[word]);
+			if (k < count)
+				break;
+			k -= count;
+		}
+		return word * Algorithm::BIT_COUNT() + bit_word::select(_data[word], k);
+	}
+};
+
+}
+
+#endif /* INCLUDE_R_RANK_SELECT_HPP_ */
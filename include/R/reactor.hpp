@@ -0,0 +1,622 @@
+/*
+ * reactor.hpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef INCLUDE_R_REACTOR_HPP_
+#define INCLUDE_R_REACTOR_HPP_
+
+#include <cstdint>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+
+#include <R/scheduler.hpp>
+
+//Reactor backends, chosen at compile time by defining R_REACTOR_BACKEND
+//to one of these before including reactor.hpp.
+#define R_REACTOR_EPOLL 1    //edge-triggered readiness
+#define R_REACTOR_IO_URING 2 //completions, through the raw system calls
+
+#ifndef R_REACTOR_BACKEND
+#define R_REACTOR_BACKEND R_REACTOR_EPOLL
+#endif
+
+#if R_REACTOR_BACKEND == R_REACTOR_IO_URING
+#define R_REACTOR_NAMESPACE reactor_io_uring
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#else
+#define R_REACTOR_NAMESPACE reactor_epoll
+#include <sys/epoll.h>
+#endif
+
+namespace R
+{
+
+inline namespace R_COROUTINE_NAMESPACE
+{
+
+inline namespace R_REACTOR_NAMESPACE
+{
+
+//Non-blocking I/O for the fibers of a Scheduler.
+//
+//async_read, async_write and async_accept first try the plain system
+//call; when it would block, the fiber is suspended and the worker goes on
+//with other fibers. With epoll, every descriptor is registered once,
+//edge-triggered, on its first wait, and a readiness event resumes the
+//fiber to retry. With io_uring, the operation itself is queued on the
+//submission ring and the fiber resumes with its result.
+//
+//One thread per Reactor waits on the kernel. Everything that became
+//ready in one wake-up is handed to the scheduler in a single batch, and
+//io_uring submissions queued meanwhile go in with the next wait, so a
+//busy reactor makes about one system call per round, not one per
+//operation. Outside of fibers the calls block the thread in poll().
+//
+//Descriptors must be non-blocking, and at most one fiber may read and
+//one write a descriptor at a time. Close them with close() so a reused
+//number starts afresh. Every operation must have completed before the
+//Reactor is destroyed; errors throw std::system_error.
+class Reactor
+{
+public:
+	typedef std::size_t Size;
+private:
+	enum Operation
+	{
+		READ, WRITE, ACCEPT
+	};
+
+	Scheduler* _scheduler;
+	Size _batch;
+	int _wake; //eventfd, written to stop the thread or, with io_uring, to submit
+	std::atomic<bool> _stop;
+
+#if R_REACTOR_BACKEND == R_REACTOR_EPOLL
+	//who waits on a descriptor, and readiness that came with nobody waiting
+	struct Interest
+	{
+		std::mutex mutex;
+		Fiber* reader;
+		Fiber* writer;
+		bool readable;
+		bool writable;
+		bool registered;
+
+		Interest() :
+				reader(nullptr), writer(nullptr), readable(false),
+						writable(false), registered(false)
+		{
+		}
+	};
+
+	//indexed by descriptor, in chunks allocated on first use so the
+	//reactor thread never sees a table move
+	static constexpr Size CHUNK = 1024;
+	static constexpr Size CHUNKS = 1024;
+
+	int _epoll;
+	std::unique_ptr<std::atomic<Interest*>[]> _interests;
+#else
+	//lives on the stack of the suspended fiber until it resumes
+	struct Request
+	{
+		Fiber* fiber;
+		int result;
+	};
+
+	int _ring;
+	void* _rings;
+	Size _rings_length;
+	io_uring_sqe* _sqes;
+	Size _sqes_length;
+	unsigned _sq_entries;
+	unsigned _sq_mask;
+	unsigned* _sq_head;
+	unsigned* _sq_tail;
+	unsigned* _sq_array;
+	unsigned _cq_mask;
+	unsigned* _cq_head;
+	unsigned* _cq_tail;
+	io_uring_cqe* _cqes;
+
+	std::mutex _submit_mutex; //guards the submission ring and _sleeping
+	bool _sleeping; //the thread waits without the latest submissions
+	uint64_t _wake_value;
+#endif
+
+	std::thread _thread;
+
+	static void fail(const char* what)
+	{
+		throw std::system_error(errno, std::generic_category(), what);
+	}
+
+	static const char* name(Operation operation)
+	{
+		return operation == READ ? "read" : operation == WRITE ? "write" : "accept";
+	}
+
+	static long attempt(Operation operation, int fd, void* buffer, Size bytes,
+			sockaddr* address, socklen_t* length)
+	{
+		switch (operation)
+		{
+		case READ:
+			return ::read(fd, buffer, bytes);
+		case WRITE:
+			return ::write(fd, buffer, bytes);
+		default:
+			return ::accept4(fd, address, length, SOCK_NONBLOCK | SOCK_CLOEXEC);
+		}
+	}
+
+	//outside of fibers
+	static void block(int fd, Operation operation)
+	{
+		pollfd request;
+		request.fd = fd;
+		request.events = operation == WRITE ? POLLOUT : POLLIN;
+		request.revents = 0;
+		::poll(&request, 1, -1);
+	}
+
+	long perform(Operation operation, int fd, void* buffer, Size bytes,
+			sockaddr* address, socklen_t* length)
+	{
+#if R_REACTOR_BACKEND == R_REACTOR_IO_URING
+		bool poll = false;
+#endif
+		while (true)
+		{
+			long result = attempt(operation, fd, buffer, bytes, address, length);
+			if (result >= 0)
+				return result;
+			if (errno == EINTR)
+				continue;
+			if (errno != EAGAIN && errno != EWOULDBLOCK)
+				fail(name(operation));
+			if (Scheduler::current() == nullptr)
+			{
+				block(fd, operation);
+				continue;
+			}
+			assert(&Scheduler::current()->scheduler() == _scheduler);
+#if R_REACTOR_BACKEND == R_REACTOR_EPOLL
+			wait(fd, operation);
+#else
+			result = submit(operation, fd, buffer, bytes, address, length, poll);
+			if (result >= 0 && !poll)
+				return result;
+			//older kernels answer a non-blocking descriptor with EAGAIN too;
+			//then wait for readiness and retry, as with epoll
+			if (result == -EAGAIN)
+				poll = true;
+			else if (result < 0 && result != -EINTR)
+			{
+				errno = (int) -result;
+				fail(name(operation));
+			}
+#endif
+		}
+	}
+
+	void wake()
+	{
+		uint64_t one = 1;
+		ssize_t written = ::write(_wake, &one, sizeof(one));
+		(void) written;
+	}
+
+#if R_REACTOR_BACKEND == R_REACTOR_EPOLL
+	Interest& interest(int fd)
+	{
+		assert(fd >= 0 && (Size) fd < CHUNK * CHUNKS);
+		std::atomic<Interest*>& chunk = _interests[(Size) fd / CHUNK];
+		Interest* interests = chunk.load(std::memory_order_acquire);
+		if (interests == nullptr)
+		{
+			Interest* fresh = new Interest[CHUNK];
+			if (chunk.compare_exchange_strong(interests, fresh,
+					std::memory_order_acq_rel, std::memory_order_acquire))
+				interests = fresh;
+			else
+				delete[] fresh;
+		}
+		return interests[(Size) fd % CHUNK];
+	}
+
+	//Suspends until fd may be ready for the operation. Readiness that came
+	//before the fiber was filed resumes it at once, so the caller may
+	//retry in vain but never misses an edge.
+	void wait(int fd, Operation operation)
+	{
+		Interest& entry = interest(fd);
+		{
+			std::lock_guard<std::mutex> lock(entry.mutex);
+			if (!entry.registered)
+			{
+				epoll_event event;
+				event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+				event.data.ptr = &entry;
+				if (epoll_ctl(_epoll, EPOLL_CTL_ADD, fd, &event) != 0
+						&& (errno != EEXIST
+								|| epoll_ctl(_epoll, EPOLL_CTL_MOD, fd, &event) != 0))
+					fail("epoll_ctl");
+				entry.registered = true;
+			}
+		}
+		bool write = operation == WRITE;
+		Scheduler::suspend([&entry, write](Fiber* self)
+		{
+			std::unique_lock<std::mutex> lock(entry.mutex);
+			bool& ready = write ? entry.writable : entry.readable;
+			if (ready)
+			{
+				ready = false;
+				lock.unlock();
+				Scheduler::ready(self);
+				return;
+			}
+			Fiber*& waiter = write ? entry.writer : entry.reader;
+			assert(waiter == nullptr);
+			waiter = self;
+		});
+	}
+
+	void run()
+	{
+		std::vector<epoll_event> events(_batch);
+		std::vector<Fiber*> woken;
+		while (true)
+		{
+			int count = epoll_wait(_epoll, events.data(), (int) _batch, -1);
+			bool stop = false;
+			for (int index = 0; index < count; ++index)
+			{
+				Interest* entry = (Interest*) events[index].data.ptr;
+				if (entry == nullptr)
+				{
+					stop = _stop.load(std::memory_order_acquire);
+					continue;
+				}
+				uint32_t flags = events[index].events;
+				std::lock_guard<std::mutex> lock(entry->mutex);
+				if (flags & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+				{
+					if (entry->reader != nullptr)
+						woken.push_back(entry->reader);
+					entry->readable = entry->reader == nullptr;
+					entry->reader = nullptr;
+				}
+				if (flags & (EPOLLOUT | EPOLLHUP | EPOLLERR))
+				{
+					if (entry->writer != nullptr)
+						woken.push_back(entry->writer);
+					entry->writable = entry->writer == nullptr;
+					entry->writer = nullptr;
+				}
+			}
+			_scheduler->ready(woken.data(), woken.size());
+			woken.clear();
+			if (stop)
+				break;
+		}
+	}
+
+	void open()
+	{
+		_interests.reset(new std::atomic<Interest*>[CHUNKS]);
+		for (Size index = 0; index < CHUNKS; ++index)
+			_interests[index].store(nullptr, std::memory_order_relaxed);
+		_epoll = epoll_create1(EPOLL_CLOEXEC);
+		if (_epoll < 0)
+			fail("epoll_create1");
+		epoll_event event;
+		event.events = EPOLLIN;
+		event.data.ptr = nullptr;
+		if (epoll_ctl(_epoll, EPOLL_CTL_ADD, _wake, &event) != 0)
+			fail("epoll_ctl");
+	}
+
+	void shut() noexcept
+	{
+		if (_epoll >= 0)
+			::close(_epoll);
+		if (_interests)
+			for (Size index = 0; index < CHUNKS; ++index)
+				delete[] _interests[index].load(std::memory_order_relaxed);
+	}
+#else
+	//caller holds _submit_mutex
+	io_uring_sqe& next_sqe()
+	{
+		unsigned tail = *_sq_tail;
+		while (tail - __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE) == _sq_entries)
+			//full: submit from here rather than wait for the reactor thread
+			syscall(__NR_io_uring_enter, _ring, _sq_entries, 0, 0, nullptr, 0);
+		io_uring_sqe& sqe = _sqes[tail & _sq_mask];
+		std::memset(&sqe, 0, sizeof(sqe));
+		return sqe;
+	}
+
+	//caller holds _submit_mutex
+	void push_sqe(io_uring_sqe& sqe)
+	{
+		unsigned tail = *_sq_tail;
+		unsigned index = tail & _sq_mask;
+		assert(&sqe == &_sqes[index]);
+		_sq_array[index] = index;
+		__atomic_store_n(_sq_tail, tail + 1, __ATOMIC_RELEASE);
+	}
+
+	//caller holds _submit_mutex; a completion with no request wakes the thread
+	void arm_wake()
+	{
+		io_uring_sqe& sqe = next_sqe();
+		sqe.opcode = IORING_OP_READ;
+		sqe.fd = _wake;
+		sqe.addr = (uint64_t) (std::uintptr_t) &_wake_value;
+		sqe.len = sizeof(_wake_value);
+		sqe.user_data = 0;
+		push_sqe(sqe);
+	}
+
+	//queues the operation, or a poll for its readiness, and suspends until
+	//it completes; returns its result, a negated errno on failure
+	long submit(Operation operation, int fd, void* buffer, Size bytes,
+			sockaddr* address, socklen_t* length, bool poll)
+	{
+		Request request;
+		request.fiber = nullptr;
+		request.result = 0;
+		Scheduler::suspend([&](Fiber* self)
+		{
+			request.fiber = self;
+			std::lock_guard<std::mutex> lock(_submit_mutex);
+			io_uring_sqe& sqe = next_sqe();
+			sqe.fd = fd;
+			if (poll)
+			{
+				sqe.opcode = IORING_OP_POLL_ADD;
+				sqe.poll32_events = operation == WRITE ? POLLOUT : POLLIN;
+			}
+			else if (operation == ACCEPT)
+			{
+				sqe.opcode = IORING_OP_ACCEPT;
+				sqe.addr = (uint64_t) (std::uintptr_t) address;
+				sqe.addr2 = (uint64_t) (std::uintptr_t) length;
+				sqe.accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+			}
+			else
+			{
+				sqe.opcode = operation == READ ? IORING_OP_READ : IORING_OP_WRITE;
+				sqe.addr = (uint64_t) (std::uintptr_t) buffer;
+				sqe.len = (uint32_t) std::min<Size>(bytes, UINT32_MAX);
+				sqe.off = (uint64_t) -1; //the current position, as read(2)
+			}
+			sqe.user_data = (uint64_t) (std::uintptr_t) &request;
+			push_sqe(sqe);
+			if (_sleeping)
+			{
+				_sleeping = false;
+				wake();
+			}
+		});
+		return request.result;
+	}
+
+	void run()
+	{
+		std::vector<Fiber*> woken;
+		while (true)
+		{
+			unsigned pending;
+			{
+				std::lock_guard<std::mutex> lock(_submit_mutex);
+				pending = *_sq_tail - __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE);
+				_sleeping = true;
+			}
+			syscall(__NR_io_uring_enter, _ring, pending, 1,
+					IORING_ENTER_GETEVENTS, nullptr, 0);
+			{
+				std::lock_guard<std::mutex> lock(_submit_mutex);
+				_sleeping = false;
+			}
+			bool woke = false;
+			unsigned head = *_cq_head;
+			unsigned tail = __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE);
+			for (; head != tail; ++head)
+			{
+				const io_uring_cqe& cqe = _cqes[head & _cq_mask];
+				Request* request = (Request*) (std::uintptr_t) cqe.user_data;
+				if (request == nullptr)
+				{
+					woke = true;
+					continue;
+				}
+				request->result = cqe.res;
+				woken.push_back(request->fiber);
+			}
+			__atomic_store_n(_cq_head, head, __ATOMIC_RELEASE);
+			_scheduler->ready(woken.data(), woken.size());
+			woken.clear();
+			if (woke)
+			{
+				if (_stop.load(std::memory_order_acquire))
+					break;
+				std::lock_guard<std::mutex> lock(_submit_mutex);
+				arm_wake();
+			}
+		}
+	}
+
+	//the completion ring gets room for many more operations in flight than
+	//one submission batch, one per parked connection
+	void open()
+	{
+		io_uring_params params;
+		std::memset(&params, 0, sizeof(params));
+		params.flags = IORING_SETUP_CQSIZE;
+		params.cq_entries = (unsigned) std::max<Size>(_batch * 64, 4096);
+		_ring = (int) syscall(__NR_io_uring_setup, (unsigned) _batch, &params);
+		if (_ring < 0)
+			fail("io_uring_setup");
+		if (!(params.features & IORING_FEAT_SINGLE_MMAP))
+		{
+			errno = ENOSYS;
+			fail("io_uring_setup");
+		}
+		_rings_length = std::max<Size>(
+				params.sq_off.array + params.sq_entries * sizeof(unsigned),
+				params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+		_rings = mmap(nullptr, _rings_length, PROT_READ | PROT_WRITE,
+				MAP_SHARED | MAP_POPULATE, _ring, IORING_OFF_SQ_RING);
+		if (_rings == MAP_FAILED)
+			fail("mmap");
+		_sqes_length = params.sq_entries * sizeof(io_uring_sqe);
+		_sqes = (io_uring_sqe*) mmap(nullptr, _sqes_length,
+				PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring,
+				IORING_OFF_SQES);
+		if (_sqes == MAP_FAILED)
+			fail("mmap");
+		char* rings = (char*) _rings;
+		_sq_entries = params.sq_entries;
+		_sq_mask = *(unsigned*) (rings + params.sq_off.ring_mask);
+		_sq_head = (unsigned*) (rings + params.sq_off.head);
+		_sq_tail = (unsigned*) (rings + params.sq_off.tail);
+		_sq_array = (unsigned*) (rings + params.sq_off.array);
+		_cq_mask = *(unsigned*) (rings + params.cq_off.ring_mask);
+		_cq_head = (unsigned*) (rings + params.cq_off.head);
+		_cq_tail = (unsigned*) (rings + params.cq_off.tail);
+		_cqes = (io_uring_cqe*) (rings + params.cq_off.cqes);
+		std::lock_guard<std::mutex> lock(_submit_mutex);
+		arm_wake();
+	}
+
+	void shut() noexcept
+	{
+		if (_sqes != MAP_FAILED)
+			munmap(_sqes, _sqes_length);
+		if (_rings != MAP_FAILED)
+			munmap(_rings, _rings_length);
+		if (_ring >= 0)
+			::close(_ring);
+	}
+#endif
+
+public:
+	//batch bounds the events taken, or operations submitted, per system call
+	explicit Reactor(Scheduler& scheduler, Size batch = 256) :
+			_scheduler(&scheduler), _batch(std::max<Size>(batch, 1)),
+					_wake(-1), _stop(false),
+#if R_REACTOR_BACKEND == R_REACTOR_EPOLL
+					_epoll(-1)
+#else
+					_ring(-1), _rings(MAP_FAILED), _rings_length(0),
+					_sqes((io_uring_sqe*) MAP_FAILED), _sqes_length(0),
+					_sq_entries(0), _sq_mask(0), _sq_head(nullptr),
+					_sq_tail(nullptr), _sq_array(nullptr), _cq_mask(0),
+					_cq_head(nullptr), _cq_tail(nullptr), _cqes(nullptr),
+					_sleeping(false), _wake_value(0)
+#endif
+	{
+		try
+		{
+			_wake = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+			if (_wake < 0)
+				fail("eventfd");
+			open();
+			_thread = std::thread([this]()
+			{
+				run();
+			});
+		}
+		catch (...)
+		{
+			shut();
+			if (_wake >= 0)
+				::close(_wake);
+			throw;
+		}
+	}
+
+	Reactor(const Reactor&) = delete;
+	Reactor& operator=(const Reactor&) = delete;
+
+	~Reactor()
+	{
+		_stop.store(true, std::memory_order_release);
+		wake();
+		_thread.join();
+		shut();
+		::close(_wake);
+	}
+
+	Scheduler& scheduler() const
+	{
+		return *_scheduler;
+	}
+
+	//as read(2); 0 at the end of the stream
+	Size async_read(int fd, void* buffer, Size bytes)
+	{
+		return (Size) perform(READ, fd, buffer, bytes, nullptr, nullptr);
+	}
+
+	//as write(2), so possibly short
+	Size async_write(int fd, const void* buffer, Size bytes)
+	{
+		return (Size) perform(WRITE, fd, (void*) buffer, bytes, nullptr,
+				nullptr);
+	}
+
+	//as accept4(2); the new descriptor is non-blocking and close-on-exec
+	int async_accept(int fd, sockaddr* address = nullptr,
+			socklen_t* length = nullptr)
+	{
+		return (int) perform(ACCEPT, fd, nullptr, 0, address, length);
+	}
+
+	//forgets what the reactor knew of fd, then closes it
+	void close(int fd)
+	{
+#if R_REACTOR_BACKEND == R_REACTOR_EPOLL
+		Interest& entry = interest(fd);
+		{
+			std::lock_guard<std::mutex> lock(entry.mutex);
+			assert(entry.reader == nullptr && entry.writer == nullptr);
+			if (entry.registered)
+				epoll_ctl(_epoll, EPOLL_CTL_DEL, fd, nullptr);
+			entry.registered = false;
+			entry.readable = false;
+			entry.writable = false;
+		}
+#endif
+		::close(fd);
+	}
+};
+
+}
+
+}
+
+}
+
+#endif /* INCLUDE_R_REACTOR_HPP_ */
@@ -0,0 +1,851 @@
+/*
+ * roaring_bitmap.hpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef INCLUDE_R_ROARING_BITMAP_HPP_
+#define INCLUDE_R_ROARING_BITMAP_HPP_
+
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+#include <R/bit_array.hpp>
+
+namespace R
+{
+
+//Compressed bitmap for sparse sets. The universe is split into chunks of
+//2^16 bits; each non-empty chunk is stored as a sorted array of offsets,
+//a dense BitArray or a list of runs, whichever is smallest.
+//Memory and the cost of union/intersection grow with the cardinality,
+//not with the universe.
+class RoaringBitmap
+{
+public:
+	typedef std::size_t Size;
+private:
+	typedef BitArray<uint64_t, 65536> Bits;
+
+	constexpr static Size CHUNK_BITS()
+	{
+		return ((Size) 65536);
+	}
+	//an array above this cardinality is larger than a bitmap
+	constexpr static Size ARRAY_MAX()
+	{
+		return ((Size) 4096);
+	}
+
+	//inclusive range of offsets
+	struct Run
+	{
+		uint16_t start;
+		uint16_t last;
+	};
+
+	enum class Kind
+	{
+		ARRAY, BITMAP, RUN
+	};
+
+	class Chunk
+	{
+	public:
+		Kind kind;
+		Size cardinality;
+		std::vector<uint16_t> array;
+		std::vector<Run> runs;
+		std::unique_ptr<Bits> bits;
+
+		Chunk() :
+				kind(Kind::ARRAY), cardinality(0)
+		{
+		}
+
+		Chunk(const Chunk& source) :
+				kind(source.kind), cardinality(source.cardinality),
+						array(source.array), runs(source.runs)
+		{
+			if (source.bits)
+				bits.reset(new Bits(*source.bits));
+		}
+
+		Chunk(Chunk&& source) = default;
+		Chunk& operator=(Chunk&& source) = default;
+
+		Chunk& operator=(const Chunk& source)
+		{
+			Chunk copy(source);
+			return *this = std::move(copy);
+		}
+
+		Size memory_usage() const
+		{
+			return array.capacity() * sizeof(uint16_t)
+					+ runs.capacity() * sizeof(Run) + (bits ? sizeof(Bits) : 0);
+		}
+
+		bool contains(uint16_t value) const
+		{
+			switch (kind)
+			{
+			case Kind::ARRAY:
+				return std::binary_search(array.begin(), array.end(), value);
+			case Kind::BITMAP:
+				return bits->get_bit(value);
+			default:
+			{
+				auto it = std::upper_bound(runs.begin(), runs.end(), value,
+						[](uint16_t v, const Run& run)
+						{
+							return v < run.start;
+						});
+				return it != runs.begin() && value <= (it - 1)->last;
+			}
+			}
+		}
+
+		template<typename Function>
+		void for_each(Function && fn) const
+		{
+			switch (kind)
+			{
+			case Kind::ARRAY:
+				for (uint16_t value : array)
+					fn((Size) value);
+				break;
+			case Kind::BITMAP:
+				bits->for_each_set_bit(fn);
+				break;
+			default:
+				for (const Run& run : runs)
+					for (Size value = run.start; value <= run.last; ++value)
+						fn(value);
+				break;
+			}
+		}
+
+		//first member >= value, or CHUNK_BITS()
+		Size lower_bound(Size value) const
+		{
+			switch (kind)
+			{
+			case Kind::ARRAY:
+			{
+				auto it = std::lower_bound(array.begin(), array.end(), value);
+				return it == array.end() ? CHUNK_BITS() : *it;
+			}
+			case Kind::BITMAP:
+				return value == 0 ?
+						bits->find_first_set() : bits->find_next_set(value - 1);
+			default:
+				for (const Run& run : runs)
+					if (run.last >= value)
+						return std::max<Size>(run.start, value);
+				return CHUNK_BITS();
+			}
+		}
+
+		Bits to_bits() const
+		{
+			if (kind == Kind::BITMAP)
+				return *bits;
+			Bits ret(false);
+			if (kind == Kind::ARRAY)
+				for (uint16_t value : array)
+					ret.set_bit(value);
+			else
+				for (const Run& run : runs)
+					ret.set_range(run.start, (Size) run.last - run.start + 1);
+			return ret;
+		}
+
+		Size count_runs() const
+		{
+			switch (kind)
+			{
+			case Kind::ARRAY:
+			{
+				Size count = 0;
+				for (Size index = 0; index < array.size(); ++index)
+					if (index == 0 || array[index] != array[index - 1] + 1)
+						++count;
+				return count;
+			}
+			case Kind::BITMAP:
+			{
+				Size count = 0;
+				Size pos = bits->find_first_set();
+				while (pos < CHUNK_BITS())
+				{
+					++count;
+					pos = bits->find_next_zero(pos);
+					if (pos >= CHUNK_BITS())
+						break;
+					pos = bits->find_next_set(pos);
+				}
+				return count;
+			}
+			default:
+				return runs.size();
+			}
+		}
+
+		void become_bitmap(const Bits& source)
+		{
+			kind = Kind::BITMAP;
+			bits.reset(new Bits(source));
+			cardinality = bits->count();
+			std::vector<uint16_t>().swap(array);
+			std::vector<Run>().swap(runs);
+		}
+
+		//Picks the smallest representation for the current contents.
+		void normalize()
+		{
+			Size run_bytes = count_runs() * sizeof(Run);
+			Size array_bytes = cardinality * sizeof(uint16_t);
+			Size bitmap_bytes = sizeof(Bits);
+
+			Kind best = Kind::BITMAP;
+			if (cardinality <= ARRAY_MAX() && array_bytes <= run_bytes)
+				best = Kind::ARRAY;
+			else if (run_bytes < std::min(bitmap_bytes, array_bytes))
+				best = Kind::RUN;
+			if (best == kind)
+				return;
+
+			std::vector<uint16_t> new_array;
+			std::vector<Run> new_runs;
+			if (best == Kind::ARRAY)
+			{
+				new_array.reserve(cardinality);
+				for_each([&new_array](Size value)
+				{
+					new_array.push_back((uint16_t) value);
+				});
+			}
+			else if (best == Kind::RUN)
+			{
+				for_each([&new_runs](Size value)
+				{
+					if (!new_runs.empty() && (Size) new_runs.back().last + 1 == value)
+						new_runs.back().last = (uint16_t) value;
+					else
+						new_runs.push_back(Run { (uint16_t) value, (uint16_t) value });
+				});
+			}
+			else
+			{
+				become_bitmap(to_bits());
+				return;
+			}
+			array.swap(new_array);
+			runs.swap(new_runs);
+			bits.reset();
+			kind = best;
+		}
+
+		//Merges [lo, hi] in place: the touched runs collapse into the first.
+		static void add_runs(std::vector<Run>& runs, Size lo, Size hi)
+		{
+			auto first = std::lower_bound(runs.begin(), runs.end(), lo,
+					[](const Run& run, Size value)
+					{
+						return (Size) run.last + 1 < value;
+					});
+			auto last = first;
+			for (; last != runs.end() && last->start <= hi + 1; ++last)
+			{
+				lo = std::min<Size>(lo, last->start);
+				hi = std::max<Size>(hi, last->last);
+			}
+			if (first == last)
+			{
+				runs.insert(first, Run { (uint16_t) lo, (uint16_t) hi });
+				return;
+			}
+			*first = Run { (uint16_t) lo, (uint16_t) hi };
+			runs.erase(first + 1, last);
+		}
+
+		//One pass over both sorted lists, coalescing touching runs.
+		static void union_runs(const std::vector<Run>& left,
+				const std::vector<Run>& right, std::vector<Run>& ret)
+		{
+			ret.reserve(left.size() + right.size());
+			Size i = 0, j = 0;
+			while (i < left.size() || j < right.size())
+			{
+				const Run& run = (j == right.size()
+						|| (i < left.size() && left[i].start <= right[j].start)) ?
+						left[i++] : right[j++];
+				if (!ret.empty() && (Size) ret.back().last + 1 >= run.start)
+					ret.back().last = std::max(ret.back().last, run.last);
+				else
+					ret.push_back(run);
+			}
+		}
+
+		static void remove_runs(std::vector<Run>& runs, Size lo, Size hi)
+		{
+			std::vector<Run> ret;
+			ret.reserve(runs.size() + 1);
+			for (const Run& run : runs)
+			{
+				if (run.last < lo || run.start > hi)
+				{
+					ret.push_back(run);
+					continue;
+				}
+				if (run.start < lo)
+					ret.push_back(Run { run.start, (uint16_t) (lo - 1) });
+				if (run.last > hi)
+					ret.push_back(Run { (uint16_t) (hi + 1), run.last });
+			}
+			runs.swap(ret);
+		}
+
+		static Size run_cardinality(const std::vector<Run>& runs)
+		{
+			Size total = 0;
+			for (const Run& run : runs)
+				total += (Size) run.last - run.start + 1;
+			return total;
+		}
+
+		bool add(uint16_t value)
+		{
+			switch (kind)
+			{
+			case Kind::ARRAY:
+			{
+				auto it = std::lower_bound(array.begin(), array.end(), value);
+				if (it != array.end() && *it == value)
+					return false;
+				array.insert(it, value);
+				if (++cardinality > ARRAY_MAX())
+					become_bitmap(to_bits());
+				return true;
+			}
+			case Kind::BITMAP:
+				if (bits->get_bit(value))
+					return false;
+				bits->set_bit(value);
+				++cardinality;
+				return true;
+			default:
+				if (contains(value))
+					return false;
+				add_runs(runs, value, value);
+				++cardinality;
+				if (runs.size() * sizeof(Run) > sizeof(Bits))
+					normalize();
+				return true;
+			}
+		}
+
+		bool remove(uint16_t value)
+		{
+			switch (kind)
+			{
+			case Kind::ARRAY:
+			{
+				auto it = std::lower_bound(array.begin(), array.end(), value);
+				if (it == array.end() || *it != value)
+					return false;
+				array.erase(it);
+				--cardinality;
+				return true;
+			}
+			case Kind::BITMAP:
+				if (!bits->get_bit(value))
+					return false;
+				bits->clear_bit(value);
+				if (--cardinality <= ARRAY_MAX())
+					normalize();
+				return true;
+			default:
+				if (!contains(value))
+					return false;
+				remove_runs(runs, value, value);
+				--cardinality;
+				if (runs.size() * sizeof(Run) > sizeof(Bits))
+					normalize();
+				return true;
+			}
+		}
+
+		void add_range(Size lo, Size hi)
+		{
+			if (kind != Kind::RUN)
+			{
+				Bits merged = to_bits();
+				merged.set_range(lo, hi - lo + 1);
+				become_bitmap(merged);
+			}
+			else
+			{
+				add_runs(runs, lo, hi);
+				cardinality = run_cardinality(runs);
+			}
+			normalize();
+		}
+
+		void remove_range(Size lo, Size hi)
+		{
+			switch (kind)
+			{
+			case Kind::ARRAY:
+				array.erase(std::lower_bound(array.begin(), array.end(), lo),
+						std::upper_bound(array.begin(), array.end(), hi));
+				cardinality = array.size();
+				break;
+			case Kind::BITMAP:
+				bits->clear_range(lo, hi - lo + 1);
+				cardinality = bits->count();
+				break;
+			default:
+				remove_runs(runs, lo, hi);
+				cardinality = run_cardinality(runs);
+				break;
+			}
+			normalize();
+		}
+
+		void union_with(const Chunk& other)
+		{
+			if (kind == Kind::ARRAY && other.kind == Kind::ARRAY)
+			{
+				std::vector<uint16_t> merged;
+				merged.reserve(array.size() + other.array.size());
+				std::set_union(array.begin(), array.end(), other.array.begin(),
+						other.array.end(), std::back_inserter(merged));
+				array.swap(merged);
+				cardinality = array.size();
+				if (cardinality > ARRAY_MAX())
+					become_bitmap(to_bits());
+				return;
+			}
+			if (kind == Kind::RUN && other.kind == Kind::RUN)
+			{
+				std::vector<Run> merged;
+				union_runs(runs, other.runs, merged);
+				runs.swap(merged);
+				cardinality = run_cardinality(runs);
+				normalize();
+				return;
+			}
+			Bits merged = to_bits();
+			if (other.kind == Kind::BITMAP)
+				merged.merge(*other.bits);
+			else if (other.kind == Kind::ARRAY)
+				for (uint16_t value : other.array)
+					merged.set_bit(value);
+			else
+				for (const Run& run : other.runs)
+					merged.set_range(run.start, (Size) run.last - run.start + 1);
+			become_bitmap(merged);
+			normalize();
+		}
+
+		void intersect_with(const Chunk& other)
+		{
+			if (kind == Kind::ARRAY || other.kind == Kind::ARRAY)
+			{
+				const Chunk& list = (kind == Kind::ARRAY) ? *this : other;
+				const Chunk& filter = (kind == Kind::ARRAY) ? other : *this;
+				std::vector<uint16_t> kept;
+				kept.reserve(list.array.size());
+				for (uint16_t value : list.array)
+					if (filter.contains(value))
+						kept.push_back(value);
+				array.swap(kept);
+				std::vector<Run>().swap(runs);
+				bits.reset();
+				kind = Kind::ARRAY;
+				cardinality = array.size();
+				return;
+			}
+			if (kind == Kind::RUN && other.kind == Kind::RUN)
+			{
+				std::vector<Run> kept;
+				Size i = 0, j = 0;
+				while (i < runs.size() && j < other.runs.size())
+				{
+					Size lo = std::max(runs[i].start, other.runs[j].start);
+					Size hi = std::min(runs[i].last, other.runs[j].last);
+					if (lo <= hi)
+						kept.push_back(Run { (uint16_t) lo, (uint16_t) hi });
+					if (runs[i].last < other.runs[j].last)
+						++i;
+					else
+						++j;
+				}
+				runs.swap(kept);
+				cardinality = run_cardinality(runs);
+				normalize();
+				return;
+			}
+			Bits kept = to_bits();
+			kept.intersect(other.kind == Kind::BITMAP ? *other.bits : other.to_bits());
+			become_bitmap(kept);
+			normalize();
+		}
+
+		bool collides(const Chunk& other) const
+		{
+			if (kind == Kind::ARRAY || other.kind == Kind::ARRAY)
+			{
+				const Chunk& list = (kind == Kind::ARRAY) ? *this : other;
+				const Chunk& filter = (kind == Kind::ARRAY) ? other : *this;
+				for (uint16_t value : list.array)
+					if (filter.contains(value))
+						return true;
+				return false;
+			}
+			if (kind == Kind::BITMAP && other.kind == Kind::BITMAP)
+				return bits->is_collide(*other.bits);
+			if (kind == Kind::RUN && other.kind == Kind::RUN)
+			{
+				Size i = 0, j = 0;
+				while (i < runs.size() && j < other.runs.size())
+				{
+					if (std::max(runs[i].start, other.runs[j].start)
+							<= std::min(runs[i].last, other.runs[j].last))
+						return true;
+					if (runs[i].last < other.runs[j].last)
+						++i;
+					else
+						++j;
+				}
+				return false;
+			}
+			const Chunk& ranged = (kind == Kind::RUN) ? *this : other;
+			const Chunk& dense = (kind == Kind::RUN) ? other : *this;
+			for (const Run& run : ranged.runs)
+				if (dense.lower_bound(run.start) <= run.last)
+					return true;
+			return false;
+		}
+
+		bool equals(const Chunk& other) const
+		{
+			if (cardinality != other.cardinality)
+				return false;
+			if (kind == Kind::ARRAY && other.kind == Kind::ARRAY)
+				return array == other.array;
+			return to_bits() == other.to_bits();
+		}
+	};
+
+	typedef std::pair<Size, Chunk> Entry;
+	std::vector<Entry> _chunks;
+
+	std::vector<Entry>::iterator find_chunk(Size key)
+	{
+		return std::lower_bound(_chunks.begin(), _chunks.end(), key,
+				[](const Entry& entry, Size k)
+				{
+					return entry.first < k;
+				});
+	}
+
+	std::vector<Entry>::const_iterator find_chunk(Size key) const
+	{
+		return std::lower_bound(_chunks.begin(), _chunks.end(), key,
+				[](const Entry& entry, Size k)
+				{
+					return entry.first < k;
+				});
+	}
+
+	Chunk& chunk_for(Size key)
+	{
+		auto it = find_chunk(key);
+		if (it == _chunks.end() || it->first != key)
+			it = _chunks.insert(it, Entry(key, Chunk()));
+		return it->second;
+	}
+
+	void drop_empty()
+	{
+		_chunks.erase(std::remove_if(_chunks.begin(), _chunks.end(),
+				[](const Entry& entry)
+				{
+					return entry.second.cardinality == 0;
+				}), _chunks.end());
+	}
+
+public:
+	RoaringBitmap()
+	{
+	}
+
+	//builds from any dense bitmap with size-independent for_each_set_bit
+	template<typename Dense>
+	static RoaringBitmap from_dense(const Dense& dense)
+	{
+		RoaringBitmap ret;
+		dense.for_each_set_bit([&ret](Size index)
+		{
+			Size key = index / CHUNK_BITS();
+			if (ret._chunks.empty() || ret._chunks.back().first != key)
+				ret._chunks.push_back(Entry(key, Chunk()));
+			Chunk& chunk = ret._chunks.back().second;
+			//indices arrive in order, so appending keeps the array sorted
+			if (chunk.kind == Kind::ARRAY)
+			{
+				chunk.array.push_back((uint16_t) (index % CHUNK_BITS()));
+				if (++chunk.cardinality > ARRAY_MAX())
+					chunk.become_bitmap(chunk.to_bits());
+			}
+			else
+				chunk.add((uint16_t) (index % CHUNK_BITS()));
+		});
+		ret.optimize();
+		return ret;
+	}
+
+	//Sets the members in a dense bitmap (BitArray or BitVector) which must
+	//already be large enough and is not cleared first.
+	template<typename Dense>
+	void to_dense(Dense& dense) const
+	{
+		for (const Entry& entry : _chunks)
+		{
+			Size base = entry.first * CHUNK_BITS();
+			const Chunk& chunk = entry.second;
+			if (chunk.kind == Kind::RUN)
+				for (const Run& run : chunk.runs)
+					dense.set_range(base + run.start,
+							(Size) run.last - run.start + 1);
+			else
+				chunk.for_each([&dense, base](Size value)
+				{
+					dense.set_bit(base + value);
+				});
+		}
+	}
+
+	bool get_bit(Size index) const
+	{
+		auto it = find_chunk(index / CHUNK_BITS());
+		if (it == _chunks.end() || it->first != index / CHUNK_BITS())
+			return false;
+		return it->second.contains((uint16_t) (index % CHUNK_BITS()));
+	}
+
+	void set_bit(Size index)
+	{
+		chunk_for(index / CHUNK_BITS()).add((uint16_t) (index % CHUNK_BITS()));
+	}
+
+	void clear_bit(Size index)
+	{
+		auto it = find_chunk(index / CHUNK_BITS());
+		if (it == _chunks.end() || it->first != index / CHUNK_BITS())
+			return;
+		it->second.remove((uint16_t) (index % CHUNK_BITS()));
+		if (it->second.cardinality == 0)
+			_chunks.erase(it);
+	}
+
+	void set_range(Size start, Size length)
+	{
+		Size end = start + length;
+		while (start < end)
+		{
+			Size key = start / CHUNK_BITS();
+			Size lo = start % CHUNK_BITS();
+			Size hi = std::min(end - key * CHUNK_BITS(), CHUNK_BITS()) - 1;
+			Chunk& chunk = chunk_for(key);
+			if (lo == 0 && hi == CHUNK_BITS() - 1)
+			{
+				chunk = Chunk();
+				chunk.kind = Kind::RUN;
+				chunk.runs.push_back(Run { 0, (uint16_t) hi });
+				chunk.cardinality = CHUNK_BITS();
+			}
+			else
+				chunk.add_range(lo, hi);
+			start = key * CHUNK_BITS() + hi + 1;
+		}
+	}
+
+	void clear_range(Size start, Size length)
+	{
+		Size end = start + length;
+		while (start < end)
+		{
+			Size key = start / CHUNK_BITS();
+			Size lo = start % CHUNK_BITS();
+			Size hi = std::min(end - key * CHUNK_BITS(), CHUNK_BITS()) - 1;
+			auto it = find_chunk(key);
+			if (it != _chunks.end() && it->first == key)
+				it->second.remove_range(lo, hi);
+			start = key * CHUNK_BITS() + hi + 1;
+		}
+		drop_empty();
+	}
+
+	void clear()
+	{
+		_chunks.clear();
+	}
+
+	Size count() const
+	{
+		Size total = 0;
+		for (const Entry& entry : _chunks)
+			total += entry.second.cardinality;
+		return total;
+	}
+
+	bool empty() const
+	{
+		return _chunks.empty();
+	}
+
+	//number of non-empty 2^16-bit chunks
+	Size chunks() const
+	{
+		return _chunks.size();
+	}
+
+	//bytes held by the containers and the chunk index
+	Size memory_usage() const
+	{
+		Size total = _chunks.capacity() * sizeof(Entry);
+		for (const Entry& entry : _chunks)
+			total += entry.second.memory_usage();
+		return total;
+	}
+
+	//Converts chunks to runs where that is smaller and releases slack.
+	void optimize()
+	{
+		for (Entry& entry : _chunks)
+		{
+			entry.second.normalize();
+			entry.second.array.shrink_to_fit();
+			entry.second.runs.shrink_to_fit();
+		}
+		_chunks.shrink_to_fit();
+	}
+
+	//first member >= start, or the maximum Size if none
+	Size lower_bound(Size start) const
+	{
+		for (auto it = find_chunk(start / CHUNK_BITS()); it != _chunks.end(); ++it)
+		{
+			Size base = it->first * CHUNK_BITS();
+			Size from = (start > base) ? start - base : 0;
+			Size found = it->second.lower_bound(from);
+			if (found < CHUNK_BITS())
+				return base + found;
+		}
+		return ~(Size) 0;
+	}
+
+	template<typename Function>
+	void for_each_set_bit(Function && fn) const
+	{
+		for (const Entry& entry : _chunks)
+		{
+			Size base = entry.first * CHUNK_BITS();
+			entry.second.for_each([&fn, base](Size value)
+			{
+				fn(base + value);
+			});
+		}
+	}
+
+	void merge(const RoaringBitmap& other)
+	{
+		std::vector<Entry> merged;
+		merged.reserve(_chunks.size() + other._chunks.size());
+		auto i = _chunks.begin();
+		auto j = other._chunks.begin();
+		while (i != _chunks.end() || j != other._chunks.end())
+		{
+			if (j == other._chunks.end()
+					|| (i != _chunks.end() && i->first < j->first))
+				merged.push_back(std::move(*i++));
+			else if (i == _chunks.end() || j->first < i->first)
+				merged.push_back(*j++);
+			else
+			{
+				i->second.union_with(j->second);
+				merged.push_back(std::move(*i++));
+				++j;
+			}
+		}
+		_chunks.swap(merged);
+	}
+
+	void intersect(const RoaringBitmap& other)
+	{
+		std::vector<Entry> kept;
+		auto j = other._chunks.begin();
+		for (Entry& entry : _chunks)
+		{
+			while (j != other._chunks.end() && j->first < entry.first)
+				++j;
+			if (j == other._chunks.end())
+				break;
+			if (j->first != entry.first)
+				continue;
+			entry.second.intersect_with(j->second);
+			if (entry.second.cardinality > 0)
+				kept.push_back(std::move(entry));
+		}
+		_chunks.swap(kept);
+	}
+
+	bool is_collide(const RoaringBitmap& other) const
+	{
+		auto i = _chunks.begin();
+		auto j = other._chunks.begin();
+		while (i != _chunks.end() && j != other._chunks.end())
+		{
+			if (i->first < j->first)
+				++i;
+			else if (j->first < i->first)
+				++j;
+			else
+			{
+				if (i->second.collides(j->second))
+					return true;
+				++i;
+				++j;
+			}
+		}
+		return false;
+	}
+
+	bool operator==(const RoaringBitmap& other) const
+	{
+		if (_chunks.size() != other._chunks.size())
+			return false;
+		for (Size index = 0; index < _chunks.size(); ++index)
+			if (_chunks[index].first != other._chunks[index].first
+					|| !_chunks[index].second.equals(other._chunks[index].second))
+				return false;
+		return true;
+	}
+
+	bool operator!=(const RoaringBitmap& other) const
+	{
+		return !(*this == other);
+	}
+};
+
+}
+
+#endif /* INCLUDE_R_ROARING_BITMAP_HPP_ */
@@ -0,0 +1,801 @@
+/*
+ * scheduler.hpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef INCLUDE_R_SCHEDULER_HPP_
+#define INCLUDE_R_SCHEDULER_HPP_
+
+#include <cstdint>
+#include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <R/context_switch.hpp>
+#include <R/stack_pool.hpp>
+#include <R/timing_wheel.hpp>
+#include <R/work_stealing_deque.hpp>
+
+#if R_COROUTINE_BACKEND == R_COROUTINE_THREAD \
+		|| R_COROUTINE_BACKEND == R_COROUTINE_STACKLESS
+#error "Scheduler needs a stackful user-space coroutine backend"
+#endif
+
+//resolution of fiber timers
+#ifndef R_TIMER_TICK_US
+#define R_TIMER_TICK_US 1000
+#endif
+
+namespace R
+{
+
+inline namespace R_COROUTINE_NAMESPACE
+{
+
+class Scheduler;
+
+//A coroutine run by a Scheduler. Fibers are created by Scheduler::spawn
+//and referenced through Task handles.
+class Fiber
+{
+private:
+	Scheduler* _scheduler;
+	context_switch::Handle _context;
+	StackPool::Stack _stack;
+	std::function<void(void)> _body;
+	std::exception_ptr _exception;
+	std::atomic<int> _references;
+	std::mutex _mutex;
+	std::condition_variable _finished_cv; //threads joining from outside
+	int _outside_joiners;
+	bool _finished;
+	Fiber* _joiners;
+
+	friend class Scheduler;
+	friend class Task;
+
+	template<typename Function>
+	Fiber(Scheduler* scheduler, Function && fn) :
+			_scheduler(scheduler), _context(nullptr), _stack(),
+					_body(std::forward<Function>(fn)), _references(2),
+					_outside_joiners(0), _finished(false), _joiners(nullptr),
+					link(nullptr)
+	{
+	}
+
+	static void release(Fiber* fiber)
+	{
+		if (fiber->_references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			delete fiber;
+	}
+
+public:
+	//free for the wait list that holds the fiber while it is suspended
+	Fiber* link;
+
+	Scheduler& scheduler() const
+	{
+		return *_scheduler;
+	}
+};
+
+//Shared handle to a spawned fiber; join() waits for it to finish.
+class Task
+{
+private:
+	Fiber* _fiber;
+
+	friend class Scheduler;
+
+	//adopts a reference
+	explicit Task(Fiber* fiber) :
+			_fiber(fiber)
+	{
+	}
+
+public:
+	Task() :
+			_fiber(nullptr)
+	{
+	}
+
+	Task(const Task& other) :
+			_fiber(other._fiber)
+	{
+		if (_fiber != nullptr)
+			_fiber->_references.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	Task(Task&& other) noexcept :
+			_fiber(other._fiber)
+	{
+		other._fiber = nullptr;
+	}
+
+	Task& operator=(Task other) noexcept
+	{
+		std::swap(_fiber, other._fiber);
+		return *this;
+	}
+
+	~Task()
+	{
+		if (_fiber != nullptr)
+			Fiber::release(_fiber);
+	}
+
+	explicit operator bool() const
+	{
+		return _fiber != nullptr;
+	}
+
+	bool done() const
+	{
+		std::lock_guard<std::mutex> lock(_fiber->_mutex);
+		return _fiber->_finished;
+	}
+
+	//see Scheduler::join
+	void join() const;
+};
+
+//M:N scheduler running fibers on a fixed set of worker threads.
+//
+//Every worker owns a Chase-Lev deque: fibers spawned or woken on a
+//worker go to its bottom and the worker pops the newest first, so a
+//child runs while its parent's data is still in cache. A worker out of
+//work steals the oldest fiber of a random victim, and takes the fibers
+//handed in from outside the pool from a shared queue, which is also
+//polled every 61 rounds so it cannot starve. Workers that find nothing
+//park on a condition variable and are woken by the next push.
+//
+//Blocking primitives build on suspend(hook) and ready(fiber): suspend
+//switches to the worker, which then calls hook(fiber) to file the fiber
+//away; whoever completes the wait later passes it to ready().
+//
+//Timers live in hierarchical TimingWheels of R_TIMER_TICK_US ticks, one
+//per worker, each under its own lock. An alarm goes into the wheel of
+//the worker that arms it (by address from outside the pool), so workers
+//arming and disarming timeouts do not contend. A timer thread, started
+//with the first alarm, sleeps until the earliest tick any wheel holds,
+//then advances the wheels one by one and hands every fiber due by then
+//to the workers in one batch, as the Reactor does with completions. An
+//alarm wakes it only when it is due before that tick.
+//
+//A fiber may resume on another thread after any suspension, so it must
+//not hold thread_local state or a mutex, or sit in a catch block, across
+//one. The destructor waits for every spawned fiber to finish.
+class Scheduler
+{
+public:
+	typedef std::size_t Size;
+	typedef std::chrono::steady_clock Clock;
+
+	//Readies fiber at a deadline, once armed. With winner set, the alarm
+	//only does so if it is first to swap its own address in, so that it
+	//can race whatever else may end the wait.
+	struct Alarm : public TimingWheel::Timer
+	{
+		Fiber* fiber;
+		std::atomic<void*>* winner;
+		Size shard; //the wheel it was armed in
+
+		Alarm() :
+				fiber(nullptr), winner(nullptr), shard(0)
+		{
+		}
+
+		bool claim()
+		{
+			void* none = nullptr;
+			return winner == nullptr
+					|| winner->compare_exchange_strong(none, (void*) this,
+							std::memory_order_acq_rel);
+		}
+	};
+private:
+	typedef void (*Hook)(Fiber*, void*);
+
+	//Padding, not alignas, since shards are allocated with new before
+	//C++17.
+	struct TimerShard
+	{
+		std::mutex mutex;
+		TimingWheel wheel;
+		char padding[CACHE_LINE_SIZE];
+	};
+
+	struct Worker
+	{
+		Scheduler* scheduler;
+		Size index;
+		WorkStealingDeque<Fiber*> deque;
+		context_switch::Handle home;
+		Fiber* current;
+		Hook after; //what to do with current once it switched out
+		void* after_argument;
+		uint64_t random;
+		Size tick;
+		bool fifo_next; //take the oldest local fiber next, after a yield
+		std::thread thread;
+
+		Worker(Scheduler* owner, Size index) :
+				scheduler(owner), index(index), home(nullptr), current(nullptr),
+						after(nullptr), after_argument(nullptr),
+						random(0x9E3779B97F4A7C15ULL * (index + 1)), tick(0),
+						fifo_next(false)
+		{
+		}
+	};
+
+	std::vector<std::unique_ptr<Worker>> _workers;
+	StackPool* _pool;
+	Size _stack_size;
+
+	std::mutex _inject_mutex;
+	std::deque<Fiber*> _injected;
+	std::atomic<Size> _injected_count;
+
+	std::atomic<Size> _sleepers;
+	std::atomic<Size> _live;
+	std::mutex _park_mutex;
+	std::condition_variable _park;
+	std::condition_variable _drained;
+	uint64_t _epoch; //bumped under _park_mutex by every wake-up
+	bool _stop;
+
+	std::vector<std::unique_ptr<TimerShard>> _timer_shards;
+	std::mutex _timer_mutex; //the timer thread's sleep
+	std::condition_variable _timer_wake;
+	Clock::time_point _start;
+	//the tick the timer thread waits for, all ones while it scans
+	std::atomic<TimingWheel::Tick> _timer_sleep;
+	std::atomic<bool> _timer_started;
+	bool _timer_stop;
+	std::thread _timer_thread;
+
+	//never inlined, so a fiber that moved to another thread between two
+	//calls does not reuse the address of the old thread's slot
+	__attribute__((noinline))
+	static Worker*& worker_slot()
+	{
+		static thread_local Worker* worker = nullptr;
+		return worker;
+	}
+
+	static Worker* current_worker()
+	{
+		return worker_slot();
+	}
+
+	static void entry(void* data)
+	{
+		Fiber* fiber = (Fiber*) data;
+		try
+		{
+			fiber->_body();
+		}
+		catch (...)
+		{
+			fiber->_exception = std::current_exception();
+		}
+		Worker* worker = current_worker();
+		worker->after = finish;
+		context_switch::jump(&fiber->_context, worker->home, nullptr);
+	}
+
+	//runs on the worker once the finished fiber left its stack
+	static void finish(Fiber* fiber, void*)
+	{
+		Scheduler* scheduler = fiber->_scheduler;
+		Fiber* joiners;
+		bool outside;
+		{
+			std::lock_guard<std::mutex> lock(fiber->_mutex);
+			fiber->_finished = true;
+			joiners = fiber->_joiners;
+			fiber->_joiners = nullptr;
+			outside = fiber->_outside_joiners > 0;
+		}
+		if (outside)
+			fiber->_finished_cv.notify_all();
+		while (joiners != nullptr)
+		{
+			Fiber* next = joiners->link;
+			ready(joiners);
+			joiners = next;
+		}
+		fiber->_body = nullptr;
+		scheduler->_pool->deallocate(fiber->_stack);
+		Fiber::release(fiber);
+		if (scheduler->_live.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			std::lock_guard<std::mutex> lock(scheduler->_park_mutex);
+			scheduler->_drained.notify_all();
+		}
+	}
+
+	static void requeue(Fiber* fiber, void*)
+	{
+		Worker* worker = current_worker();
+		worker->fifo_next = true;
+		worker->deque.push(fiber);
+	}
+
+	void run(Worker& worker, Fiber* fiber)
+	{
+		worker.current = fiber;
+		context_switch::jump(&worker.home, fiber->_context, fiber);
+		worker.current = nullptr;
+		Hook after = worker.after;
+		worker.after = nullptr;
+		after(fiber, worker.after_argument);
+	}
+
+	//wakes a parked worker if there is one, every parked one for several
+	//fibers
+	void notify(Size fibers = 1)
+	{
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (_sleepers.load(std::memory_order_relaxed) == 0)
+			return;
+		{
+			std::lock_guard<std::mutex> lock(_park_mutex);
+			++_epoch;
+		}
+		if (fibers > 1)
+			_park.notify_all();
+		else
+			_park.notify_one();
+	}
+
+	void schedule(Fiber* fiber)
+	{
+		Worker* worker = current_worker();
+		if (worker != nullptr && worker->scheduler == this)
+			worker->deque.push(fiber);
+		else
+		{
+			std::lock_guard<std::mutex> lock(_inject_mutex);
+			_injected.push_back(fiber);
+			_injected_count.fetch_add(1, std::memory_order_release);
+		}
+		notify();
+	}
+
+	bool take_injected(Fiber*& fiber)
+	{
+		if (_injected_count.load(std::memory_order_acquire) == 0)
+			return false;
+		std::lock_guard<std::mutex> lock(_inject_mutex);
+		if (_injected.empty())
+			return false;
+		fiber = _injected.front();
+		_injected.pop_front();
+		_injected_count.fetch_sub(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	bool steal(Worker& worker, Fiber*& fiber)
+	{
+		Size workers = _workers.size();
+		worker.random ^= worker.random << 13;
+		worker.random ^= worker.random >> 7;
+		worker.random ^= worker.random << 17;
+		Size start = (Size) (worker.random % workers);
+		for (Size index = 0; index < workers; ++index)
+		{
+			Worker& victim = *_workers[(start + index) % workers];
+			if (&victim != &worker && victim.deque.steal(fiber))
+				return true;
+		}
+		return false;
+	}
+
+	bool find(Worker& worker, Fiber*& fiber)
+	{
+		bool fifo = worker.fifo_next;
+		worker.fifo_next = false;
+		if ((++worker.tick % 61 == 0 || fifo) && take_injected(fiber))
+			return true;
+		if (fifo && worker.deque.steal(fiber))
+			return true;
+		return worker.deque.pop(fiber) || take_injected(fiber)
+				|| steal(worker, fiber);
+	}
+
+	bool has_work() const
+	{
+		if (_injected_count.load(std::memory_order_seq_cst) > 0)
+			return true;
+		for (const std::unique_ptr<Worker>& worker : _workers)
+			if (!worker->deque.empty())
+				return true;
+		return false;
+	}
+
+	//Sleeps until the next wake-up. The sleeper count goes up before the
+	//last look for work and pushes read it after publishing theirs, so
+	//either the push sees the sleeper or the sleeper sees the fiber.
+	bool park()
+	{
+		uint64_t epoch;
+		{
+			std::lock_guard<std::mutex> lock(_park_mutex);
+			if (_stop)
+				return false;
+			epoch = _epoch;
+		}
+		_sleepers.fetch_add(1, std::memory_order_seq_cst);
+		if (!has_work())
+		{
+			std::unique_lock<std::mutex> lock(_park_mutex);
+			_park.wait(lock, [this, epoch]()
+			{
+				return _epoch != epoch || _stop;
+			});
+		}
+		_sleepers.fetch_sub(1, std::memory_order_seq_cst);
+		return true;
+	}
+
+	void work(Worker& worker)
+	{
+		worker_slot() = &worker;
+		Fiber* fiber;
+		while (true)
+		{
+			if (find(worker, fiber))
+				run(worker, fiber);
+			else if (!park())
+				break;
+		}
+		worker_slot() = nullptr;
+	}
+
+	static TimingWheel::Tick tick(Clock::duration duration)
+	{
+		return (TimingWheel::Tick) (std::chrono::duration_cast<
+				std::chrono::microseconds>(duration).count() / R_TIMER_TICK_US);
+	}
+
+	//Alarms are inserted before _timer_sleep is read and the wheels are
+	//looked at after it is set, so either the thread sees a new alarm or
+	//the alarm sees the tick the thread sleeps for and wakes it.
+	void tick_timers()
+	{
+		std::vector<Fiber*> woken;
+		std::unique_lock<std::mutex> lock(_timer_mutex);
+		while (!_timer_stop)
+		{
+			_timer_sleep.store(~(TimingWheel::Tick) 0);
+			TimingWheel::Tick now = tick(Clock::now() - _start);
+			for (std::unique_ptr<TimerShard>& shard : _timer_shards)
+			{
+				std::lock_guard<std::mutex> guard(shard->mutex);
+				shard->wheel.advance(now, [&woken](TimingWheel::Timer* timer)
+				{
+					Alarm* alarm = (Alarm*) timer;
+					if (alarm->claim())
+						woken.push_back(alarm->fiber);
+				});
+			}
+			if (!woken.empty())
+			{
+				lock.unlock();
+				ready(woken.data(), woken.size());
+				woken.clear();
+				lock.lock();
+				continue;
+			}
+			TimingWheel::Tick next = ~(TimingWheel::Tick) 0;
+			for (std::unique_ptr<TimerShard>& shard : _timer_shards)
+			{
+				std::lock_guard<std::mutex> guard(shard->mutex);
+				TimingWheel::Tick due;
+				if (shard->wheel.next(due))
+					next = std::min(next, due);
+			}
+			_timer_sleep.store(next);
+			if (next != ~(TimingWheel::Tick) 0)
+				_timer_wake.wait_until(lock,
+						_start + std::chrono::microseconds(
+								next * R_TIMER_TICK_US));
+			else
+				_timer_wake.wait(lock);
+		}
+	}
+
+public:
+	static Size default_threads()
+	{
+		Size threads = std::thread::hardware_concurrency();
+		return threads > 0 ? threads : 1;
+	}
+
+	//stack_size is the default for spawn; stacks come from pool
+	explicit Scheduler(Size threads = default_threads(), Size stack_size =
+			R_COROUTINE_STACK_SIZE, StackPool& pool = default_stack_pool()) :
+			_pool(&pool), _stack_size(stack_size), _injected_count(0),
+					_sleepers(0), _live(0), _epoch(0), _stop(false),
+					_start(Clock::now()), _timer_sleep(~(TimingWheel::Tick) 0),
+					_timer_started(false), _timer_stop(false)
+	{
+		for (Size index = 0; index < std::max<Size>(1, threads); ++index)
+		{
+			_workers.emplace_back(new Worker(this, index));
+			_timer_shards.emplace_back(new TimerShard());
+		}
+		for (std::unique_ptr<Worker>& worker : _workers)
+		{
+			Worker* target = worker.get();
+			worker->thread = std::thread([this, target]()
+			{
+				work(*target);
+			});
+		}
+	}
+
+	Scheduler(const Scheduler&) = delete;
+	Scheduler& operator=(const Scheduler&) = delete;
+
+	~Scheduler()
+	{
+		{
+			std::unique_lock<std::mutex> lock(_park_mutex);
+			_drained.wait(lock, [this]()
+			{
+				return _live.load(std::memory_order_acquire) == 0;
+			});
+			_stop = true;
+			++_epoch;
+		}
+		_park.notify_all();
+		for (std::unique_ptr<Worker>& worker : _workers)
+			worker->thread.join();
+		{
+			std::lock_guard<std::mutex> lock(_timer_mutex);
+			_timer_stop = true;
+		}
+		_timer_wake.notify_one();
+		if (_timer_thread.joinable())
+			_timer_thread.join();
+	}
+
+	Size size() const
+	{
+		return _workers.size();
+	}
+
+	//Starts fn() on a fiber. From a fiber of this scheduler the new one is
+	//queued on the same worker, from anywhere else on the shared queue.
+	template<typename Function>
+	Task spawn(Function && fn, Size stack_size = 0)
+	{
+		Fiber* fiber = new Fiber(this, std::forward<Function>(fn));
+		try
+		{
+			fiber->_stack = _pool->allocate(
+					stack_size != 0 ? stack_size : _stack_size);
+		}
+		catch (...)
+		{
+			delete fiber;
+			throw;
+		}
+		fiber->_context = context_switch::make(fiber->_stack.base,
+				fiber->_stack.size, entry);
+		_live.fetch_add(1, std::memory_order_relaxed);
+		schedule(fiber);
+		return Task(fiber);
+	}
+
+	//the running fiber, nullptr outside of fibers
+	static Fiber* current()
+	{
+		Worker* worker = current_worker();
+		return worker != nullptr ? worker->current : nullptr;
+	}
+
+	//Switches the running fiber out, then calls hook(fiber) on the worker.
+	//The hook must hand the fiber to ready() now or later.
+	template<typename Function>
+	static void suspend(Function && hook)
+	{
+		typedef typename std::remove_reference<Function>::type Type;
+		Worker* worker = current_worker();
+		assert(worker != nullptr && worker->current != nullptr);
+		Fiber* fiber = worker->current;
+		worker->after = [](Fiber* suspended, void* argument)
+		{
+			(*(Type*) argument)(suspended);
+		};
+		worker->after_argument = (void*) std::addressof(hook);
+		context_switch::jump(&fiber->_context, worker->home, nullptr);
+	}
+
+	//makes a suspended fiber runnable again; callable from any thread
+	static void ready(Fiber* fiber)
+	{
+		fiber->_scheduler->schedule(fiber);
+	}
+
+	//Makes several suspended fibers of this scheduler runnable at once,
+	//taking the shared queue's lock and waking the workers once for all.
+	void ready(Fiber* const * fibers, Size count)
+	{
+		if (count == 0)
+			return;
+		Worker* worker = current_worker();
+		if (worker != nullptr && worker->scheduler == this)
+			for (Size index = 0; index < count; ++index)
+				worker->deque.push(fibers[index]);
+		else
+		{
+			std::lock_guard<std::mutex> lock(_inject_mutex);
+			_injected.insert(_injected.end(), fibers, fibers + count);
+			_injected_count.fetch_add(count, std::memory_order_release);
+		}
+		notify(count);
+	}
+
+	//Lets the other runnable fibers of this worker go first. Outside of a
+	//fiber it yields the thread.
+	static void yield_to_scheduler()
+	{
+		if (current() == nullptr)
+		{
+			std::this_thread::yield();
+			return;
+		}
+		Worker* worker = current_worker();
+		Fiber* fiber = worker->current;
+		worker->after = requeue;
+		context_switch::jump(&fiber->_context, worker->home, nullptr);
+	}
+
+	//Queues alarm to ready its fiber at deadline, rounded up to a tick;
+	//thread safe. The fiber must be suspended by then, so alarms are best
+	//armed from the hook of suspend().
+	void arm(Alarm& alarm, Clock::time_point deadline)
+	{
+		Clock::duration delay = deadline - _start;
+		TimingWheel::Tick due = delay > Clock::duration::zero() ?
+				tick(delay + std::chrono::microseconds(R_TIMER_TICK_US)
+						- Clock::duration(1)) : 0;
+		if (!_timer_started.load(std::memory_order_acquire))
+		{
+			std::lock_guard<std::mutex> lock(_timer_mutex);
+			if (!_timer_thread.joinable())
+				_timer_thread = std::thread([this]()
+				{
+					tick_timers();
+				});
+			_timer_started.store(true, std::memory_order_release);
+		}
+		Worker* worker = current_worker();
+		Size shard = (worker != nullptr && worker->scheduler == this) ?
+				worker->index :
+				(Size) (((uintptr_t) &alarm / sizeof(Alarm))
+						% _timer_shards.size());
+		alarm.shard = shard;
+		{
+			//the alarm may go off, and be gone, once this lock is dropped
+			std::lock_guard<std::mutex> lock(_timer_shards[shard]->mutex);
+			_timer_shards[shard]->wheel.insert(&alarm, due);
+		}
+		if (due < _timer_sleep.load())
+		{
+			std::lock_guard<std::mutex> lock(_timer_mutex);
+			_timer_wake.notify_one();
+		}
+	}
+
+	//Takes back an alarm that has not gone off; false if it had. Either
+	//way the timer thread is done with it on return.
+	bool disarm(Alarm& alarm)
+	{
+		TimerShard& shard = *_timer_shards[alarm.shard];
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		return shard.wheel.cancel(&alarm);
+	}
+
+	//pending alarms
+	Size timers()
+	{
+		Size total = 0;
+		for (std::unique_ptr<TimerShard>& shard : _timer_shards)
+		{
+			std::lock_guard<std::mutex> lock(shard->mutex);
+			total += shard->wheel.size();
+		}
+		return total;
+	}
+
+	//Suspends the running fiber until deadline, without holding up its
+	//worker. Outside of fibers it sleeps the thread.
+	static void sleep_until(Clock::time_point deadline)
+	{
+		Fiber* fiber = current();
+		if (fiber == nullptr)
+		{
+			std::this_thread::sleep_until(deadline);
+			return;
+		}
+		if (deadline <= Clock::now())
+		{
+			yield_to_scheduler();
+			return;
+		}
+		Scheduler& scheduler = fiber->scheduler();
+		Alarm alarm;
+		suspend([&scheduler, &alarm, deadline](Fiber* self)
+		{
+			alarm.fiber = self;
+			scheduler.arm(alarm, deadline);
+		});
+	}
+
+	template<typename Rep, typename Period>
+	static void sleep_for(const std::chrono::duration<Rep, Period>& duration)
+	{
+		sleep_until(Clock::now()
+				+ std::chrono::duration_cast<Clock::duration>(duration));
+	}
+
+	//Waits for the task to finish and rethrows what its body threw. A
+	//fiber is suspended meanwhile; any other thread blocks.
+	static void join(const Task& task)
+	{
+		Fiber* target = task._fiber;
+		assert(target != nullptr);
+		if (current() != nullptr)
+			suspend([target](Fiber* self)
+			{
+				std::unique_lock<std::mutex> lock(target->_mutex);
+				if (target->_finished)
+				{
+					lock.unlock();
+					ready(self);
+					return;
+				}
+				self->link = target->_joiners;
+				target->_joiners = self;
+			});
+		else
+		{
+			std::unique_lock<std::mutex> lock(target->_mutex);
+			++target->_outside_joiners;
+			target->_finished_cv.wait(lock, [target]()
+			{
+				return target->_finished;
+			});
+			--target->_outside_joiners;
+		}
+		if (target->_exception)
+			std::rethrow_exception(target->_exception);
+	}
+};
+
+inline void Task::join() const
+{
+	Scheduler::join(*this);
+}
+
+}
+
+}
+
+#endif /* INCLUDE_R_SCHEDULER_HPP_ */
@@ -0,0 +1,266 @@
+/*
+ * stack_pool.hpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef INCLUDE_R_STACK_POOL_HPP_
+#define INCLUDE_R_STACK_POOL_HPP_
+
+#include <cerrno>
+#include <mutex>
+#include <new>
+#include <system_error>
+#include <vector>
+
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include <R/memory_allocator.hpp>
+
+#ifdef __SANITIZE_ADDRESS__
+#include <sanitizer/asan_interface.h>
+#endif
+
+//Stacks are registered with valgrind, so that it takes switches between
+//them for stack switches rather than wild writes below the stack pointer.
+//On by default where valgrind.h can be found; compilers without
+//__has_include need -DR_VALGRIND=1.
+#ifndef R_VALGRIND
+#if defined(__has_include)
+#if __has_include(<valgrind/valgrind.h>)
+#define R_VALGRIND 1
+#endif
+#endif
+#endif
+
+#if R_VALGRIND
+#include <valgrind/valgrind.h>
+#endif
+
+namespace R
+{
+
+inline std::size_t page_size()
+{
+	static const std::size_t size = (std::size_t) sysconf(_SC_PAGESIZE);
+	return size;
+}
+
+//Anonymous private mappings as an Allocator. Pages are only backed by
+//memory once touched, so a large stack costs what it uses. The Aux keeps
+//the mapping and its length for munmap.
+class PageAllocator : public Allocator
+{
+private:
+	struct Mapping
+	{
+		Ptr addr;
+		Size length;
+	};
+public:
+	virtual Aux allocate(Size size, Ptr &addr)
+	{
+		addr = NullPtr;
+		Mapping* mapping = new (std::nothrow) Mapping;
+		if (mapping == nullptr)
+			return NullPtr;
+		mapping->length = (size + page_size() - 1) / page_size() * page_size();
+		mapping->addr = mmap(nullptr, mapping->length, PROT_READ | PROT_WRITE,
+				MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+		if (mapping->addr == MAP_FAILED)
+		{
+			delete mapping;
+			return NullPtr;
+		}
+		addr = mapping->addr;
+		return mapping;
+	}
+
+	virtual void deallocate(Aux aux)
+	{
+		Mapping* mapping = (Mapping*) aux;
+		if (mapping == nullptr)
+			return;
+		munmap(mapping->addr, mapping->length);
+		delete mapping;
+	}
+};
+
+inline Allocator& page_allocator()
+{
+	static PageAllocator allocator;
+	return allocator;
+}
+
+//Coroutine stacks with a PROT_NONE guard page below each of them, so an
+//overflow faults instead of corrupting the neighbour. Sizes are rounded
+//up to a power of two pages and released stacks wait in a free list per
+//size for reuse, up to max_cached_bytes in total; beyond that they go
+//back to the allocator, so memory follows the live coroutines.
+//Thread safe. Memory comes from the given Allocator, which need not be
+//page aligned. Failing to set up a guard page throws std::system_error.
+//
+//Every guard page splits the mapping it sits in, and Linux caps the
+//mappings of a process (vm.max_map_count, 65530 by default), so pools
+//for more than about 30000 live stacks need guard_pages off.
+class StackPool
+{
+public:
+	typedef std::size_t Size;
+
+	//usable stack memory is [base, base + size), the guard page just below
+	struct Stack
+	{
+		Allocator::Ptr base;
+		Size size;
+		Allocator::Aux aux;
+		unsigned valgrind_id; //while it is registered with valgrind
+	};
+private:
+	Allocator* _allocator;
+	Size _max_cached_bytes;
+	Size _cached_bytes;
+	bool _guard_pages;
+	std::mutex _mutex;
+	std::vector<std::vector<Stack>> _free; //indexed by log2 of the pages
+
+	static void fail(const char* what)
+	{
+		throw std::system_error(errno, std::generic_category(), what);
+	}
+
+	static Size size_class(Size size)
+	{
+		Size pages = (size + page_size() - 1) / page_size();
+		Size index = 0;
+		while (((Size) 1 << index) < pages)
+			++index;
+		return index;
+	}
+
+	//a guard page that cannot be made writable again is leaked rather
+	//than handed back to the allocator
+	void release(const Stack& stack) noexcept
+	{
+#if R_VALGRIND
+		VALGRIND_STACK_DEREGISTER(stack.valgrind_id);
+#endif
+		char* guard = (char*) stack.base - page_size();
+		if (!_guard_pages
+				|| mprotect(guard, page_size(), PROT_READ | PROT_WRITE) == 0)
+			_allocator->deallocate(stack.aux);
+	}
+
+public:
+	explicit StackPool(Size max_cached_bytes = (Size) 64 << 20,
+			Allocator& allocator = page_allocator(), bool guard_pages = true) :
+			_allocator(&allocator), _max_cached_bytes(max_cached_bytes),
+					_cached_bytes(0), _guard_pages(guard_pages), _free(64)
+	{
+	}
+
+	StackPool(const StackPool&) = delete;
+	StackPool& operator=(const StackPool&) = delete;
+
+	~StackPool()
+	{
+		trim();
+	}
+
+	//size actually given for a request of size bytes
+	static Size round(Size size)
+	{
+		return page_size() << size_class(size);
+	}
+
+	Stack allocate(Size size)
+	{
+		Size index = size_class(size);
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			if (!_free[index].empty())
+			{
+				Stack stack = _free[index].back();
+				_free[index].pop_back();
+				_cached_bytes -= stack.size;
+				return stack;
+			}
+		}
+		Stack stack;
+		stack.size = page_size() << index;
+		Allocator::Ptr addr = Allocator::NullPtr;
+		//a page of slack to align the guard page
+		stack.aux = _allocator->allocate(stack.size + 2 * page_size(), addr);
+		if (addr == Allocator::NullPtr)
+			throw std::bad_alloc();
+		std::uintptr_t guard = ((std::uintptr_t) addr + page_size() - 1)
+				& ~(std::uintptr_t) (page_size() - 1);
+		if (_guard_pages && mprotect((void*) guard, page_size(), PROT_NONE) != 0)
+		{
+			int error = errno;
+			_allocator->deallocate(stack.aux);
+			errno = error;
+			fail("mprotect");
+		}
+		stack.base = (Allocator::Ptr) (guard + page_size());
+		stack.valgrind_id = 0;
+#if R_VALGRIND
+		stack.valgrind_id = VALGRIND_STACK_REGISTER(stack.base,
+				(char*) stack.base + stack.size);
+#endif
+		return stack;
+	}
+
+	void deallocate(const Stack& stack)
+	{
+#ifdef __SANITIZE_ADDRESS__
+		//frames of a coroutine that never returned stay poisoned
+		__asan_unpoison_memory_region(stack.base, stack.size);
+#endif
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			if (_cached_bytes + stack.size <= _max_cached_bytes)
+			{
+				_free[size_class(stack.size)].push_back(stack);
+				_cached_bytes += stack.size;
+				return;
+			}
+		}
+		release(stack);
+	}
+
+	//returns every cached stack to the allocator
+	void trim()
+	{
+		std::vector<Stack> stacks;
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			for (std::vector<Stack>& list : _free)
+			{
+				stacks.insert(stacks.end(), list.begin(), list.end());
+				list.clear();
+			}
+			_cached_bytes = 0;
+		}
+		for (const Stack& stack : stacks)
+			release(stack);
+	}
+
+	Size cached_bytes()
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _cached_bytes;
+	}
+};
+
+//the pool of coroutines not given one
+inline StackPool& default_stack_pool()
+{
+	static StackPool pool;
+	return pool;
+}
+
+}
+
+#endif /* INCLUDE_R_STACK_POOL_HPP_ */
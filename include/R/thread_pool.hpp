@@ -0,0 +1,176 @@
+/*
+ * thread_pool.hpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef INCLUDE_R_THREAD_POOL_HPP_
+#define INCLUDE_R_THREAD_POOL_HPP_
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace R
+{
+
+//Fixed set of threads running one data-parallel task at a time. run(fn)
+//calls fn(index) once for every index in [0, size()), index 0 on the
+//calling thread, and returns when all of them have finished. Index k
+//always runs on the same thread, so work split by index touches the same
+//memory from the same core on every call. The task must not throw.
+class ThreadPool
+{
+public:
+	typedef std::size_t Size;
+private:
+	std::vector<std::thread> _workers;
+	std::mutex _run_mutex; //serializes run() callers
+	std::mutex _mutex;
+	std::condition_variable _wake;
+	std::condition_variable _done;
+	std::function<void(Size)> _task;
+	Size _generation;
+	Size _pending;
+	bool _stop;
+
+	void work(Size index)
+	{
+		Size seen = 0;
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(_mutex);
+				_wake.wait(lock, [this, seen]()
+				{
+					return _stop || _generation != seen;
+				});
+				if (_stop)
+					return;
+				seen = _generation;
+			}
+			_task(index);
+			std::lock_guard<std::mutex> lock(_mutex);
+			if (--_pending == 0)
+				_done.notify_one();
+		}
+	}
+
+	//CPUs this process may run on, in ascending order
+	static std::vector<Size> allowed_cpus()
+	{
+		std::vector<Size> cpus;
+#ifdef __linux__
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		if (sched_getaffinity(0, sizeof(set), &set) == 0)
+			for (Size cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+				if (CPU_ISSET(cpu, &set))
+					cpus.push_back(cpu);
+#endif
+		return cpus;
+	}
+
+	//binds a worker thread to one CPU; the caller is left alone
+	static void pin(std::thread& thread, Size cpu)
+	{
+#ifdef __linux__
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		CPU_SET(cpu, &set);
+		pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+#else
+		(void) thread;
+		(void) cpu;
+#endif
+	}
+
+public:
+	//the CPUs the process may use, or the hardware count elsewhere
+	static Size default_threads()
+	{
+		Size threads = allowed_cpus().size();
+		if (threads == 0)
+			threads = std::thread::hardware_concurrency();
+		return threads > 0 ? threads : 1;
+	}
+
+	//threads includes the calling thread. With pin_threads, worker k is
+	//bound to the k-th CPU of the process affinity mask (wrapping around)
+	//so first-touch page placement stays on its NUMA node.
+	explicit ThreadPool(Size threads = default_threads(), bool pin_threads =
+			false) :
+			_generation(0), _pending(0), _stop(false)
+	{
+		std::vector<Size> cpus;
+		if (pin_threads)
+			cpus = allowed_cpus();
+		for (Size index = 1; index < threads; ++index)
+		{
+			_workers.push_back(std::thread([this, index]()
+			{
+				work(index);
+			}));
+			if (!cpus.empty())
+				pin(_workers.back(), cpus[index % cpus.size()]);
+		}
+	}
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_stop = true;
+		}
+		_wake.notify_all();
+		for (std::thread& worker : _workers)
+			worker.join();
+	}
+
+	Size size() const
+	{
+		return _workers.size() + 1;
+	}
+
+	template<typename Function>
+	void run(Function && fn)
+	{
+		if (_workers.empty())
+		{
+			fn((Size) 0);
+			return;
+		}
+		std::lock_guard<std::mutex> serial(_run_mutex);
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_task = [&fn](Size index)
+			{
+				fn(index);
+			};
+			_pending = _workers.size();
+			++_generation;
+		}
+		_wake.notify_all();
+		fn((Size) 0);
+		std::unique_lock<std::mutex> lock(_mutex);
+		_done.wait(lock, [this]()
+		{
+			return _pending == 0;
+		});
+		_task = nullptr;
+	}
+};
+
+}
+
+#endif /* INCLUDE_R_THREAD_POOL_HPP_ */
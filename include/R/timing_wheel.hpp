@@ -0,0 +1,283 @@
+/*
+ * timing_wheel.hpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef INCLUDE_R_TIMING_WHEEL_HPP_
+#define INCLUDE_R_TIMING_WHEEL_HPP_
+
+#include <cstdint>
+#include <cassert>
+#include <cstddef>
+#include <algorithm>
+
+namespace R
+{
+
+//Hierarchical timing wheel (Varghese and Lauck, SOSP 1987) over integer
+//ticks. Six levels of 64 slots cover 2^36 ticks ahead: level l holds the
+//timers whose deadline first differs from the current tick in bits
+//[6l, 6l + 6), in the slot of those bits. When the current tick reaches
+//a slot of a higher level, its timers cascade down; those in the level 0
+//slot of the tick are due. Insert and cancel are O(1) list operations on
+//intrusive timers, and advance() skips empty stretches by the occupancy
+//mask of every level, so an idle wheel costs nothing however far it
+//moves. Deadlines further out are parked at the edge of the range and
+//placed again on the way. Not thread safe.
+class TimingWheel
+{
+public:
+	typedef std::size_t Size;
+	typedef uint64_t Tick;
+
+	static constexpr Size BITS = 6;
+	static constexpr Size SLOTS = (Size) 1 << BITS;
+	static constexpr Size LEVELS = 6;
+	static constexpr Tick RANGE = (Tick) 1 << (BITS * LEVELS);
+
+	//Embedded in whatever waits; the wheel only links it. It must stay in
+	//place and outlive its time in the wheel.
+	class Timer
+	{
+	private:
+		Timer* _prev;
+		Timer* _next;
+		Tick _deadline;
+		Size _slot;
+
+		friend class TimingWheel;
+	public:
+		Timer() :
+				_prev(nullptr), _next(nullptr), _deadline(0), _slot(NONE)
+		{
+		}
+
+		Timer(const Timer&) = delete;
+		Timer& operator=(const Timer&) = delete;
+
+		bool pending() const
+		{
+			return _slot != NONE;
+		}
+
+		Tick deadline() const
+		{
+			return _deadline;
+		}
+	};
+
+private:
+	static constexpr Size NONE = ~(Size) 0;
+	static constexpr Size DUE = LEVELS * SLOTS; //already due when inserted
+
+	Timer* _slots[LEVELS * SLOTS + 1];
+	uint64_t _occupied[LEVELS];
+	Tick _now;
+	Size _size;
+
+	void link(Timer* timer)
+	{
+		Size index = DUE;
+		if (timer->_deadline > _now)
+		{
+			Tick placed = std::min(timer->_deadline, _now | (RANGE - 1));
+			if (placed > _now)
+			{
+				Size level = (Size) (63 - __builtin_clzll(placed ^ _now)) / BITS;
+				Size slot = (Size) (placed >> (level * BITS)) & (SLOTS - 1);
+				index = level * SLOTS + slot;
+				_occupied[level] |= (uint64_t) 1 << slot;
+			}
+		}
+		timer->_slot = index;
+		timer->_prev = nullptr;
+		timer->_next = _slots[index];
+		if (_slots[index] != nullptr)
+			_slots[index]->_prev = timer;
+		_slots[index] = timer;
+	}
+
+	void unlink(Timer* timer)
+	{
+		Size index = timer->_slot;
+		if (timer->_prev != nullptr)
+			timer->_prev->_next = timer->_next;
+		else
+			_slots[index] = timer->_next;
+		if (timer->_next != nullptr)
+			timer->_next->_prev = timer->_prev;
+		if (_slots[index] == nullptr && index != DUE)
+			_occupied[index / SLOTS] &= ~((uint64_t) 1 << (index % SLOTS));
+		timer->_prev = timer->_next = nullptr;
+		timer->_slot = NONE;
+	}
+
+	//takes the whole list of a slot
+	Timer* detach(Size index)
+	{
+		Timer* timer = _slots[index];
+		_slots[index] = nullptr;
+		if (index != DUE)
+			_occupied[index / SLOTS] &= ~((uint64_t) 1 << (index % SLOTS));
+		return timer;
+	}
+
+	//Expires the list of a slot at the current tick. Timers parked at the
+	//edge of the range go back in once the rest are out.
+	template<typename Function>
+	Size expire(Size index, Function& fn)
+	{
+		Size count = 0;
+		Timer* later = nullptr;
+		Timer* timer = detach(index);
+		while (timer != nullptr)
+		{
+			Timer* next = timer->_next;
+			timer->_prev = timer->_next = nullptr;
+			timer->_slot = NONE;
+			if (timer->_deadline > _now)
+			{
+				timer->_next = later;
+				later = timer;
+			}
+			else
+			{
+				--_size;
+				++count;
+				fn(timer);
+			}
+			timer = next;
+		}
+		while (later != nullptr)
+		{
+			Timer* next = later->_next;
+			link(later);
+			later = next;
+		}
+		return count;
+	}
+
+	//the first tick after now at which a slot has to be looked at
+	bool event(Tick& tick) const
+	{
+		bool found = false;
+		Tick first = ~(Tick) 0;
+		for (Size level = 0; level < LEVELS; ++level)
+		{
+			Size shift = level * BITS;
+			Size current = (Size) (_now >> shift) & (SLOTS - 1);
+			uint64_t later = current + 1 < SLOTS ?
+					_occupied[level] & ~(((uint64_t) 2 << current) - 1) : 0;
+			if (later == 0)
+				continue;
+			Tick base = _now & ~(((Tick) 1 << (shift + BITS)) - 1);
+			Tick candidate = base | ((Tick) __builtin_ctzll(later) << shift);
+			if (candidate < first)
+				first = candidate;
+			found = true;
+		}
+		if (found)
+			tick = first;
+		return found;
+	}
+
+public:
+	explicit TimingWheel(Tick now = 0) :
+			_now(now), _size(0)
+	{
+		std::fill(_slots, _slots + LEVELS * SLOTS + 1, nullptr);
+		std::fill(_occupied, _occupied + LEVELS, 0);
+	}
+
+	TimingWheel(const TimingWheel&) = delete;
+	TimingWheel& operator=(const TimingWheel&) = delete;
+
+	Tick now() const
+	{
+		return _now;
+	}
+
+	//pending timers
+	Size size() const
+	{
+		return _size;
+	}
+
+	bool empty() const
+	{
+		return _size == 0;
+	}
+
+	//A deadline not after now is due at the next advance().
+	void insert(Timer* timer, Tick deadline)
+	{
+		assert(!timer->pending());
+		timer->_deadline = deadline;
+		link(timer);
+		++_size;
+	}
+
+	//false if the timer was not pending
+	bool cancel(Timer* timer)
+	{
+		if (!timer->pending())
+			return false;
+		unlink(timer);
+		--_size;
+		return true;
+	}
+
+	//A tick no later than the earliest deadline, to sleep until; false
+	//when nothing is pending.
+	bool next(Tick& tick) const
+	{
+		if (_slots[DUE] != nullptr)
+		{
+			tick = _now;
+			return true;
+		}
+		return event(tick);
+	}
+
+	//Moves the wheel to now, calling fn(timer) on every timer due by then,
+	//already taken out. fn must not touch the wheel. Returns the count.
+	template<typename Function>
+	Size advance(Tick now, Function && fn)
+	{
+		Size count = expire(DUE, fn);
+		while (_now < now)
+		{
+			Tick tick;
+			if (!event(tick) || tick > now)
+			{
+				_now = now;
+				break;
+			}
+			_now = tick;
+			//from the top, so timers cascading into a slot that is also
+			//reached now go further down
+			for (Size level = LEVELS - 1; level > 0; --level)
+			{
+				Size shift = level * BITS;
+				if ((tick & (((Tick) 1 << shift) - 1)) != 0)
+					continue;
+				Timer* timer = detach(
+						level * SLOTS + ((Size) (tick >> shift) & (SLOTS - 1)));
+				while (timer != nullptr)
+				{
+					Timer* next = timer->_next;
+					link(timer);
+					timer = next;
+				}
+			}
+			count += expire((Size) tick & (SLOTS - 1), fn);
+			count += expire(DUE, fn);
+		}
+		return count + expire(DUE, fn);
+	}
+};
+
+}
+
+#endif /* INCLUDE_R_TIMING_WHEEL_HPP_ */
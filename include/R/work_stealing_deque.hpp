@@ -0,0 +1,161 @@
+/*
+ * work_stealing_deque.hpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef INCLUDE_R_WORK_STEALING_DEQUE_HPP_
+#define INCLUDE_R_WORK_STEALING_DEQUE_HPP_
+
+#include <cstdint>
+#include <atomic>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include <R/memory_allocator.hpp>
+
+namespace R
+{
+
+//Chase-Lev work-stealing deque (the C11 formulation of Le et al., PPoPP
+//2013). The owner thread pushes and pops at the bottom without a CAS
+//except on the last element; any thread steals from the top. The ring
+//doubles when full; outgrown rings are kept until destruction, since a
+//thief may still be reading one. T must be trivially copyable, such as
+//a pointer.
+template<typename T>
+class WorkStealingDeque
+{
+	//libstdc++ before GCC 5 (no _GLIBCXX_USE_CXX11_ABI) lacks
+	//is_trivially_copyable; the compiler builtin gives the same answer
+#if defined(__GLIBCXX__) && !defined(_GLIBCXX_USE_CXX11_ABI)
+	static_assert(__has_trivial_copy(T),
+			"Trivially copyable type required.");
+#else
+	static_assert(std::is_trivially_copyable<T>::value,
+			"Trivially copyable type required.");
+#endif
+public:
+	typedef std::size_t Size;
+private:
+	struct Ring
+	{
+		Size mask;
+		std::unique_ptr<std::atomic<T>[]> slots;
+
+		explicit Ring(Size capacity) :
+				mask(capacity - 1), slots(new std::atomic<T>[capacity])
+		{
+		}
+
+		T get(int64_t index) const
+		{
+			return slots[(Size) index & mask].load(std::memory_order_relaxed);
+		}
+
+		void put(int64_t index, T value)
+		{
+			slots[(Size) index & mask].store(value, std::memory_order_relaxed);
+		}
+	};
+
+	//top and bottom a line apart: thieves hammer top only. Padding, not
+	//alignas, since deques are allocated with new before C++17.
+	std::atomic<int64_t> _top;
+	char _padding[CACHE_LINE_SIZE];
+	std::atomic<int64_t> _bottom;
+	std::atomic<Ring*> _ring;
+	std::vector<std::unique_ptr<Ring>> _rings; //owner only
+
+	Ring* grow(Ring* ring, int64_t top, int64_t bottom)
+	{
+		_rings.emplace_back(new Ring((ring->mask + 1) * 2));
+		Ring* bigger = _rings.back().get();
+		for (int64_t index = top; index < bottom; ++index)
+			bigger->put(index, ring->get(index));
+		_ring.store(bigger, std::memory_order_release);
+		return bigger;
+	}
+
+public:
+	//capacity must be a power of two
+	explicit WorkStealingDeque(Size capacity = 256) :
+			_top(0), _bottom(0)
+	{
+		_rings.emplace_back(new Ring(capacity));
+		_ring.store(_rings.back().get(), std::memory_order_relaxed);
+	}
+
+	WorkStealingDeque(const WorkStealingDeque&) = delete;
+	WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+	//owner only
+	void push(T value)
+	{
+		int64_t bottom = _bottom.load(std::memory_order_relaxed);
+		int64_t top = _top.load(std::memory_order_acquire);
+		Ring* ring = _ring.load(std::memory_order_relaxed);
+		if (bottom - top > (int64_t) ring->mask)
+			ring = grow(ring, top, bottom);
+		ring->put(bottom, value);
+		_bottom.store(bottom + 1, std::memory_order_release);
+	}
+
+	//owner only; newest first
+	bool pop(T& value)
+	{
+		int64_t bottom = _bottom.load(std::memory_order_relaxed) - 1;
+		Ring* ring = _ring.load(std::memory_order_relaxed);
+		_bottom.store(bottom, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64_t top = _top.load(std::memory_order_relaxed);
+		if (top > bottom)
+		{
+			_bottom.store(bottom + 1, std::memory_order_relaxed);
+			return false;
+		}
+		value = ring->get(bottom);
+		if (top == bottom)
+		{
+			//the last element: race the thieves for it
+			bool won = _top.compare_exchange_strong(top, top + 1,
+					std::memory_order_seq_cst, std::memory_order_relaxed);
+			_bottom.store(bottom + 1, std::memory_order_relaxed);
+			return won;
+		}
+		return true;
+	}
+
+	//any thread; oldest first. Fails when empty or when another thief
+	//won the race, so callers should not take false as proof of empty.
+	bool steal(T& value)
+	{
+		int64_t top = _top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64_t bottom = _bottom.load(std::memory_order_acquire);
+		if (top >= bottom)
+			return false;
+		Ring* ring = _ring.load(std::memory_order_acquire);
+		value = ring->get(top);
+		return _top.compare_exchange_strong(top, top + 1,
+				std::memory_order_seq_cst, std::memory_order_relaxed);
+	}
+
+	//approximate when other threads are working on the deque
+	Size size() const
+	{
+		int64_t bottom = _bottom.load(std::memory_order_seq_cst);
+		int64_t top = _top.load(std::memory_order_seq_cst);
+		return bottom > top ? (Size) (bottom - top) : 0;
+	}
+
+	bool empty() const
+	{
+		return size() == 0;
+	}
+};
+
+}
+
+#endif /* INCLUDE_R_WORK_STEALING_DEQUE_HPP_ */
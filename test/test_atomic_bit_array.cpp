@@ -0,0 +1,183 @@
+/*
+ * test_atomic_bit_array.cpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef DEBUG
+#define DEBUG
+#endif
+
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <R/atomic_bit_array.hpp>
+
+using namespace R;
+
+static const size_t NUM_BITS = 1024;
+static const size_t NUM_THREADS = 8;
+typedef AtomicBitArray<uint64_t, NUM_BITS> Type1;
+typedef AtomicBitArray<uint32_t, NUM_BITS> Type2;
+typedef AtomicBitArray<uint16_t, NUM_BITS> Type3;
+typedef AtomicBitArray<uint8_t, NUM_BITS> Type4;
+
+template<typename Function>
+static void run_threads(Function fn)
+{
+	std::vector<std::thread> threads;
+	for (size_t id = 0; id < NUM_THREADS; ++id)
+		threads.push_back(std::thread(fn, id));
+	for (auto& thread : threads)
+		thread.join();
+}
+
+template<typename Type>
+static void check_single_thread()
+{
+	Type array(false);
+	EXPECT_FALSE(array.test_and_set(5));
+	EXPECT_TRUE(array.test_and_set(5));
+	EXPECT_TRUE(array.get_bit(5));
+	EXPECT_TRUE(array.test_and_clear(5));
+	EXPECT_FALSE(array.test_and_clear(5));
+
+	EXPECT_EQ(0, array.claim_first_zero());
+	EXPECT_EQ(1, array.claim_first_zero(std::memory_order_relaxed));
+	EXPECT_EQ(2, array.claim_range(30));
+	EXPECT_EQ(32, array.count());
+
+	typename Type::PlainType mask(false);
+	mask.set_range(100, 20);
+	EXPECT_FALSE(array.is_collide(mask));
+	array.merge(mask);
+	EXPECT_TRUE(array.is_collide(mask));
+	EXPECT_EQ(52, array.count());
+	EXPECT_EQ(32, array.claim_range(68));
+	EXPECT_EQ(120, array.claim_range(8));
+
+	array.release_range(10, 100);
+	EXPECT_EQ(10, array.claim_range(100, 5));
+	array.fill();
+	EXPECT_EQ(NUM_BITS, array.claim_first_zero());
+	EXPECT_EQ(NUM_BITS, array.claim_range(1));
+}
+
+TEST(AtomicBitArrayTest, SingleThread)
+{
+	check_single_thread<Type1>();
+	check_single_thread<Type2>();
+	check_single_thread<Type3>();
+	check_single_thread<Type4>();
+}
+
+//every bit is handed out exactly once
+template<typename Type>
+static void check_claim_first_zero()
+{
+	Type array(false);
+	std::vector<std::vector<size_t> > claimed(NUM_THREADS);
+	run_threads([&array, &claimed](size_t id)
+	{
+		while (true)
+		{
+			size_t index = array.claim_first_zero();
+			if (index == NUM_BITS)
+				break;
+			claimed[id].push_back(index);
+		}
+	});
+
+	std::vector<int> seen(NUM_BITS, 0);
+	for (auto& list : claimed)
+		for (auto index : list)
+			++seen[index];
+	for (size_t k = 0; k < NUM_BITS; ++k)
+		ASSERT_EQ(1, seen[k]) << "bit " << k;
+	EXPECT_EQ(NUM_BITS, array.count());
+}
+
+TEST(AtomicBitArrayTest, Stress_ClaimFirstZero)
+{
+	check_claim_first_zero<Type1>();
+	check_claim_first_zero<Type2>();
+	check_claim_first_zero<Type3>();
+	check_claim_first_zero<Type4>();
+}
+
+//runs claimed concurrently never overlap, and releasing them restores zero
+template<typename Type>
+static void check_claim_range()
+{
+	Type array(false);
+	std::vector<int> owner(NUM_BITS, -1);
+	std::atomic<bool> overlap(false);
+	run_threads([&array, &owner, &overlap](size_t id)
+	{
+		for (int round = 0; round < 200; ++round)
+		{
+			size_t length = 1 + (id * 7 + round) % 37;
+			size_t start = array.claim_range(length, id * 100);
+			if (start == NUM_BITS)
+				continue;
+			for (size_t k = start; k < start + length; ++k)
+			{
+				if (owner[k] != -1)
+					overlap = true;
+				owner[k] = (int) id;
+			}
+			for (size_t k = start; k < start + length; ++k)
+			{
+				if (owner[k] != (int) id)
+					overlap = true;
+				owner[k] = -1;
+			}
+			array.release_range(start, length);
+		}
+	});
+	EXPECT_FALSE(overlap.load());
+	EXPECT_EQ(0, array.count());
+}
+
+TEST(AtomicBitArrayTest, Stress_ClaimRange)
+{
+	check_claim_range<Type1>();
+	check_claim_range<Type2>();
+	check_claim_range<Type3>();
+	check_claim_range<Type4>();
+}
+
+TEST(AtomicBitArrayTest, Stress_TestAndSet)
+{
+	Type1 array(false);
+	std::atomic<size_t> winners(0);
+	run_threads([&array, &winners](size_t)
+	{
+		for (size_t k = 0; k < NUM_BITS; ++k)
+			if (!array.test_and_set(k))
+				++winners;
+	});
+	EXPECT_EQ(NUM_BITS, winners.load());
+
+	run_threads([&array](size_t id)
+	{
+		for (size_t k = id; k < NUM_BITS; k += NUM_THREADS)
+			array.test_and_clear(k, std::memory_order_release);
+	});
+	EXPECT_EQ(0, array.count());
+}
+
+TEST(AtomicBitArrayTest, Stress_Merge)
+{
+	Type2 array(false);
+	run_threads([&array](size_t id)
+	{
+		Type2::PlainType mask(false);
+		for (size_t k = id; k < NUM_BITS; k += NUM_THREADS)
+			mask.set_bit(k);
+		array.merge(mask);
+	});
+	EXPECT_EQ(NUM_BITS, array.count());
+	EXPECT_TRUE(array.snapshot() == Type2::PlainType(true));
+}
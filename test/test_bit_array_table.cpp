@@ -0,0 +1,108 @@
+/*
+ * test_bit_array_table.cpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef DEBUG
+#define DEBUG
+#endif
+
+#include <cstdio>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include <R/bit_array_table.hpp>
+
+using namespace R;
+
+template<typename Type>
+class BitArrayTableTest: public ::testing::Test
+{
+};
+
+typedef ::testing::Types<uint64_t, uint32_t, uint16_t, uint8_t> BaseInts;
+TYPED_TEST_CASE(BitArrayTableTest, BaseInts);
+
+template<typename BaseInt>
+static BitArray<BaseInt, 256> random_mask(std::mt19937& rng, int bits)
+{
+	BitArray<BaseInt, 256> mask(false);
+	for (int k = 0; k < bits; ++k)
+		mask.set_bit(rng() % 256);
+	return mask;
+}
+
+//every query result matches a per-entry is_collide loop
+template<typename BaseInt>
+static void expect_same(const BitArrayTable<BaseInt, 256>& table,
+		const std::vector<BitArray<BaseInt, 256> >& entries,
+		const BitArray<BaseInt, 256>& query)
+{
+	std::vector<std::size_t> expected;
+	for (std::size_t index = 0; index < entries.size(); ++index)
+		if (entries[index].is_collide(query))
+			expected.push_back(index);
+
+	ASSERT_EQ(expected, table.all_collisions(query));
+	ASSERT_EQ(!expected.empty(), table.any_collision(query));
+	ASSERT_EQ(expected.empty() ? table.size() : expected.front(),
+			table.first_collision(query));
+}
+
+TYPED_TEST(BitArrayTableTest, MatchesLoop)
+{
+	std::mt19937 rng(3);
+	for (bool summary : { false, true })
+	{
+		BitArrayTable<TypeParam, 256> table(summary);
+		std::vector<BitArray<TypeParam, 256> > entries;
+		for (int k = 0; k < 700; ++k)
+		{
+			entries.push_back(random_mask<TypeParam>(rng, 1 + rng() % 3));
+			EXPECT_EQ(k, table.push_back(entries.back()));
+		}
+		ASSERT_EQ(entries.size(), table.size());
+		EXPECT_TRUE(table.get(123) == entries[123]);
+
+		for (int query = 0; query < 40; ++query)
+			expect_same(table, entries, random_mask<TypeParam>(rng, 1 + query % 5));
+		expect_same(table, entries, BitArray<TypeParam, 256>(false));
+		expect_same(table, entries, BitArray<TypeParam, 256>(true));
+
+		//overwrite and remove keep the summaries exact
+		for (int round = 0; round < 300; ++round)
+		{
+			std::size_t index = rng() % entries.size();
+			if (round % 2)
+			{
+				entries[index] = random_mask<TypeParam>(rng, 1);
+				table.set(index, entries[index]);
+			}
+			else
+			{
+				entries[index] = entries.back();
+				entries.pop_back();
+				table.remove(index);
+			}
+		}
+		ASSERT_EQ(entries.size(), table.size());
+		for (int query = 0; query < 40; ++query)
+			expect_same(table, entries, random_mask<TypeParam>(rng, 2));
+	}
+}
+
+TEST(BitArrayTableTest, Empty)
+{
+	BitArrayTable<uint64_t, 128> table;
+	BitArray<uint64_t, 128> query(true);
+	EXPECT_FALSE(table.any_collision(query));
+	EXPECT_EQ(0, table.first_collision(query));
+
+	table.push_back(BitArray<uint64_t, 128>(false));
+	EXPECT_FALSE(table.any_collision(query));
+	table.remove(0);
+	EXPECT_EQ(0, table.size());
+	table.clear();
+	EXPECT_TRUE(table.all_collisions(query).empty());
+}
@@ -0,0 +1,147 @@
+/*
+ * test_bit_array_view.cpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef DEBUG
+#define DEBUG
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include <unistd.h>
+#include <gtest/gtest.h>
+#include <R/bit_array_view.hpp>
+#include <R/mapped_bit_array.hpp>
+
+using namespace R;
+
+template<typename Type>
+class BitArrayViewTest: public ::testing::Test
+{
+};
+
+typedef ::testing::Types<uint64_t, uint32_t, uint16_t, uint8_t> BaseInts;
+TYPED_TEST_CASE(BitArrayViewTest, BaseInts);
+
+//Views over buffers whose last bucket is shared with foreign bits must
+//behave like a BitVector of the same size and leave those bits alone.
+TYPED_TEST(BitArrayViewTest, MatchesBitVector)
+{
+	const std::size_t bits = 1000 - 3;
+	std::mt19937 rng(1);
+	BitVector<TypeParam> expect_a(bits), expect_b(bits);
+	std::vector<TypeParam> buffer_a(expect_a.buckets(), 0);
+	std::vector<TypeParam> buffer_b(expect_b.buckets(), 0);
+	//foreign padding bits all set
+	buffer_a.back() = (TypeParam) ~BitAlgorithm<TypeParam>::fill_left(
+			bits % (sizeof(TypeParam) * 8));
+	buffer_b.back() = buffer_a.back();
+	const TypeParam padding = buffer_a.back();
+
+	BitArrayView<TypeParam> a(buffer_a.data(), bits), b(buffer_b.data(), bits);
+	for (int round = 0; round < 300; ++round)
+	{
+		std::size_t index = rng() % bits;
+		std::size_t length = std::min<std::size_t>(rng() % 100, bits - index);
+		switch (rng() % 4)
+		{
+		case 0:
+			a.set_range(index, length);
+			expect_a.set_range(index, length);
+			break;
+		case 1:
+			a.clear_range(index, length);
+			expect_a.clear_range(index, length);
+			break;
+		case 2:
+			b.set_bit(index);
+			expect_b.set_bit(index);
+			break;
+		default:
+			b.clear_bit(index);
+			expect_b.clear_bit(index);
+			break;
+		}
+	}
+	ASSERT_EQ(expect_a.count(), a.count());
+	ASSERT_EQ(expect_b.count(), b.count());
+	ASSERT_TRUE(a == expect_a);
+	ASSERT_TRUE(b == BitArrayView<const TypeParam>(expect_b));
+	ASSERT_EQ(expect_a.is_collide(expect_b), a.is_collide(b));
+	ASSERT_EQ(expect_a.find_first_zero(), a.find_first_zero());
+	ASSERT_EQ(expect_a.find_next_set(10), a.find_next_set(10));
+	ASSERT_EQ(expect_a.find_zero_run(20, 5), a.find_zero_run(20, 5));
+
+	std::vector<std::size_t> seen, expected;
+	a.for_each_set_bit([&seen](std::size_t k) { seen.push_back(k); });
+	expect_a.for_each_set_bit([&expected](std::size_t k) { expected.push_back(k); });
+	ASSERT_EQ(expected, seen);
+
+	a.merge(b);
+	expect_a.merge(expect_b);
+	ASSERT_TRUE(a == expect_a);
+	a.intersect(b);
+	expect_a.intersect(expect_b);
+	ASSERT_TRUE(a == expect_a);
+
+	a.fill();
+	EXPECT_EQ(bits, a.count());
+	EXPECT_EQ(bits, a.find_first_zero());
+	a.clear();
+	EXPECT_EQ(0, a.count());
+	EXPECT_EQ(bits, a.find_first_set());
+	a.assign(b);
+	EXPECT_TRUE(a == b);
+
+	EXPECT_EQ(padding, buffer_a.back() & padding);
+	EXPECT_EQ(padding, buffer_b.back() & padding);
+}
+
+TEST(BitArrayViewTest, WrapsOwners)
+{
+	BitArray<uint32_t, 128> array(false);
+	BitArrayView<uint32_t> view(array);
+	view.set_range(3, 7);
+	EXPECT_TRUE(array.get_bit(3));
+	EXPECT_EQ(7, array.count());
+
+	const BitArray<uint32_t, 128>& constant = array;
+	BitArrayView<const uint32_t> reader(constant);
+	EXPECT_EQ(3, reader.find_first_set());
+	EXPECT_TRUE(reader == view);
+	EXPECT_TRUE(view.is_collide(array));
+}
+
+TEST(BitArrayViewTest, MappedFile)
+{
+	char path[] = "/tmp/r_mapped_bit_array_XXXXXX";
+	int fd = mkstemp(path);
+	ASSERT_GE(fd, 0);
+	close(fd);
+
+	{
+		MappedBitArray<uint64_t> mapped(path, 100000);
+		EXPECT_EQ(0, mapped.view().count());
+		mapped.view().set_range(500, 1000);
+		mapped.view().set_bit(99999);
+		mapped.sync();
+	}
+	{
+		MappedBitArray<uint64_t> reader(path, 100000, false);
+		const MappedBitArray<uint64_t>& constant = reader;
+		EXPECT_EQ(1001, constant.view().count());
+		EXPECT_EQ(500, constant.view().find_first_set());
+		EXPECT_TRUE(constant.view().get_bit(99999));
+
+		MappedBitArray<uint64_t> moved(std::move(reader));
+		EXPECT_FALSE(reader.is_open());
+		EXPECT_TRUE(moved.is_open());
+	}
+	EXPECT_THROW(MappedBitArray<uint64_t>(path, 1 << 30, false), std::system_error);
+	unlink(path);
+	EXPECT_THROW(MappedBitArray<uint64_t>(path, 64, false), std::system_error);
+}
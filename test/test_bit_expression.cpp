@@ -0,0 +1,84 @@
+/*
+ * test_bit_expression.cpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef DEBUG
+#define DEBUG
+#endif
+
+#include <cstdio>
+#include <random>
+#include <gtest/gtest.h>
+#include <R/bit_array.hpp>
+
+using namespace R;
+
+template<typename Type>
+class BitExpressionTest: public ::testing::Test
+{
+};
+
+typedef ::testing::Types<uint64_t, uint32_t, uint16_t, uint8_t> BaseInts;
+TYPED_TEST_CASE(BitExpressionTest, BaseInts);
+
+template<typename BaseInt>
+static void randomize(BitArray<BaseInt, 512>& bits, std::mt19937& rng)
+{
+	for (std::size_t k = 0; k < bits.buckets(); ++k)
+		bits.data()[k] = (BaseInt) (rng() & rng());
+}
+
+TYPED_TEST(BitExpressionTest, MatchesWordLoop)
+{
+	typedef BitArray<TypeParam, 512> Bits;
+	std::mt19937 rng(8);
+	for (int trial = 0; trial < 20; ++trial)
+	{
+		Bits a, b, c, d;
+		randomize(a, rng);
+		randomize(b, rng);
+		randomize(c, rng);
+		randomize(d, rng);
+
+		Bits expected;
+		for (std::size_t k = 0; k < Bits::buckets(); ++k)
+			expected.data()[k] = (TypeParam) ((a.data()[k] & b.data()[k])
+					| (c.data()[k] & ~d.data()[k]));
+
+		Bits result = (a & b) | (c & ~d);
+		EXPECT_TRUE(result == expected);
+		result.clear();
+		result = (a & b) | andnot(c, d);
+		EXPECT_TRUE(result == expected);
+		EXPECT_EQ(expected.count(), ((a & b) | (c & ~d)).count());
+
+		Bits flipped = a ^ b;
+		Bits merged(a);
+		merged.merge(b);
+		Bits common(a);
+		common.intersect(b);
+		EXPECT_EQ(merged.count() - common.count(), flipped.count());
+		EXPECT_EQ(a.is_collide(b), (a & b).any());
+		EXPECT_EQ(a.is_collide(b), (~~a).is_collide(b));
+		EXPECT_EQ(512 - a.count(), (~a).count());
+	}
+}
+
+TEST(BitExpressionTest, Aliasing)
+{
+	BitArray<uint64_t, 256> a(false), b(false);
+	a.set_range(0, 100);
+	b.set_range(50, 100);
+	a = a ^ b;
+	EXPECT_EQ(100, a.count());
+	EXPECT_TRUE(a.get_bit(0));
+	EXPECT_FALSE(a.get_bit(60));
+	EXPECT_TRUE(a.get_bit(120));
+
+	a = ~a & a;
+	EXPECT_EQ(0, a.count());
+	EXPECT_FALSE((a | a).any());
+	EXPECT_TRUE((~a).any());
+}
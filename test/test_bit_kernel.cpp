@@ -0,0 +1,163 @@
+/*
+ * test_bit_kernel.cpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef DEBUG
+#define DEBUG
+#endif
+
+#include <cstdio>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include <R/bit_array.hpp>
+
+using namespace R;
+using bit_kernel::Backend;
+
+static const size_t NUM_BITS = 256;
+static const size_t WIDE_BITS = 4096;
+static const size_t ODD_BITS = 192; //leaves a tail after every vector width
+
+//per-bit reference built on get_bit/set_bit only
+template<typename Type, std::size_t Bits>
+static void check_against_reference(std::mt19937& rng)
+{
+	Type a(false), b(false);
+	for (size_t k = 0; k < Bits; ++k)
+	{
+		if (rng() % 4 == 0)
+			a.set_bit(k);
+		if (rng() % 4 == 0)
+			b.set_bit(k);
+	}
+
+	Type merged(a), intersected(a);
+	merged.merge(b);
+	intersected.intersect(b);
+
+	bool collide = false;
+	for (size_t k = 0; k < Bits; ++k)
+	{
+		bool x = a.get_bit(k), y = b.get_bit(k);
+		ASSERT_EQ(x || y, merged.get_bit(k));
+		ASSERT_EQ(x && y, intersected.get_bit(k));
+		collide = collide || (x && y);
+	}
+	EXPECT_EQ(collide, a.is_collide(b));
+	EXPECT_EQ(collide, b.is_collide(a));
+
+	//single collision in the last bucket, to exercise the tail handling
+	Type c(false), d(false);
+	c.set_bit(Bits - 1);
+	d.set_bit(Bits - 1);
+	EXPECT_TRUE(c.is_collide(d));
+	d.clear_bit(Bits - 1);
+	d.set_bit(0);
+	EXPECT_FALSE(c.is_collide(d));
+
+	Type e(a);
+	EXPECT_TRUE(e == a);
+	e.set_bit(Bits - 1);
+	e.clear_bit(Bits - 1);
+	if (a.get_bit(Bits - 1))
+		EXPECT_TRUE(e != a);
+	else
+		EXPECT_TRUE(e == a);
+}
+
+template<std::size_t Bits>
+static void check_all_widths(std::mt19937& rng)
+{
+	check_against_reference<BitArray<uint64_t, Bits>, Bits>(rng);
+	check_against_reference<BitArray<uint32_t, Bits>, Bits>(rng);
+	check_against_reference<BitArray<uint16_t, Bits>, Bits>(rng);
+	check_against_reference<BitArray<uint8_t, Bits>, Bits>(rng);
+}
+
+class BitKernelTest : public ::testing::TestWithParam<Backend>
+{
+protected:
+	Backend saved;
+
+	virtual void SetUp()
+	{
+		saved = bit_kernel::current_backend();
+		if (!bit_kernel::set_backend(GetParam()))
+			GTEST_SKIP() << "backend not supported on this CPU";
+	}
+
+	virtual void TearDown()
+	{
+		bit_kernel::set_backend(saved);
+	}
+};
+
+TEST_P(BitKernelTest, MatchesScalar)
+{
+	std::mt19937 rng(1234);
+	for (int round = 0; round < 8; ++round)
+	{
+		check_all_widths<NUM_BITS>(rng);
+		check_all_widths<WIDE_BITS>(rng);
+		check_all_widths<ODD_BITS>(rng);
+	}
+}
+
+TEST_P(BitKernelTest, RawKernels)
+{
+	std::mt19937 rng(42);
+	const bit_kernel::Table& scalar = bit_kernel::table(Backend::SCALAR);
+	const bit_kernel::Table& tested = bit_kernel::active();
+
+	for (size_t bytes = 0; bytes <= 200; ++bytes)
+	{
+		std::vector<unsigned char> a(bytes), b(bytes);
+		for (size_t k = 0; k < bytes; ++k)
+		{
+			a[k] = (unsigned char) (rng() & rng());
+			b[k] = (unsigned char) (rng() & rng());
+		}
+		std::vector<unsigned char> x(a), y(a);
+		scalar.merge(x.data(), b.data(), bytes);
+		tested.merge(y.data(), b.data(), bytes);
+		EXPECT_EQ(x, y);
+
+		x = a;
+		y = a;
+		scalar.intersect(x.data(), b.data(), bytes);
+		tested.intersect(y.data(), b.data(), bytes);
+		EXPECT_EQ(x, y);
+
+		x = a;
+		y = a;
+		scalar.andnot(x.data(), b.data(), bytes);
+		tested.andnot(y.data(), b.data(), bytes);
+		EXPECT_EQ(x, y);
+		for (size_t k = 0; k < bytes; ++k)
+			ASSERT_EQ((unsigned char) (a[k] & ~b[k]), y[k]);
+
+		EXPECT_EQ(scalar.is_collide(a.data(), b.data(), bytes),
+				tested.is_collide(a.data(), b.data(), bytes));
+		EXPECT_EQ(scalar.equal(a.data(), b.data(), bytes),
+				tested.equal(a.data(), b.data(), bytes));
+		EXPECT_TRUE(tested.equal(a.data(), a.data(), bytes));
+
+		unsigned char pattern[64];
+		for (size_t k = 0; k < sizeof(pattern); ++k)
+			pattern[k] = (unsigned char) (0x5A + k % 8);
+		x = a;
+		y = a;
+		scalar.and_or(x.data(), b.data(), pattern, bytes);
+		tested.and_or(y.data(), b.data(), pattern, bytes);
+		EXPECT_EQ(x, y);
+		for (size_t k = 0; k < bytes; ++k)
+			ASSERT_EQ((unsigned char) (a[k] | (b[k] & pattern[k % 8])), y[k]);
+	}
+}
+
+INSTANTIATE_TEST_CASE_P(AllBackends, BitKernelTest,
+		::testing::Values(Backend::SCALAR, Backend::SSE2, Backend::AVX2,
+				Backend::AVX512));
@@ -0,0 +1,91 @@
+/*
+ * test_bit_matrix.cpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef DEBUG
+#define DEBUG
+#endif
+
+#include <cstdio>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include <R/bit_matrix.hpp>
+
+using namespace R;
+
+TEST(BitMatrixTest, Transpose64)
+{
+	std::mt19937_64 rng(1);
+	uint64_t block[64], original[64];
+	for (int k = 0; k < 64; ++k)
+		original[k] = block[k] = rng();
+	bit_matrix::transpose64(block);
+	for (std::size_t row = 0; row < 64; ++row)
+		for (std::size_t col = 0; col < 64; ++col)
+			ASSERT_EQ(BitAlgorithm<uint64_t>::get_bit(original + row, col),
+					BitAlgorithm<uint64_t>::get_bit(block + col, row));
+	bit_matrix::transpose64(block);
+	for (int k = 0; k < 64; ++k)
+		ASSERT_EQ(original[k], block[k]);
+}
+
+//odd sizes exercise partial blocks in both directions
+TEST(BitMatrixTest, MatchesGetBit)
+{
+	const std::size_t ROWS = 150, COLS = 700;
+	std::mt19937 rng(2);
+	BitMatrix<ROWS, COLS> matrix;
+	for (int k = 0; k < 5000; ++k)
+		matrix.set_bit(rng() % ROWS, rng() % COLS);
+	matrix.row(7).set_range(100, 300);
+	matrix.clear_bit(7, 150);
+
+	BitMatrix<COLS, ROWS> transposed = matrix.transpose();
+	std::vector<std::size_t> counts = matrix.column_counts();
+	std::size_t total = 0;
+	for (std::size_t row = 0; row < ROWS; ++row)
+	{
+		std::size_t row_total = 0;
+		for (std::size_t col = 0; col < COLS; ++col)
+		{
+			ASSERT_EQ(matrix.get_bit(row, col), transposed.get_bit(col, row));
+			row_total += matrix.get_bit(row, col);
+		}
+		ASSERT_EQ(row_total, matrix.row_count(row));
+		total += row_total;
+	}
+	for (std::size_t col = 0; col < COLS; ++col)
+		ASSERT_EQ(matrix.column_count(col), counts[col]);
+	EXPECT_EQ(total, matrix.count());
+	EXPECT_EQ(total, transposed.count());
+	EXPECT_TRUE(transposed.transpose().row(7) == matrix.row(7));
+}
+
+TEST(BitMatrixTest, Queries)
+{
+	BitMatrix<100, 300> slots;
+	slots.row(0).set_range(0, 10);
+	slots.row(5).set_range(50, 10);
+	slots.row(99).set_bit(299);
+
+	BitVector<uint64_t> mask(300);
+	mask.set_range(55, 100);
+	EXPECT_EQ(std::vector<std::size_t>( { 5 }), slots.colliding_rows(mask));
+	mask.set_bit(299);
+	EXPECT_EQ(std::vector<std::size_t>( { 5, 99 }), slots.colliding_rows(mask));
+
+	BitVector<uint64_t> free = slots.free_columns();
+	EXPECT_EQ(300 - 21, free.count());
+	EXPECT_EQ(10, free.find_first_set());
+	EXPECT_FALSE(free.get_bit(299));
+
+	BitVector<uint64_t> resources(100);
+	resources.set_bit(0);
+	resources.set_bit(99);
+	free = slots.free_columns(resources);
+	EXPECT_EQ(300 - 11, free.count());
+	EXPECT_TRUE(free.get_bit(55));
+}
@@ -0,0 +1,163 @@
+/*
+ * test_bit_parallel.cpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef DEBUG
+#define DEBUG
+#endif
+
+#include <cstdio>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <R/bit_parallel.hpp>
+
+using namespace R;
+
+TEST(ThreadPoolTest, RunsEveryIndexOnce)
+{
+	ThreadPool pool(4);
+	ASSERT_EQ(4u, pool.size());
+	for (int round = 0; round < 50; ++round)
+	{
+		std::vector<std::atomic<int> > hits(pool.size());
+		for (std::atomic<int>& hit : hits)
+			hit = 0;
+		std::thread::id caller = std::this_thread::get_id();
+		bool caller_ran_zero = false;
+		pool.run([&](std::size_t index)
+		{
+			++hits[index];
+			if (index == 0)
+				caller_ran_zero = std::this_thread::get_id() == caller;
+		});
+		for (std::atomic<int>& hit : hits)
+			ASSERT_EQ(1, hit.load());
+		ASSERT_TRUE(caller_ran_zero);
+	}
+
+	ThreadPool single(1);
+	int calls = 0;
+	single.run([&calls](std::size_t index)
+	{
+		calls += (int) index + 1;
+	});
+	EXPECT_EQ(1, calls);
+}
+
+TEST(ThreadPoolTest, ConcurrentCallers)
+{
+	ThreadPool pool(3);
+	std::atomic<int> total(0);
+	std::vector<std::thread> callers;
+	for (int k = 0; k < 4; ++k)
+		callers.push_back(std::thread([&pool, &total]()
+		{
+			for (int round = 0; round < 20; ++round)
+				pool.run([&total](std::size_t)
+				{
+					++total;
+				});
+		}));
+	for (std::thread& caller : callers)
+		caller.join();
+	EXPECT_EQ(4 * 20 * 3, total.load());
+}
+
+#ifdef __linux__
+//every worker ends up on a single CPU the process is allowed to use
+TEST(ThreadPoolTest, PinsToAllowedCpus)
+{
+	cpu_set_t allowed;
+	ASSERT_EQ(0, sched_getaffinity(0, sizeof(allowed), &allowed));
+	ThreadPool pool(6, true);
+	std::vector<int> counts(pool.size(), 0);
+	std::vector<int> inside(pool.size(), 0);
+	pool.run([&](std::size_t index)
+	{
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		pthread_getaffinity_np(pthread_self(), sizeof(set), &set);
+		CPU_AND(&set, &set, &allowed);
+		counts[index] = CPU_COUNT(&set);
+		CPU_OR(&set, &set, &allowed);
+		inside[index] = CPU_EQUAL(&set, &allowed);
+	});
+	for (std::size_t index = 1; index < pool.size(); ++index)
+	{
+		EXPECT_EQ(1, counts[index]) << "worker " << index;
+		EXPECT_TRUE(inside[index]) << "worker " << index;
+	}
+}
+#endif
+
+//several chunks with a partial last bucket, forced onto the pool
+TEST(BitParallelTest, MatchesSerial)
+{
+	const std::size_t BITS = 5 * (std::size_t) 1000 * 1000 + 13;
+	ThreadPool pool(4);
+	std::mt19937_64 rng(5);
+	BitVector<uint64_t> a(BITS), b(BITS);
+	for (int k = 0; k < 20000; ++k)
+	{
+		a.set_bit(rng() % BITS);
+		b.set_bit(rng() % BITS);
+	}
+	a.set_range(1000, 3 * (std::size_t) 1000 * 1000);
+
+	EXPECT_EQ(a.count(), bit_parallel::count(pool, a, 0));
+
+	BitVector<uint64_t> expected(a), result(a);
+	expected.merge(b);
+	bit_parallel::merge(pool, result, b, 0);
+	EXPECT_TRUE(expected == result);
+
+	expected = a;
+	result = a;
+	expected.intersect(b);
+	bit_parallel::intersect(pool, result, b, 0);
+	EXPECT_TRUE(expected == result);
+
+	bit_parallel::fill(pool, result, 0);
+	EXPECT_EQ(BITS, bit_parallel::count(pool, result, 0));
+	EXPECT_EQ(BITS, result.count());
+	bit_parallel::clear(pool, result, 0);
+	EXPECT_EQ(0u, result.count());
+
+	//below the cutoff the calling thread does the work
+	EXPECT_EQ(a.count(), bit_parallel::count(pool, a));
+
+	BitVector<uint64_t> zeros = bit_parallel::make_vector<uint64_t>(pool, BITS);
+	EXPECT_EQ(BITS, zeros.size());
+	EXPECT_EQ(0u, zeros.count());
+	BitVector<uint64_t> ones = bit_parallel::make_vector<uint64_t>(pool, BITS,
+			true);
+	EXPECT_EQ(BITS, ones.count());
+	ones.resize(BITS + 100);
+	EXPECT_EQ(BITS, ones.count());
+}
+
+TEST(BitParallelTest, BitArray)
+{
+	typedef BitArray<uint32_t, 4096> Mask;
+	ThreadPool pool(2);
+	Mask a(false), b(false);
+	a.set_range(10, 100);
+	b.set_range(50, 100);
+	bit_parallel::merge(pool, a, b, 0);
+	EXPECT_EQ(140u, bit_parallel::count(pool, a, 0));
+	bit_parallel::intersect(pool, a, b, 0);
+	EXPECT_EQ(100u, bit_parallel::count(pool, a, 0));
+	bit_parallel::fill(pool, a, 0);
+	EXPECT_EQ(4096u, a.count());
+	bit_parallel::clear(bit_parallel::default_pool(), a, 0);
+	EXPECT_EQ(0u, a.count());
+
+	BitVector<uint8_t> empty;
+	EXPECT_EQ(0u, bit_parallel::count(pool, empty, 0));
+	bit_parallel::fill(pool, empty, 0);
+}
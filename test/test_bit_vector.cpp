@@ -0,0 +1,167 @@
+/*
+ * test_bit_vector.cpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef DEBUG
+#define DEBUG
+#endif
+
+#include <cstdio>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include <R/bit_array.hpp>
+#include <R/bit_vector.hpp>
+
+using namespace R;
+
+class CountingAllocator : public Allocator
+{
+public:
+	int allocations = 0;
+	int live = 0;
+
+	virtual Aux allocate(Size size, Ptr &addr)
+	{
+		++allocations;
+		++live;
+		addr = (Ptr) malloc(size);
+		return (Aux) addr;
+	}
+	virtual void deallocate(Aux aux)
+	{
+		--live;
+		free(aux);
+	}
+};
+
+//BitVector must behave exactly like a BitArray of the same size
+template<typename BaseInt>
+static void check_against_bit_array()
+{
+	static const size_t BITS = 512;
+	std::mt19937 rng(99);
+	BitArray<BaseInt, BITS> a(false), b(false);
+	BitVector<BaseInt> x(BITS), y(BITS);
+
+	for (int round = 0; round < 100; ++round)
+	{
+		size_t start = rng() % BITS;
+		size_t length = rng() % (BITS - start);
+		switch (rng() % 4)
+		{
+		case 0:
+			a.set_range(start, length);
+			x.set_range(start, length);
+			break;
+		case 1:
+			a.clear_range(start, length);
+			x.clear_range(start, length);
+			break;
+		case 2:
+			b.set_bit(start);
+			y.set_bit(start);
+			break;
+		default:
+			b.clear_bit(start);
+			y.clear_bit(start);
+			break;
+		}
+		ASSERT_EQ(a.count(), x.count());
+		ASSERT_EQ(a.is_collide(b), x.is_collide(y));
+		ASSERT_EQ(a.find_first_set(), x.find_first_set());
+		ASSERT_EQ(a.find_first_zero(), x.find_first_zero());
+		ASSERT_EQ(a.find_zero_run(length + 1, start),
+				x.find_zero_run(length + 1, start));
+	}
+
+	a.merge(b);
+	x.merge(y);
+	for (size_t k = 0; k < BITS; ++k)
+		ASSERT_EQ(a.get_bit(k), x.get_bit(k));
+	a.intersect(b);
+	x.intersect(y);
+	for (size_t k = 0; k < BITS; ++k)
+		ASSERT_EQ(a.get_bit(k), x.get_bit(k));
+}
+
+TEST(BitVectorTest, MatchesBitArray)
+{
+	check_against_bit_array<uint64_t>();
+	check_against_bit_array<uint32_t>();
+	check_against_bit_array<uint16_t>();
+	check_against_bit_array<uint8_t>();
+}
+
+TEST(BitVectorTest, OddSize)
+{
+	BitVector<uint64_t> vector(100, true);
+	EXPECT_EQ(100, vector.size());
+	EXPECT_EQ(100, vector.count());
+	EXPECT_EQ(100, vector.find_first_zero());
+	vector.clear_range(90, 10);
+	EXPECT_EQ(90, vector.find_zero_run(10));
+	EXPECT_EQ(100, vector.find_zero_run(11));
+	vector.fill();
+	EXPECT_EQ(100, vector.count());
+
+	BitVector<uint64_t> empty;
+	EXPECT_EQ(0, empty.size());
+	EXPECT_EQ(0, empty.count());
+	EXPECT_EQ(0, empty.find_first_set());
+}
+
+TEST(BitVectorTest, Resize)
+{
+	BitVector<uint32_t> vector(10, true);
+	vector.resize(200);
+	EXPECT_EQ(200, vector.size());
+	EXPECT_EQ(10, vector.count());
+	EXPECT_EQ(10, vector.find_first_zero());
+
+	vector.resize(300, true);
+	EXPECT_EQ(110, vector.count());
+	EXPECT_EQ(200, vector.find_next_set(9));
+
+	//shrinking drops the bits, growing again brings back zeros
+	vector.resize(5);
+	EXPECT_EQ(5, vector.count());
+	vector.resize(300);
+	EXPECT_EQ(5, vector.count());
+
+	vector.shrink_to_fit();
+	EXPECT_EQ(300, vector.size());
+	EXPECT_EQ(5, vector.count());
+}
+
+TEST(BitVectorTest, Allocator)
+{
+	CountingAllocator allocator;
+	{
+		BitVector<uint64_t> vector(1000, false, allocator);
+		EXPECT_EQ(1, allocator.allocations);
+		EXPECT_EQ(0, (uintptr_t) vector.data() % CACHE_LINE_SIZE);
+
+		//moving hands over the buffer without allocating
+		BitVector<uint64_t> moved(std::move(vector));
+		EXPECT_EQ(1, allocator.allocations);
+		EXPECT_EQ(0, vector.size());
+		EXPECT_EQ(1000, moved.size());
+
+		BitVector<uint64_t> assigned;
+		assigned = std::move(moved);
+		EXPECT_EQ(1, allocator.allocations);
+		EXPECT_EQ(&allocator, &assigned.allocator());
+
+		BitVector<uint64_t> copy(assigned);
+		EXPECT_EQ(2, allocator.allocations);
+		EXPECT_TRUE(copy == assigned);
+
+		//resizing within capacity keeps the buffer
+		copy.resize(1020);
+		EXPECT_EQ(2, allocator.allocations);
+	}
+	EXPECT_EQ(0, allocator.live);
+}
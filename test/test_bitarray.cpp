@@ -10,6 +10,8 @@
 #endif
 
 #include <cstdio>
+#include <vector>
+#include <random>
 #include <gtest/gtest.h>
 #include <R/bit_array.hpp>
 
@@ -70,3 +72,201 @@ TEST(BitArrayTest, Different)
 	EXPECT_FALSE(array3 == array3_);
 	EXPECT_FALSE(array4 == array4_);
 }
+
+template<typename Type>
+static void check_scan(const Type& array)
+{
+	size_t count = 0;
+	size_t first_set = NUM_BITS, first_zero = NUM_BITS;
+	std::vector<size_t> set_bits;
+	for (size_t k = 0; k < NUM_BITS; ++k)
+	{
+		if (array.get_bit(k))
+		{
+			++count;
+			set_bits.push_back(k);
+			first_set = std::min(first_set, k);
+		}
+		else
+			first_zero = std::min(first_zero, k);
+	}
+
+	EXPECT_EQ(count, array.count());
+	EXPECT_EQ(first_set, array.find_first_set());
+	EXPECT_EQ(first_zero, array.find_first_zero());
+
+	std::vector<size_t> visited;
+	array.for_each_set_bit([&visited](size_t index)
+	{
+		visited.push_back(index);
+	});
+	EXPECT_EQ(set_bits, visited);
+
+	std::vector<size_t> walked;
+	for (size_t k = array.find_first_set(); k < NUM_BITS;
+			k = array.find_next_set(k))
+		walked.push_back(k);
+	EXPECT_EQ(set_bits, walked);
+
+	for (size_t k = array.find_first_zero(); k < NUM_BITS;
+			k = array.find_next_zero(k))
+		EXPECT_FALSE(array.get_bit(k));
+}
+
+template<typename Type>
+static void check_scan_patterns()
+{
+	Type empty(false), full(true);
+	check_scan(empty);
+	check_scan(full);
+	EXPECT_EQ(NUM_BITS, empty.find_first_set());
+	EXPECT_EQ(NUM_BITS, full.find_first_zero());
+	EXPECT_EQ(NUM_BITS, full.count());
+
+	//MSB-first order: bit 0 is the first one found
+	Type first(false);
+	first.set_bit(0);
+	EXPECT_EQ(0, first.find_first_set());
+	EXPECT_EQ(NUM_BITS, first.find_next_set(0));
+
+	Type sparse(false);
+	sparse.set_bit(3);
+	sparse.set_bit(63);
+	sparse.set_bit(64);
+	sparse.set_bit(200);
+	sparse.set_bit(NUM_BITS - 1);
+	check_scan(sparse);
+
+	Type ranged(false);
+	ranged.set_range(5, 100);
+	ranged.set_range(130, 7);
+	check_scan(ranged);
+
+	Type holes(true);
+	holes.clear_range(17, 40);
+	holes.clear_bit(NUM_BITS - 1);
+	check_scan(holes);
+}
+
+TEST(BitArrayTest, Scan)
+{
+	check_scan_patterns<Type1>();
+	check_scan_patterns<Type2>();
+	check_scan_patterns<Type3>();
+	check_scan_patterns<Type4>();
+}
+
+template<typename Type>
+static size_t reference_zero_run(const Type& array, size_t length, size_t from)
+{
+	size_t run = 0;
+	for (size_t k = from; k < NUM_BITS; ++k)
+	{
+		run = array.get_bit(k) ? 0 : run + 1;
+		if (run >= length)
+			return k + 1 - length;
+	}
+	return NUM_BITS;
+}
+
+template<typename Type>
+static void check_zero_run()
+{
+	std::mt19937 rng(7);
+	for (int round = 0; round < 50; ++round)
+	{
+		Type array(false);
+		int density = 1 + rng() % 8;
+		for (size_t k = 0; k < NUM_BITS; ++k)
+			if (rng() % density == 0)
+				array.set_bit(k);
+
+		for (size_t length = 1; length <= NUM_BITS; length += 1 + length / 4)
+		{
+			size_t hint = rng() % NUM_BITS;
+			size_t expected = reference_zero_run(array, length, hint);
+			if (expected == NUM_BITS)
+				expected = reference_zero_run(array, length, 0);
+			EXPECT_EQ(expected, array.find_zero_run(length, hint));
+			EXPECT_EQ(reference_zero_run(array, length, 0),
+					array.find_zero_run(length));
+		}
+	}
+
+	Type array(false);
+	EXPECT_EQ(0, array.reserve_run(10));
+	EXPECT_EQ(10, array.reserve_run(70));
+	EXPECT_EQ(80, array.reserve_run(1));
+	EXPECT_EQ(81, array.count());
+	array.clear_range(20, 30);
+	EXPECT_EQ(20, array.reserve_run(30));
+	EXPECT_EQ(81, array.reserve_run(NUM_BITS - 81));
+	EXPECT_EQ(NUM_BITS, array.reserve_run(1));
+	EXPECT_EQ(NUM_BITS, array.count());
+
+	Type empty(false);
+	EXPECT_EQ(0, empty.find_zero_run(NUM_BITS));
+	EXPECT_EQ(NUM_BITS, empty.find_zero_run(NUM_BITS + 1));
+	EXPECT_EQ(0, empty.find_zero_run(NUM_BITS, 100));
+	EXPECT_EQ(100, empty.find_zero_run(8, 100));
+}
+
+TEST(BitArrayTest, ZeroRun)
+{
+	check_zero_run<Type1>();
+	check_zero_run<Type2>();
+	check_zero_run<Type3>();
+	check_zero_run<Type4>();
+}
+
+//masks built and compared entirely at compile time
+namespace
+{
+typedef BitArray<uint64_t, 128> Mask;
+constexpr Mask BITS = Mask::from_bits(0, 63, 64, 127);
+constexpr Mask RANGE = Mask::from_range(60, 10);
+constexpr Mask TEXT = Mask::from_string("1001");
+constexpr Mask FULL = Mask::from_range(0, 128);
+
+static_assert(BITS.get_bit(63) && BITS.get_bit(64) && !BITS.get_bit(1),
+		"from_bits");
+static_assert(RANGE.get_bit(60) && RANGE.get_bit(69) && !RANGE.get_bit(70),
+		"from_range");
+static_assert(TEXT.get_bit(0) && !TEXT.get_bit(1) && TEXT.get_bit(3),
+		"from_string");
+#if R_HAS_CONSTANT_EVALUATED
+static_assert(BITS.count() == 4 && RANGE.count() == 10 && FULL.count() == 128,
+		"count");
+static_assert(BITS.is_collide(RANGE) && !TEXT.is_collide(RANGE), "is_collide");
+static_assert(TEXT == Mask::from_bits(3, 0) && TEXT != BITS, "equal");
+static_assert(Mask() == Mask::from_range(5, 0), "empty");
+#endif
+}
+
+template<typename Type>
+static void check_constexpr()
+{
+	Type bits = Type::from_bits(1, 7, 100, NUM_BITS - 1);
+	Type expected(false);
+	expected.set_bit(1);
+	expected.set_bit(7);
+	expected.set_bit(100);
+	expected.set_bit(NUM_BITS - 1);
+	EXPECT_TRUE(bits == expected);
+
+	expected.clear();
+	expected.set_range(3, NUM_BITS - 10);
+	EXPECT_TRUE(Type::from_range(3, NUM_BITS - 10) == expected);
+
+	EXPECT_TRUE(Type::from_string("0110") == Type::from_bits(1, 2));
+	EXPECT_EQ(NUM_BITS, Type(true).count());
+}
+
+TEST(BitArrayTest, Constexpr)
+{
+	check_constexpr<Type1>();
+	check_constexpr<Type2>();
+	check_constexpr<Type3>();
+	check_constexpr<Type4>();
+	EXPECT_EQ(4, BITS.count());
+}
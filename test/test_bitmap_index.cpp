@@ -0,0 +1,198 @@
+/*
+ * test_bitmap_index.cpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef DEBUG
+#define DEBUG
+#endif
+
+#include <cstdio>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include <R/bitmap_index.hpp>
+
+using namespace R;
+
+namespace
+{
+
+const std::size_t NONE = (std::size_t) -1;
+//odd record count: the last chunk is partial and ends mid-word
+const std::size_t RECORDS = 33001;
+
+struct Fixture
+{
+	BitmapIndex index;
+	std::vector<std::vector<std::size_t> > values; //[attribute][record]
+	std::vector<std::size_t> widths;
+
+	Fixture() :
+			index(RECORDS)
+	{
+		add(10, BitmapIndex::EQUALITY, 1);
+		add(50, BitmapIndex::RANGE, 1);
+		add(100, BitmapIndex::EQUALITY, 10);
+		add(64, BitmapIndex::RANGE, 8);
+
+		std::mt19937 rng(3);
+		for (std::size_t attribute = 0; attribute < values.size(); ++attribute)
+			for (std::size_t record = 0; record < RECORDS; ++record)
+			{
+				//a few records hold no value
+				if (rng() % 16 == 0)
+					continue;
+				std::size_t value = rng() % index.bins(attribute)
+						* widths[attribute] + rng() % widths[attribute];
+				values[attribute][record] = value;
+				index.set(attribute, record, value);
+			}
+	}
+
+	void add(std::size_t cardinality, BitmapIndex::Encoding encoding,
+			std::size_t width)
+	{
+		index.add_attribute(cardinality, encoding, width);
+		values.push_back(std::vector<std::size_t>(RECORDS, NONE));
+		widths.push_back(width);
+	}
+
+	//reference: leaves round to whole bins like the index
+	bool matches(const BitmapQuery& query, std::size_t record) const
+	{
+		switch (query.kind())
+		{
+		case BitmapQuery::RANGE:
+		{
+			std::size_t value = values[query.attribute()][record];
+			std::size_t width = widths[query.attribute()];
+			return value != NONE && value / width >= query.low() / width
+					&& value / width <= query.high() / width;
+		}
+		case BitmapQuery::NOT:
+			return !matches(query.children()[0], record);
+		case BitmapQuery::AND:
+			for (const BitmapQuery& child : query.children())
+				if (!matches(child, record))
+					return false;
+			return true;
+		case BitmapQuery::OR:
+			for (const BitmapQuery& child : query.children())
+				if (matches(child, record))
+					return true;
+			return false;
+		}
+		return false;
+	}
+
+	void check(const BitmapQuery& query) const
+	{
+		BitmapIndex::Bitmap result = index.evaluate(query);
+		ASSERT_EQ(RECORDS, result.size());
+		std::size_t expected = 0;
+		for (std::size_t record = 0; record < RECORDS; ++record)
+		{
+			ASSERT_EQ(matches(query, record), result.get_bit(record)) << record;
+			expected += result.get_bit(record);
+		}
+		ASSERT_EQ(expected, index.count(query));
+
+		std::vector<std::size_t> visited, pulled;
+		index.for_each(query, [&visited](std::size_t record)
+		{
+			visited.push_back(record);
+		});
+		BitmapIndex::Cursor cursor = index.cursor(query);
+		std::size_t record;
+		while (cursor.next(record))
+			pulled.push_back(record);
+		ASSERT_EQ(expected, visited.size());
+		ASSERT_EQ(visited, pulled);
+		for (std::size_t k = 0; k < visited.size(); ++k)
+			ASSERT_TRUE(result.get_bit(visited[k]));
+	}
+};
+
+typedef BitmapQuery Q;
+
+}
+
+TEST(BitmapIndexTest, Leaves)
+{
+	Fixture data;
+	EXPECT_EQ(10u, data.index.bins(0));
+	EXPECT_EQ(10u, data.index.bins(2));
+	EXPECT_EQ(8u, data.index.bins(3));
+	data.check(Q::equal(0, 3));
+	data.check(Q::range(0, 2, 6));
+	data.check(Q::range(0, 0, 1000));
+	data.check(Q::equal(1, 0));
+	data.check(Q::range(1, 10, 30));
+	data.check(Q::range(1, 0, 49));
+	data.check(Q::range(2, 15, 42));
+	data.check(Q::range(3, 9, 30));
+	data.check(Q::range(1, 30, 10));
+}
+
+TEST(BitmapIndexTest, Trees)
+{
+	Fixture data;
+	data.check(Q::equal(0, 1) & Q::range(1, 5, 20));
+	data.check(Q::equal(0, 1) & Q::range(1, 5, 20) & Q::range(2, 0, 35)
+			& ~Q::range(3, 0, 15));
+	data.check(Q::equal(0, 1) | Q::equal(0, 7) | Q::range(1, 45, 49));
+	data.check(~Q::equal(0, 1) & ~Q::equal(1, 2));
+	data.check(~(Q::equal(0, 1) | (Q::range(1, 0, 10) & Q::equal(2, 50))));
+	data.check(~~Q::range(1, 3, 4));
+	data.check((Q::range(0, 0, 4) | Q::range(1, 0, 25))
+			& (Q::range(2, 50, 99) | ~Q::range(3, 0, 40)));
+	//disjoint operands: every chunk exits early
+	data.check(Q::equal(0, 1) & Q::equal(0, 2) & Q::range(1, 0, 49));
+}
+
+TEST(BitmapIndexTest, Flatten)
+{
+	Q query = Q::equal(0, 1) & Q::equal(0, 2) & (Q::equal(1, 3) & Q::equal(1, 4));
+	EXPECT_EQ(Q::AND, query.kind());
+	EXPECT_EQ(4u, query.children().size());
+	query = Q::equal(0, 1) | (Q::equal(0, 2) & Q::equal(1, 3));
+	EXPECT_EQ(Q::OR, query.kind());
+	EXPECT_EQ(2u, query.children().size());
+}
+
+TEST(BitmapIndexTest, Update)
+{
+	BitmapIndex index(100);
+	std::size_t size = index.add_attribute(4, BitmapIndex::RANGE);
+	index.set(size, 10, 1);
+	index.set(size, 20, 3);
+	EXPECT_EQ(1u, index.count(Q::range(size, 0, 1)));
+	EXPECT_EQ(2u, index.count(Q::range(size, 0, 3)));
+	EXPECT_EQ(98u, index.count(~Q::range(size, 0, 3)));
+
+	index.clear(size, 10);
+	index.set(size, 10, 2);
+	EXPECT_EQ(0u, index.count(Q::range(size, 0, 1)));
+	EXPECT_EQ(1u, index.count(Q::equal(size, 2)));
+
+	index.resize(150);
+	EXPECT_EQ(148u, index.count(~Q::range(size, 0, 3)));
+	index.set(size, 149, 0);
+	EXPECT_EQ(1u, index.count(Q::equal(size, 0)));
+	index.resize(15);
+	EXPECT_EQ(1u, index.count(Q::range(size, 0, 3)));
+	EXPECT_EQ(14u, index.count(~Q::range(size, 0, 3)));
+	EXPECT_TRUE(index.evaluate(Q::equal(size, 2)).get_bit(10));
+}
+
+TEST(BitmapIndexTest, Empty)
+{
+	BitmapIndex index;
+	std::size_t attribute = index.add_attribute(3);
+	EXPECT_EQ(0u, index.count(~Q::equal(attribute, 1)));
+	EXPECT_EQ(0u, index.evaluate(Q::equal(attribute, 1)).size());
+	std::size_t record;
+	EXPECT_FALSE(index.cursor(~Q::equal(attribute, 1)).next(record));
+}
@@ -0,0 +1,140 @@
+/*
+ * test_bloom_filter.cpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef DEBUG
+#define DEBUG
+#endif
+
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <R/bloom_filter.hpp>
+
+using namespace R;
+
+static std::vector<uint64_t> random_keys(std::size_t count, uint64_t seed)
+{
+	std::mt19937_64 rng(seed);
+	std::vector<uint64_t> keys(count);
+	for (auto& key : keys)
+		key = rng();
+	return keys;
+}
+
+//every key sets exactly one bit in each word of a single block
+TEST(BloomFilterTest, OneBlockPerKey)
+{
+	BloomFilter filter(1 << 16);
+	EXPECT_EQ(1 << 16, filter.size());
+	filter.insert(42);
+	EXPECT_TRUE(filter.contains(42));
+
+	std::size_t touched = 0, bits = 0;
+	for (std::size_t word = 0; word < filter.bits().buckets(); ++word)
+	{
+		uint64_t value = filter.bits().data()[word];
+		touched += (value != 0);
+		bits += bit_word::popcount(value);
+	}
+	EXPECT_EQ(8, touched);
+	EXPECT_EQ(8, bits);
+}
+
+TEST(BloomFilterTest, FalsePositiveRate)
+{
+	const std::size_t keys = 20000;
+	BloomFilter filter(bloom_block::bits_for(keys, 0.01));
+	std::vector<uint64_t> inserted = random_keys(keys, 1);
+	for (uint64_t key : inserted)
+		filter.insert(key);
+	for (uint64_t key : inserted)
+		ASSERT_TRUE(filter.contains(key));
+
+	std::vector<uint64_t> others = random_keys(keys, 2);
+	std::size_t false_positives = 0;
+	for (uint64_t key : others)
+		false_positives += filter.contains(key);
+	EXPECT_LT(false_positives, keys * 2 / 100);
+
+	//sequential keys must not collapse onto a few blocks
+	BloomFilter sequential(bloom_block::bits_for(keys, 0.01));
+	for (std::size_t key = 0; key < keys; ++key)
+		sequential.insert(key);
+	false_positives = 0;
+	for (std::size_t key = keys; key < 2 * keys; ++key)
+		false_positives += sequential.contains(key);
+	EXPECT_LT(false_positives, keys * 2 / 100);
+}
+
+//batch calls agree with the single-key calls on every backend
+TEST(BloomFilterTest, Batch)
+{
+	std::vector<uint64_t> inserted = random_keys(5000, 3);
+	std::vector<uint64_t> probes = random_keys(5000, 4);
+	probes.insert(probes.end(), inserted.begin(), inserted.end());
+
+	BloomFilter reference(1 << 15);
+	for (uint64_t key : inserted)
+		reference.insert(key);
+
+	bit_kernel::Backend saved = bit_kernel::current_backend();
+	for (int index = 0; index < (int) bit_kernel::Backend::COUNT; ++index)
+	{
+		if (!bit_kernel::set_backend((bit_kernel::Backend) index))
+			continue;
+		BloomFilter filter(1 << 15);
+		filter.insert_many(inserted.data(), inserted.size());
+		EXPECT_TRUE(filter.bits() == reference.bits());
+
+		std::unique_ptr<bool[]> results(new bool[probes.size()]);
+		std::size_t hits = filter.contains_many(probes.data(), probes.size(),
+				results.get());
+		std::size_t expected = 0;
+		for (std::size_t k = 0; k < probes.size(); ++k)
+		{
+			ASSERT_EQ(reference.contains(probes[k]), results[k]);
+			expected += results[k];
+		}
+		EXPECT_EQ(expected, hits);
+	}
+	bit_kernel::set_backend(saved);
+}
+
+TEST(BloomFilterTest, ConcurrentInsert)
+{
+	const int THREADS = 8;
+	const std::size_t PER_THREAD = 4000;
+	AtomicBloomFilter filter(bloom_block::bits_for(THREADS * PER_THREAD, 0.01));
+	std::vector<std::vector<uint64_t> > keys;
+	for (int thread = 0; thread < THREADS; ++thread)
+		keys.push_back(random_keys(PER_THREAD, 10 + thread));
+
+	std::vector<std::thread> workers;
+	for (int thread = 0; thread < THREADS; ++thread)
+		workers.emplace_back([&filter, &keys, thread]()
+		{
+			const std::vector<uint64_t>& mine = keys[thread];
+			if (thread % 2)
+				filter.insert_many(mine.data(), mine.size());
+			else
+				for (uint64_t key : mine)
+					filter.insert(key);
+		});
+	for (auto& worker : workers)
+		worker.join();
+
+	BloomFilter plain(filter.size());
+	for (const auto& mine : keys)
+	{
+		for (uint64_t key : mine)
+			ASSERT_TRUE(filter.contains(key));
+		plain.insert_many(mine.data(), mine.size());
+	}
+	EXPECT_TRUE(filter.snapshot().bits() == plain.bits());
+}
@@ -0,0 +1,248 @@
+/*
+ * test_channel.cpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef DEBUG
+#define DEBUG
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <R/channel.hpp>
+
+using namespace R;
+
+TEST(ChannelTest, BufferedOrder)
+{
+	Channel<int> channel(4);
+	EXPECT_EQ(4, channel.capacity());
+	for (int value = 0; value < 4; ++value)
+		EXPECT_TRUE(channel.send(value));
+	int extra = 4;
+	EXPECT_FALSE(channel.try_send(extra));
+	EXPECT_EQ(4, channel.size());
+	channel.close();
+	EXPECT_TRUE(channel.closed());
+	EXPECT_FALSE(channel.send(5));
+	//a closed channel drains first
+	int value = -1;
+	for (int expected = 0; expected < 4; ++expected)
+	{
+		ASSERT_TRUE(channel.receive(value));
+		EXPECT_EQ(expected, value);
+	}
+	EXPECT_FALSE(channel.receive(value));
+	EXPECT_FALSE(channel.try_receive(value));
+}
+
+TEST(ChannelTest, Unbounded)
+{
+	Channel<std::unique_ptr<int>> channel(Channel<std::unique_ptr<int>>::UNBOUNDED);
+	for (int value = 0; value < 10000; ++value)
+		EXPECT_TRUE(channel.send(std::unique_ptr<int>(new int(value))));
+	std::unique_ptr<int> pointer;
+	for (int value = 0; value < 10000; ++value)
+	{
+		ASSERT_TRUE(channel.try_receive(pointer));
+		EXPECT_EQ(value, *pointer);
+	}
+	EXPECT_FALSE(channel.try_receive(pointer));
+}
+
+//several producers and consumers on every capacity, across workers
+TEST(ChannelTest, ProducersAndConsumers)
+{
+	for (std::size_t capacity : { 0, 1, 64 })
+	{
+		Scheduler scheduler(3);
+		Channel<long> channel(capacity);
+		WaitGroup producers(4);
+		std::atomic<long> sum(0);
+		std::atomic<long> count(0);
+		std::vector<Task> tasks;
+		for (long index = 0; index < 4; ++index)
+			tasks.push_back(scheduler.spawn([&, index]()
+			{
+				for (long value = 1; value <= 5000; ++value)
+					EXPECT_TRUE(channel.send(value * 4 + index));
+				producers.done();
+			}));
+		for (int index = 0; index < 4; ++index)
+			tasks.push_back(scheduler.spawn([&]()
+			{
+				long value;
+				while (channel.receive(value))
+				{
+					sum += value;
+					++count;
+				}
+			}));
+		producers.wait();
+		channel.close();
+		for (Task& task : tasks)
+			task.join();
+		EXPECT_EQ(4 * 5000, count.load());
+		EXPECT_EQ(4 * 5000L * 5001 / 2 * 4 + 5000 * 6, sum.load());
+	}
+}
+
+TEST(ChannelTest, Rendezvous)
+{
+	Scheduler scheduler(1);
+	Channel<std::string> channel;
+	std::atomic<bool> sent(false);
+	Task task = scheduler.spawn([&]()
+	{
+		channel.send("hello");
+		sent = true;
+	});
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	//nobody received yet
+	EXPECT_FALSE(sent.load());
+	std::string value;
+	ASSERT_TRUE(channel.receive(value));
+	EXPECT_EQ("hello", value);
+	task.join();
+	EXPECT_TRUE(sent.load());
+}
+
+TEST(ChannelTest, Select)
+{
+	Channel<int> numbers(1);
+	Channel<std::string> words(1);
+	int number = 0;
+	std::string word;
+	Select select;
+	select.receive(numbers, number).receive(words, word);
+	EXPECT_TRUE(select.poll() == Select::NONE);
+	words.send("word");
+	EXPECT_EQ(1, select.wait());
+	EXPECT_TRUE(select.ok());
+	EXPECT_EQ("word", word);
+	numbers.send(7);
+	words.send("again");
+	//both ready: taken in turn
+	EXPECT_EQ(0, select.wait());
+	EXPECT_EQ(7, number);
+	EXPECT_EQ(1, select.wait());
+	EXPECT_EQ("again", word);
+
+	//a send case, left untouched when another one wins
+	Channel<int> out;
+	int sending = 42;
+	Select both;
+	both.send(out, sending).receive(numbers, number);
+	numbers.send(3);
+	EXPECT_EQ(1, both.wait());
+	EXPECT_EQ(3, number);
+	EXPECT_EQ(42, sending);
+	numbers.close();
+	EXPECT_EQ(1, both.wait());
+	EXPECT_FALSE(both.ok());
+}
+
+TEST(ChannelTest, SelectSuspends)
+{
+	Scheduler scheduler(2);
+	Channel<int> first;
+	Channel<int> second;
+	Channel<int> quit;
+	std::atomic<long> sum(0);
+	Task task = scheduler.spawn([&]()
+	{
+		int value = 0;
+		Select select;
+		select.receive(first, value).receive(second, value).receive(quit,
+				value);
+		while (select.wait() != 2)
+			sum += value;
+		EXPECT_FALSE(select.ok());
+	});
+	Task other = scheduler.spawn([&]()
+	{
+		for (int value = 1; value <= 1000; ++value)
+			second.send(value);
+	});
+	for (int value = 1; value <= 1000; ++value)
+		first.send(value);
+	other.join();
+	quit.close();
+	task.join();
+	EXPECT_EQ(1000L * 1001, sum.load());
+	//nothing of the select is left behind on the channels
+	int value = 5;
+	EXPECT_FALSE(first.try_send(value));
+	EXPECT_FALSE(second.try_send(value));
+}
+
+TEST(ChannelTest, Timeouts)
+{
+	typedef Scheduler::Clock Clock;
+	Scheduler scheduler(2);
+	Channel<int> channel;
+	Channel<int> other(1);
+	scheduler.spawn([&]()
+	{
+		int value = 1;
+		Clock::time_point start = Clock::now();
+		EXPECT_FALSE(channel.receive_for(value, std::chrono::milliseconds(5)));
+		EXPECT_GE(Clock::now() - start, std::chrono::milliseconds(5));
+		EXPECT_FALSE(channel.send_for(value, std::chrono::milliseconds(1)));
+		Select select;
+		select.receive(channel, value).receive(other, value);
+		EXPECT_TRUE(
+				select.wait_for(std::chrono::milliseconds(1)) == Select::NONE);
+		other.send(3);
+		EXPECT_EQ(1, select.wait_for(std::chrono::seconds(10)));
+		EXPECT_EQ(3, value);
+	}).join();
+	//a receiver with a deadline, served in time from outside
+	Task task = scheduler.spawn([&]()
+	{
+		int value = 0;
+		EXPECT_TRUE(channel.receive_for(value, std::chrono::seconds(10)));
+		EXPECT_EQ(9, value);
+	});
+	channel.send(9);
+	task.join();
+	int value = 0;
+	EXPECT_FALSE(channel.receive_for(value, std::chrono::milliseconds(1)));
+	EXPECT_EQ(0, scheduler.timers());
+}
+
+//receivers timing out while elements arrive: each one is taken once
+TEST(ChannelTest, TimeoutRace)
+{
+	Scheduler scheduler(3);
+	Channel<long> channel;
+	std::atomic<long> sum(0);
+	std::vector<Task> tasks;
+	for (int index = 0; index < 8; ++index)
+		tasks.push_back(scheduler.spawn([&]()
+		{
+			long value;
+			while (!channel.closed())
+				if (channel.receive_for(value, std::chrono::microseconds(300)))
+					sum += value;
+		}));
+	scheduler.spawn([&]()
+	{
+		for (long value = 1; value <= 5000; ++value)
+		{
+			EXPECT_TRUE(channel.send(value));
+			if (value % 100 == 0)
+				Scheduler::sleep_for(std::chrono::microseconds(700));
+		}
+		channel.close();
+	}).join();
+	for (Task& task : tasks)
+		task.join();
+	EXPECT_EQ(5000L * 5001 / 2, sum.load());
+}
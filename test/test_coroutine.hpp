@@ -10,6 +10,9 @@
 #include <iostream>
 #include <queue>
 #include <mutex>
+#include <memory>
+#include <stdexcept>
+#include <vector>
 
 template<typename T>
 class SafeQueue
@@ -292,3 +295,126 @@ TEST(__COROUTINE_TEST, Recursive_Int)
 	EXPECT_EQ(5, result.take());
 	EXPECT_EQ(6, result.take());
 }
+
+#if defined(R_COROUTINE_BACKEND) && R_COROUTINE_BACKEND != R_COROUTINE_THREAD
+
+TEST(__COROUTINE_TEST, Symmetric_PingPong)
+{
+	std::vector<int> seen;
+	symmetric_coroutine<int>::call_type* other = nullptr;
+
+	symmetric_coroutine<int>::call_type ping(
+			[&seen, &other](symmetric_coroutine<int>::yield_type &yield)
+			{
+				while (yield.get() < 10)
+				{
+					seen.push_back(yield.get());
+					yield(*other, yield.get() + 1); //straight to pong
+				}
+				seen.push_back(-yield.get());
+			});
+	symmetric_coroutine<int>::call_type pong(
+			[&seen, &ping](symmetric_coroutine<int>::yield_type &yield)
+			{
+				while (true)
+				{
+					seen.push_back(yield.get());
+					yield(ping, yield.get() + 1);
+				}
+			});
+	other = &pong;
+
+	ping(0); //returns only when ping ends
+	EXPECT_FALSE((bool) ping);
+	EXPECT_TRUE((bool) pong);
+	EXPECT_EQ(std::vector<int>({ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, -10 }), seen);
+}
+
+TEST(__COROUTINE_TEST, Symmetric_Pipeline)
+{
+	const int stages = 8;
+	std::vector<int> results;
+	std::vector<std::unique_ptr<symmetric_coroutine<int>::call_type>> pipeline(
+			stages);
+	for (int index = stages - 1; index >= 0; --index)
+	{
+		symmetric_coroutine<int>::call_type* next = index + 1 < stages ?
+				pipeline[index + 1].get() : nullptr;
+		pipeline[index].reset(new symmetric_coroutine<int>::call_type(
+				[&results, next, index](symmetric_coroutine<int>::yield_type &yield)
+				{
+					while (true)
+					{
+						if (next != nullptr)
+							yield(*next, yield.get() * 2 + index);
+						else
+						{
+							results.push_back(yield.get());
+							yield(); //back to whoever fed the first stage
+						}
+					}
+				}));
+	}
+	for (int value = 0; value < 100; ++value)
+		(*pipeline[0])(value);
+	ASSERT_EQ(100u, results.size());
+	for (int value = 0; value < 100; ++value)
+	{
+		int expected = value;
+		for (int index = 0; index < stages - 1; ++index)
+			expected = expected * 2 + index;
+		EXPECT_EQ(expected, results[value]);
+	}
+}
+
+TEST(__COROUTINE_TEST, Symmetric_Exception)
+{
+	std::vector<int> seen;
+	symmetric_coroutine<void>::call_type thrower(
+			[&seen](symmetric_coroutine<void>::yield_type &)
+			{
+				seen.push_back(2);
+				throw std::runtime_error("thrower");
+			});
+	symmetric_coroutine<void>::call_type first(
+			[&seen, &thrower](symmetric_coroutine<void>::yield_type &yield)
+			{
+				seen.push_back(1);
+				yield(thrower);
+				seen.push_back(3);
+			});
+
+	EXPECT_THROW(first(), std::runtime_error); //thrown where the chain ends
+	EXPECT_TRUE((bool) first);
+	EXPECT_FALSE((bool) thrower);
+	EXPECT_THROW(thrower(), std::runtime_error);
+	EXPECT_NO_THROW(first());
+	EXPECT_FALSE((bool) first);
+	EXPECT_EQ(std::vector<int>({ 1, 2, 3 }), seen);
+}
+
+//a coroutine suspended by a transfer unwinds when destroyed
+TEST(__COROUTINE_TEST, Symmetric_Destroy)
+{
+	std::shared_ptr<int> counter = std::make_shared<int>(0);
+	{
+		symmetric_coroutine<void>::call_type second(
+				[](symmetric_coroutine<void>::yield_type &yield)
+				{
+					yield();
+				});
+		symmetric_coroutine<void>::call_type first(
+				[counter, &second](symmetric_coroutine<void>::yield_type &yield)
+				{
+					std::shared_ptr<int> local = counter;
+					yield(second);
+				});
+		first();
+		EXPECT_EQ(3, counter.use_count());
+		EXPECT_TRUE((bool) first);
+		EXPECT_TRUE((bool) second);
+	}
+	EXPECT_EQ(1, counter.use_count());
+}
+
+#endif
@@ -0,0 +1,14 @@
+/*
+ * test_coroutine_asm.cpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define R_COROUTINE_BACKEND R_COROUTINE_ASM
+#include <R/coroutine.hpp>
+using R::symmetric_coroutine;
+
+#define __COROUTINE_TEST Coroutine_Asm
+#include "test_coroutine.hpp"
+#endif
@@ -6,6 +6,7 @@
  */
 
 #if 1
+#define R_COROUTINE_BACKEND R_COROUTINE_THREAD
 #include <R/coroutine.hpp>
 using R::symmetric_coroutine;
 
@@ -0,0 +1,251 @@
+/*
+ * test_coroutine_stackless.cpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef DEBUG
+#define DEBUG
+#endif
+
+//built with -std=gnu++20, see the Makefile
+#if defined(__cpp_impl_coroutine)
+#define R_COROUTINE_BACKEND R_COROUTINE_STACKLESS
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include <gtest/gtest.h>
+#include <R/coroutine.hpp>
+
+using R::symmetric_coroutine;
+
+TEST(Coroutine_Stackless, BasicInt)
+{
+	std::vector<int> result;
+	symmetric_coroutine<int>::call_type source(
+			[&result](symmetric_coroutine<int>::yield_type& yield)
+					-> symmetric_coroutine<int>::body_type
+			{
+				result.push_back(2);
+				result.push_back(yield.get());
+				co_await yield();
+				result.push_back(yield.get());
+				co_await yield();
+				co_await yield();
+			});
+	EXPECT_TRUE((bool) source);
+	result.push_back(1);
+	source(3);
+	result.push_back(4);
+	source(5);
+	source(6);
+	EXPECT_TRUE((bool) source);
+	source(7);
+	EXPECT_FALSE((bool) source);
+	EXPECT_EQ(std::vector<int>({ 1, 2, 3, 4, 5 }), result);
+}
+
+TEST(Coroutine_Stackless, Exception)
+{
+	symmetric_coroutine<void>::call_type source(
+			[](symmetric_coroutine<void>::yield_type& yield)
+					-> symmetric_coroutine<void>::body_type
+			{
+				co_await yield();
+				throw std::runtime_error("body");
+			});
+	EXPECT_NO_THROW(source());
+	EXPECT_THROW(source(), std::runtime_error);
+	EXPECT_FALSE((bool) source);
+	EXPECT_THROW(source(), std::runtime_error);
+}
+
+TEST(Coroutine_Stackless, Recursive)
+{
+	std::vector<int> result;
+	symmetric_coroutine<void>::call_type outer(
+			[&result](symmetric_coroutine<void>::yield_type& yield)
+					-> symmetric_coroutine<void>::body_type
+			{
+				symmetric_coroutine<void>::call_type inner(
+						[&result](symmetric_coroutine<void>::yield_type& yield)
+								-> symmetric_coroutine<void>::body_type
+						{
+							result.push_back(2);
+							co_await yield();
+							result.push_back(4);
+						});
+				inner();
+				co_await yield();
+				inner();
+				result.push_back(5);
+			});
+	result.push_back(1);
+	outer();
+	result.push_back(3);
+	outer();
+	EXPECT_FALSE((bool) outer);
+	EXPECT_EQ(std::vector<int>({ 1, 2, 3, 4, 5 }), result);
+}
+
+//a suspended coroutine destroys its locals with its frame
+TEST(Coroutine_Stackless, DestroySuspended)
+{
+	std::shared_ptr<int> counter = std::make_shared<int>(0);
+	{
+		symmetric_coroutine<void>::call_type source(
+				[counter](symmetric_coroutine<void>::yield_type& yield)
+						-> symmetric_coroutine<void>::body_type
+				{
+					std::shared_ptr<int> local = counter;
+					while (true)
+					{
+						++*local;
+						co_await yield();
+					}
+				});
+		source();
+		source();
+		EXPECT_EQ(2, *counter);
+		EXPECT_EQ(3, counter.use_count());
+	}
+	EXPECT_EQ(1, counter.use_count());
+}
+
+TEST(Coroutine_Stackless, Symmetric_PingPong)
+{
+	std::vector<int> seen;
+	symmetric_coroutine<int>::call_type* other = nullptr;
+	symmetric_coroutine<int>::call_type ping(
+			[&seen, &other](symmetric_coroutine<int>::yield_type& yield)
+					-> symmetric_coroutine<int>::body_type
+			{
+				while (yield.get() < 10)
+				{
+					seen.push_back(yield.get());
+					co_await yield(*other, yield.get() + 1);
+				}
+				seen.push_back(-yield.get());
+			});
+	symmetric_coroutine<int>::call_type pong(
+			[&seen, &ping](symmetric_coroutine<int>::yield_type& yield)
+					-> symmetric_coroutine<int>::body_type
+			{
+				while (true)
+				{
+					seen.push_back(yield.get());
+					co_await yield(ping, yield.get() + 1);
+				}
+			});
+	other = &pong;
+	ping(0);
+	EXPECT_FALSE((bool) ping);
+	EXPECT_TRUE((bool) pong);
+	EXPECT_EQ(std::vector<int>({ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, -10 }), seen);
+}
+
+TEST(Coroutine_Stackless, Symmetric_Pipeline)
+{
+	const int stages = 8;
+	std::vector<int> results;
+	std::vector<std::unique_ptr<symmetric_coroutine<int>::call_type>> pipeline(
+			stages);
+	for (int index = stages - 1; index >= 0; --index)
+	{
+		symmetric_coroutine<int>::call_type* next = index + 1 < stages ?
+				pipeline[index + 1].get() : nullptr;
+		pipeline[index].reset(new symmetric_coroutine<int>::call_type(
+				[&results, next, index](symmetric_coroutine<int>::yield_type& yield)
+						-> symmetric_coroutine<int>::body_type
+				{
+					while (true)
+					{
+						if (next != nullptr)
+							co_await yield(*next, yield.get() * 2 + index);
+						else
+						{
+							results.push_back(yield.get());
+							co_await yield();
+						}
+					}
+				}));
+	}
+	for (int value = 0; value < 100; ++value)
+		(*pipeline[0])(value);
+	ASSERT_EQ(100u, results.size());
+	for (int value = 0; value < 100; ++value)
+	{
+		int expected = value;
+		for (int index = 0; index < stages - 1; ++index)
+			expected = expected * 2 + index;
+		EXPECT_EQ(expected, results[value]);
+	}
+}
+
+TEST(Coroutine_Stackless, Symmetric_Exception)
+{
+	symmetric_coroutine<void>::call_type thrower(
+			[](symmetric_coroutine<void>::yield_type&)
+					-> symmetric_coroutine<void>::body_type
+			{
+				throw std::runtime_error("thrower");
+				co_return;
+			});
+	symmetric_coroutine<void>::call_type first(
+			[&thrower](symmetric_coroutine<void>::yield_type& yield)
+					-> symmetric_coroutine<void>::body_type
+			{
+				co_await yield(thrower);
+			});
+	EXPECT_THROW(first(), std::runtime_error);
+	EXPECT_TRUE((bool) first);
+	EXPECT_NO_THROW(first());
+	EXPECT_FALSE((bool) first);
+}
+
+class CountingFrameAllocator : public R::Allocator
+{
+public:
+	int live = 0;
+	int total = 0;
+
+	virtual Aux allocate(Size size, Ptr &addr)
+	{
+		++live;
+		++total;
+		addr = malloc(size);
+		return addr;
+	}
+
+	virtual void deallocate(Aux aux)
+	{
+		--live;
+		free(aux);
+	}
+};
+
+TEST(Coroutine_Stackless, FrameAllocator)
+{
+	CountingFrameAllocator allocator;
+	int sum = 0;
+	{
+		symmetric_coroutine<int>::call_type source(
+				[&sum](symmetric_coroutine<int>::yield_type& yield)
+						-> symmetric_coroutine<int>::body_type
+				{
+					while (true)
+					{
+						sum += yield.get();
+						co_await yield;
+					}
+				}, allocator);
+		EXPECT_EQ(1, allocator.live);
+		for (int index = 1; index <= 10; ++index)
+			source(index);
+	}
+	EXPECT_EQ(55, sum);
+	EXPECT_EQ(0, allocator.live);
+	EXPECT_EQ(1, allocator.total);
+}
+
+#endif
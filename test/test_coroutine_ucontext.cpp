@@ -0,0 +1,14 @@
+/*
+ * test_coroutine_ucontext.cpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#if defined(__unix__)
+#define R_COROUTINE_BACKEND R_COROUTINE_UCONTEXT
+#include <R/coroutine.hpp>
+using R::symmetric_coroutine;
+
+#define __COROUTINE_TEST Coroutine_UContext
+#include "test_coroutine.hpp"
+#endif
@@ -0,0 +1,131 @@
+/*
+ * test_count_min_sketch.cpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef DEBUG
+#define DEBUG
+#endif
+
+#include <cstdio>
+#include <map>
+#include <random>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <R/count_min_sketch.hpp>
+
+using namespace R;
+
+TEST(CountMinSketchTest, Dimensions)
+{
+	EXPECT_EQ(272u, count_min_row::width_for(0.01));
+	EXPECT_EQ(5u, count_min_row::depth_for(0.01));
+	EXPECT_EQ(16u, count_min_row::stride_for<uint32_t>(3));
+	EXPECT_EQ(32u, count_min_row::stride_for<uint16_t>(32));
+	CountMinSketch<> sketch(100, 3);
+	EXPECT_EQ(100u, sketch.width());
+	EXPECT_EQ(3u, sketch.depth());
+	for (std::size_t row = 0; row < 4; ++row)
+		for (uint64_t hash = 0; hash < 1000; ++hash)
+			ASSERT_LT(count_min_row::column(hash * 0x9E3779B97F4A7C15ULL, row,
+					100), 100u);
+}
+
+TEST(CountMinSketchTest, NeverUnderestimates)
+{
+	const double EPSILON = 0.005;
+	CountMinSketch<> sketch(count_min_row::width_for(EPSILON),
+			count_min_row::depth_for(0.001));
+	std::mt19937_64 rng(11);
+	std::map<uint64_t, uint32_t> exact;
+	uint32_t total = 0;
+	for (int k = 0; k < 20000; ++k)
+	{
+		//skewed keys: a few heavy hitters and a long tail
+		uint64_t key = (rng() % 4 == 0) ? rng() % 8 : rng() % 5000;
+		uint32_t count = 1 + rng() % 3;
+		sketch.add(key, count);
+		exact[key] += count;
+		total += count;
+	}
+	std::size_t bad = 0;
+	for (const std::pair<const uint64_t, uint32_t>& entry : exact)
+	{
+		uint32_t found = sketch.estimate(entry.first);
+		ASSERT_GE(found, entry.second);
+		bad += found > entry.second + EPSILON * total;
+	}
+	EXPECT_LE(bad, exact.size() / 100);
+	EXPECT_EQ(0u, CountMinSketch<>(1000, 4).estimate(42));
+}
+
+TEST(CountMinSketchTest, MergeAndBatch)
+{
+	bit_kernel::Backend saved = bit_kernel::current_backend();
+	for (int scalar = 0; scalar < 2; ++scalar)
+	{
+		if (scalar)
+			bit_kernel::set_backend(bit_kernel::Backend::SCALAR);
+		CountMinSketch<uint16_t> left(300, 4), right(300, 4), both(300, 4),
+				batch(300, 4);
+		std::vector<uint64_t> keys;
+		for (uint64_t key = 0; key < 5000; ++key)
+		{
+			keys.push_back(key % 700);
+			(key % 3 ? left : right).add(key % 700);
+			both.add(key % 700);
+		}
+		batch.add_many(keys.data(), keys.size());
+		left.merge(right);
+		std::vector<uint16_t> found(700);
+		std::vector<uint64_t> probes;
+		for (uint64_t key = 0; key < 700; ++key)
+			probes.push_back(key);
+		batch.estimate_many(probes.data(), probes.size(), found.data());
+		for (uint64_t key = 0; key < 700; ++key)
+		{
+			ASSERT_EQ(both.estimate(key), left.estimate(key));
+			ASSERT_EQ(both.estimate(key), found[key]);
+		}
+		both.clear();
+		EXPECT_EQ(0u, both.estimate(1));
+	}
+	bit_kernel::set_backend(saved);
+}
+
+//additions commute, so concurrent adds give the serial counters
+TEST(CountMinSketchTest, Atomic)
+{
+	const std::size_t THREADS = 4, PER_THREAD = 20000;
+	AtomicCountMinSketch<uint64_t> shared(500, 4);
+	CountMinSketch<uint64_t> serial(500, 4);
+	std::vector<std::thread> workers;
+	for (std::size_t thread = 0; thread < THREADS; ++thread)
+		workers.push_back(std::thread([&shared, thread]()
+		{
+			std::vector<uint64_t> keys;
+			for (std::size_t k = 0; k < PER_THREAD; ++k)
+				keys.push_back((k * 31 + thread) % 2000);
+			if (thread % 2)
+				shared.add_many(keys.data(), keys.size(), 2);
+			else
+				for (uint64_t key : keys)
+					shared.add(key, 2);
+		}));
+	for (std::thread& worker : workers)
+		worker.join();
+	for (std::size_t thread = 0; thread < THREADS; ++thread)
+		for (std::size_t k = 0; k < PER_THREAD; ++k)
+			serial.add((k * 31 + thread) % 2000, 2);
+
+	CountMinSketch<uint64_t> copy = shared.snapshot();
+	for (uint64_t key = 0; key < 2000; ++key)
+	{
+		ASSERT_EQ(serial.estimate(key), shared.estimate(key));
+		ASSERT_EQ(serial.estimate(key), copy.estimate(key));
+	}
+	shared.clear();
+	EXPECT_EQ(0u, shared.estimate(5));
+}
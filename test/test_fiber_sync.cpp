@@ -0,0 +1,274 @@
+/*
+ * test_fiber_sync.cpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef DEBUG
+#define DEBUG
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <R/fiber_sync.hpp>
+
+using namespace R;
+
+TEST(FiberSyncTest, MutexHeldAcrossYield)
+{
+	Scheduler scheduler(4);
+	CoMutex mutex;
+	int counter = 0;
+	std::vector<Task> tasks;
+	for (int index = 0; index < 100; ++index)
+		tasks.push_back(scheduler.spawn([&]()
+		{
+			for (int step = 0; step < 100; ++step)
+			{
+				std::lock_guard<CoMutex> lock(mutex);
+				int value = counter;
+				//the others queue up on the mutex meanwhile
+				Scheduler::yield_to_scheduler();
+				counter = value + 1;
+			}
+		}, 16 * 1024));
+	for (Task& task : tasks)
+		task.join();
+	EXPECT_EQ(100 * 100, counter);
+	EXPECT_TRUE(mutex.try_lock());
+	EXPECT_FALSE(mutex.try_lock());
+	mutex.unlock();
+}
+
+TEST(FiberSyncTest, MutexFromOutside)
+{
+	Scheduler scheduler(2);
+	CoMutex mutex;
+	std::atomic<int> stage(0);
+	mutex.lock();
+	Task task = scheduler.spawn([&]()
+	{
+		stage = 1;
+		mutex.lock();
+		stage = 2;
+		mutex.unlock();
+	});
+	while (stage.load() == 0)
+		std::this_thread::yield();
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	EXPECT_EQ(1, stage.load());
+	mutex.unlock();
+	task.join();
+	EXPECT_EQ(2, stage.load());
+	//a thread outside of fibers waits for a fiber
+	Task holder = scheduler.spawn([&]()
+	{
+		mutex.lock();
+		stage = 3;
+		for (int step = 0; step < 100; ++step)
+			Scheduler::yield_to_scheduler();
+		stage = 4;
+		mutex.unlock();
+	});
+	while (stage.load() < 3)
+		std::this_thread::yield();
+	mutex.lock();
+	EXPECT_EQ(4, stage.load());
+	mutex.unlock();
+	holder.join();
+}
+
+TEST(FiberSyncTest, ConditionQueue)
+{
+	Scheduler scheduler(3);
+	CoMutex mutex;
+	CoCondition not_empty;
+	std::deque<int> queue;
+	bool finished = false;
+	std::atomic<long> sum(0);
+	std::vector<Task> consumers;
+	for (int index = 0; index < 4; ++index)
+		consumers.push_back(scheduler.spawn([&]()
+		{
+			std::unique_lock<CoMutex> lock(mutex);
+			while (true)
+			{
+				not_empty.wait(lock, [&]()
+				{
+					return !queue.empty() || finished;
+				});
+				if (queue.empty())
+					return;
+				sum += queue.front();
+				queue.pop_front();
+			}
+		}));
+	scheduler.spawn([&]()
+	{
+		for (int value = 1; value <= 10000; ++value)
+		{
+			std::lock_guard<CoMutex> lock(mutex);
+			queue.push_back(value);
+			not_empty.notify_one();
+		}
+		std::lock_guard<CoMutex> lock(mutex);
+		finished = true;
+		not_empty.notify_all();
+	}).join();
+	for (Task& task : consumers)
+		task.join();
+	EXPECT_EQ(10000L * 10001 / 2, sum.load());
+}
+
+TEST(FiberSyncTest, WaitGroup)
+{
+	Scheduler scheduler(4);
+	WaitGroup group;
+	std::atomic<int> finished(0);
+	std::atomic<int> seen(-1);
+	group.add(50);
+	EXPECT_EQ(50, group.count());
+	Task waiter = scheduler.spawn([&]()
+	{
+		group.wait();
+		seen = finished.load();
+	});
+	std::vector<Task> tasks;
+	for (int index = 0; index < 50; ++index)
+		tasks.push_back(scheduler.spawn([&]()
+		{
+			Scheduler::yield_to_scheduler();
+			++finished;
+			group.done();
+		}));
+	//from outside of fibers as well
+	group.wait();
+	EXPECT_EQ(50, finished.load());
+	waiter.join();
+	EXPECT_EQ(50, seen.load());
+	for (Task& task : tasks)
+		task.join();
+	//nothing to wait for
+	group.wait();
+}
+
+TEST(FiberSyncTest, Timeouts)
+{
+	typedef Scheduler::Clock Clock;
+	Scheduler scheduler(2);
+	CoMutex mutex;
+	CoCondition condition;
+	WaitGroup group(1);
+	mutex.lock();
+	scheduler.spawn([&]()
+	{
+		Clock::time_point start = Clock::now();
+		EXPECT_FALSE(mutex.try_lock_for(std::chrono::milliseconds(10)));
+		EXPECT_GE(Clock::now() - start, std::chrono::milliseconds(10));
+		EXPECT_FALSE(group.wait_for(std::chrono::milliseconds(1)));
+	}).join();
+	mutex.unlock();
+	EXPECT_FALSE(group.wait_for(std::chrono::milliseconds(1)));
+	bool flag = false;
+	scheduler.spawn([&]()
+	{
+		std::unique_lock<CoMutex> lock(mutex);
+		EXPECT_EQ(std::cv_status::timeout,
+				condition.wait_for(lock, std::chrono::milliseconds(2)));
+		EXPECT_TRUE(lock.owns_lock());
+		EXPECT_FALSE(condition.wait_for(lock, std::chrono::milliseconds(2),
+				[&flag]()
+				{
+					return flag;
+				}));
+		//woken well before the deadline
+		Task other = scheduler.spawn([&]()
+		{
+			std::lock_guard<CoMutex> lock(mutex);
+			flag = true;
+			condition.notify_one();
+			group.done();
+		});
+		EXPECT_TRUE(condition.wait_for(lock, std::chrono::seconds(10),
+				[&flag]()
+				{
+					return flag;
+				}));
+		lock.unlock();
+		EXPECT_TRUE(group.wait_for(std::chrono::seconds(10)));
+		other.join();
+	}).join();
+	EXPECT_TRUE(mutex.try_lock_for(std::chrono::milliseconds(1)));
+	mutex.unlock();
+	//timed out waiters leave nothing behind
+	EXPECT_EQ(0, scheduler.timers());
+}
+
+//waiters with deadlines racing the wakers: every hand-over happens once
+TEST(FiberSyncTest, TimeoutRace)
+{
+	Scheduler scheduler(3);
+	CoMutex mutex;
+	int counter = 0;
+	std::atomic<int> timeouts(0);
+	std::vector<Task> tasks;
+	for (int index = 0; index < 20; ++index)
+		tasks.push_back(scheduler.spawn([&]()
+		{
+			int done = 0;
+			while (done < 200)
+			{
+				if (!mutex.try_lock_for(std::chrono::microseconds(500)))
+				{
+					++timeouts;
+					continue;
+				}
+				++counter;
+				++done;
+				Scheduler::yield_to_scheduler();
+				mutex.unlock();
+			}
+		}, 16 * 1024));
+	for (Task& task : tasks)
+		task.join();
+	EXPECT_EQ(20 * 200, counter);
+	EXPECT_TRUE(mutex.try_lock());
+	mutex.unlock();
+	EXPECT_EQ(0, scheduler.timers());
+}
+
+//deadlines already past, so each alarm goes off while its hook still runs
+TEST(FiberSyncTest, ExpiredDeadlines)
+{
+	Scheduler scheduler(4);
+	CoMutex mutex;
+	CoCondition condition;
+	std::atomic<int> timeouts(0);
+	mutex.lock();
+	std::vector<Task> tasks;
+	for (int index = 0; index < 8; ++index)
+		tasks.push_back(scheduler.spawn([&]()
+		{
+			CoMutex local;
+			for (int step = 0; step < 500; ++step)
+			{
+				Scheduler::Clock::time_point past = Scheduler::Clock::now()
+						- std::chrono::milliseconds(1);
+				if (!mutex.try_lock_until(past))
+					++timeouts;
+				std::unique_lock<CoMutex> lock(local);
+				if (condition.wait_until(lock, past) == std::cv_status::timeout)
+					++timeouts;
+			}
+		}, 16 * 1024));
+	for (Task& task : tasks)
+		task.join();
+	mutex.unlock();
+	EXPECT_EQ(8 * 500 * 2, timeouts.load());
+	EXPECT_EQ(0, scheduler.timers());
+}
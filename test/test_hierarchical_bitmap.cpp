@@ -0,0 +1,93 @@
+/*
+ * test_hierarchical_bitmap.cpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef DEBUG
+#define DEBUG
+#endif
+
+#include <cstdio>
+#include <random>
+#include <gtest/gtest.h>
+#include <R/hierarchical_bitmap.hpp>
+
+using namespace R;
+
+static void check_against_flat(size_t bits, bool initial, unsigned seed)
+{
+	std::mt19937 rng(seed);
+	HierarchicalBitmap tree(bits, initial);
+	BitVector<uint64_t> flat(bits, initial);
+
+	for (int round = 0; round < 300; ++round)
+	{
+		size_t index = rng() % bits;
+		size_t length = rng() % std::min<size_t>(bits - index, 700);
+		switch (rng() % 6)
+		{
+		case 0:
+			tree.set_range(index, length);
+			flat.set_range(index, length);
+			break;
+		case 1:
+			tree.clear_range(index, length);
+			flat.clear_range(index, length);
+			break;
+		case 2:
+		case 3:
+			tree.set_bit(index);
+			flat.set_bit(index);
+			break;
+		default:
+			tree.clear_bit(index);
+			flat.clear_bit(index);
+			break;
+		}
+
+		size_t probe = rng() % bits;
+		ASSERT_EQ(flat.find_first_set(), tree.find_first_set());
+		ASSERT_EQ(flat.find_first_zero(), tree.find_first_zero());
+		ASSERT_EQ(flat.find_next_set(probe), tree.find_next_set(probe));
+		ASSERT_EQ(flat.find_next_zero(probe), tree.find_next_zero(probe));
+		ASSERT_EQ(flat.count() > 0, tree.any());
+	}
+	EXPECT_TRUE(flat == tree.leaf());
+}
+
+TEST(HierarchicalBitmapTest, MatchesFlat)
+{
+	const size_t sizes[] = { 1, 64, 100, 4096, 5000, 300000 };
+	for (size_t bits : sizes)
+	{
+		check_against_flat(bits, false, (unsigned) bits);
+		check_against_flat(bits, true, (unsigned) bits + 1);
+	}
+}
+
+TEST(HierarchicalBitmapTest, SparseAndDense)
+{
+	const size_t bits = 1 << 20;
+	HierarchicalBitmap tree(bits);
+	EXPECT_EQ(3, tree.levels());
+	EXPECT_EQ(bits, tree.find_first_set());
+	EXPECT_EQ(0, tree.find_first_zero());
+
+	tree.set_bit(bits - 1);
+	EXPECT_EQ(bits - 1, tree.find_first_set());
+	EXPECT_EQ(bits - 1, tree.find_next_set(5));
+	EXPECT_EQ(bits, tree.find_next_set(bits - 1));
+
+	tree.fill();
+	EXPECT_EQ(bits, tree.find_first_zero());
+	tree.clear_bit(123456);
+	EXPECT_EQ(123456, tree.find_first_zero());
+	EXPECT_EQ(bits, tree.find_next_zero(123456));
+	tree.set_bit(123456);
+	EXPECT_EQ(bits, tree.find_first_zero());
+	EXPECT_EQ(bits, tree.count());
+
+	tree.clear();
+	EXPECT_FALSE(tree.any());
+}
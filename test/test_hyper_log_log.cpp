@@ -0,0 +1,132 @@
+/*
+ * test_hyper_log_log.cpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef DEBUG
+#define DEBUG
+#endif
+
+#include <cstdio>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <R/hyper_log_log.hpp>
+
+using namespace R;
+
+namespace
+{
+
+void expect_same_registers(const HyperLogLog& a, const HyperLogLog& b)
+{
+	ASSERT_EQ(a.registers(), b.registers());
+	for (std::size_t index = 0; index < a.registers(); ++index)
+		ASSERT_EQ(a.get(index), b.get(index)) << index;
+}
+
+}
+
+TEST(HyperLogLogTest, PackedMax)
+{
+	std::mt19937_64 rng(7);
+	for (int round = 0; round < 10000; ++round)
+	{
+		uint64_t x = rng() >> 4, y = rng() >> 4;
+		uint64_t merged = hll_register::max(x, y);
+		EXPECT_EQ(0u, merged >> 60);
+		for (std::size_t field = 0; field < hll_register::PER_WORD; ++field)
+			ASSERT_EQ(std::max(hll_register::get(x, field),
+					hll_register::get(y, field)),
+					hll_register::get(merged, field));
+	}
+	uint64_t word = hll_register::set(0, 0, 63);
+	word = hll_register::set(word, 9, 5);
+	EXPECT_EQ(63u, hll_register::get(word, 0));
+	EXPECT_EQ(5u, hll_register::get(word, 9));
+	EXPECT_EQ(0x0FC0000000000005ULL, word);
+}
+
+TEST(HyperLogLogTest, Estimate)
+{
+	HyperLogLog sketch(12);
+	EXPECT_EQ(4096u, sketch.registers());
+	EXPECT_EQ(0.0, sketch.estimate());
+	for (uint64_t key = 0; key < 10; ++key)
+		sketch.insert(key);
+	EXPECT_NEAR(10.0, sketch.estimate(), 0.5);
+
+	sketch.clear();
+	const uint64_t KEYS = 200000;
+	for (uint64_t key = 0; key < KEYS; ++key)
+		sketch.insert(key);
+	//duplicates leave the registers alone
+	for (uint64_t key = 0; key < KEYS; key += 3)
+		sketch.insert(key);
+	EXPECT_NEAR(1.0, sketch.estimate() / KEYS, 0.05);
+}
+
+TEST(HyperLogLogTest, MergeAndBatch)
+{
+	HyperLogLog left(10), right(10), both(10), batch(10);
+	std::vector<uint64_t> keys;
+	for (uint64_t key = 0; key < 30000; ++key)
+	{
+		keys.push_back(key * 7919);
+		(key % 2 ? left : right).insert(key * 7919);
+		both.insert(key * 7919);
+	}
+	batch.insert_many(keys.data(), keys.size());
+	expect_same_registers(both, batch);
+
+	bit_kernel::Backend saved = bit_kernel::current_backend();
+	HyperLogLog scalar(left);
+	bit_kernel::set_backend(bit_kernel::Backend::SCALAR);
+	scalar.merge(right);
+	bit_kernel::set_backend(saved);
+	left.merge(right);
+	expect_same_registers(both, left);
+	expect_same_registers(both, scalar);
+	EXPECT_NEAR(1.0, left.estimate() / 30000, 0.1);
+}
+
+//max is order independent, so concurrent inserts give the serial registers
+TEST(HyperLogLogTest, Atomic)
+{
+	const std::size_t THREADS = 4, PER_THREAD = 20000;
+	AtomicHyperLogLog shared(11);
+	HyperLogLog serial(11);
+	std::vector<std::thread> workers;
+	for (std::size_t thread = 0; thread < THREADS; ++thread)
+		workers.push_back(std::thread([&shared, thread]()
+		{
+			std::vector<uint64_t> keys;
+			for (std::size_t k = 0; k < PER_THREAD; ++k)
+				keys.push_back(k * THREADS + thread);
+			if (thread % 2)
+				shared.insert_many(keys.data(), keys.size());
+			else
+				for (uint64_t key : keys)
+					shared.insert(key);
+		}));
+	for (std::thread& worker : workers)
+		worker.join();
+	for (uint64_t key = 0; key < THREADS * PER_THREAD; ++key)
+		serial.insert(key);
+	expect_same_registers(serial, shared.snapshot());
+	EXPECT_DOUBLE_EQ(serial.estimate(), shared.estimate());
+
+	HyperLogLog extra(11);
+	for (uint64_t key = 1000000; key < 1010000; ++key)
+	{
+		extra.insert(key);
+		serial.insert(key);
+	}
+	shared.merge(extra);
+	expect_same_registers(serial, shared.snapshot());
+	shared.clear();
+	EXPECT_EQ(0.0, shared.estimate());
+}
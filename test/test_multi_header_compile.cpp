@@ -8,7 +8,36 @@
 #include <cstdio>
 #include <gtest/gtest.h>
 #include <R/bit_array.hpp>
+#include <R/bit_array_table.hpp>
+#include <R/bit_array_view.hpp>
+#include <R/bit_expression.hpp>
+#include <R/bit_matrix.hpp>
+#include <R/bit_parallel.hpp>
+#include <R/bitmap_index.hpp>
+#include <R/mapped_bit_array.hpp>
+#include <R/bit_kernel.hpp>
+#include <R/bit_word.hpp>
+#include <R/atomic_bit_array.hpp>
+#include <R/bit_algorithm.hpp>
+#include <R/bit_vector.hpp>
+#include <R/bloom_filter.hpp>
+#include <R/count_min_sketch.hpp>
+#include <R/hash_batch.hpp>
+#include <R/hyper_log_log.hpp>
+#include <R/memory_allocator.hpp>
+#include <R/hierarchical_bitmap.hpp>
+#include <R/roaring_bitmap.hpp>
+#include <R/rank_select.hpp>
+#include <R/thread_pool.hpp>
+#include <R/timing_wheel.hpp>
+#include <R/context_switch.hpp>
 #include <R/coroutine.hpp>
+#include <R/stack_pool.hpp>
+#include <R/work_stealing_deque.hpp>
+#include <R/scheduler.hpp>
+#include <R/reactor.hpp>
+#include <R/fiber_sync.hpp>
+#include <R/channel.hpp>
 
 TEST(CompileTest, Empty)
 {
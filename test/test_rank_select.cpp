@@ -0,0 +1,136 @@
+/*
+ * test_rank_select.cpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef DEBUG
+#define DEBUG
+#endif
+
+#include <cstdio>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include <R/rank_select.hpp>
+
+using namespace R;
+
+template<typename Type>
+class RankSelectTest: public ::testing::Test
+{
+};
+
+typedef ::testing::Types<uint64_t, uint32_t, uint16_t, uint8_t> BaseInts;
+TYPED_TEST_CASE(RankSelectTest, BaseInts);
+
+template<typename BaseInt>
+static void expect_index(const BitVector<BaseInt>& bits,
+		const RankSelect<BaseInt>& index)
+{
+	std::vector<std::size_t> positions;
+	for (std::size_t k = 0; k < bits.size(); ++k)
+	{
+		ASSERT_EQ(positions.size(), index.rank(k)) << "rank " << k;
+		if (bits.get_bit(k))
+			positions.push_back(k);
+	}
+	ASSERT_EQ(positions.size(), index.count());
+	ASSERT_EQ(positions.size(), index.rank(bits.size()));
+	for (std::size_t k = 0; k < positions.size(); ++k)
+		ASSERT_EQ(positions[k], index.select(k)) << "select " << k;
+	ASSERT_EQ(bits.size(), index.select(positions.size()));
+}
+
+TYPED_TEST(RankSelectTest, MatchesScan)
+{
+	std::mt19937 rng(9);
+	const std::size_t sizes[] = { 0, 1, 511, 2048, 20001 };
+	for (std::size_t size : sizes)
+		for (double density : { 0.001, 0.5, 0.97 })
+		{
+			BitVector<TypeParam> bits(size);
+			std::bernoulli_distribution coin(density);
+			for (std::size_t k = 0; k < size; ++k)
+				if (coin(rng))
+					bits.set_bit(k);
+			RankSelect<TypeParam> index(bits);
+			expect_index(bits, index);
+		}
+}
+
+TYPED_TEST(RankSelectTest, Rebuild)
+{
+	std::mt19937 rng(4);
+	BitVector<TypeParam> bits(30000);
+	for (std::size_t k = 0; k < bits.size(); k += 1 + rng() % 5)
+		bits.set_bit(k);
+	RankSelect<TypeParam> index(bits);
+
+	//bulk update of the tail only
+	bits.clear_range(15000, 5000);
+	bits.set_range(22000, 3000);
+	index.rebuild(15000);
+	expect_index(bits, index);
+
+	bits.set_range(0, 100);
+	index.rebuild();
+	expect_index(bits, index);
+
+	bits.resize(40000, true);
+	index.reset(bits.data(), bits.size());
+	expect_index(bits, index);
+}
+
+//rebuilding from the end, where no block is left to recount
+TYPED_TEST(RankSelectTest, RebuildAtEnd)
+{
+	for (std::size_t size : { 4096, 4100 })
+	{
+		BitVector<TypeParam> bits(size, true);
+		RankSelect<TypeParam> index(bits);
+		index.rebuild(bits.size());
+		expect_index(bits, index);
+
+		bits.clear_bit(size - 1);
+		index.rebuild(size - 1);
+		expect_index(bits, index);
+	}
+}
+
+TEST(RankSelectTest, BitArray)
+{
+	BitArray<uint64_t, 4096> bits(false);
+	bits.set_range(100, 50);
+	bits.set_bit(4095);
+	RankSelect<uint64_t> index(bits);
+	EXPECT_EQ(51, index.count());
+	EXPECT_EQ(0, index.rank(100));
+	EXPECT_EQ(50, index.rank(4095));
+	EXPECT_EQ(100, index.select(0));
+	EXPECT_EQ(149, index.select(49));
+	EXPECT_EQ(4095, index.select(50));
+	EXPECT_LT(index.memory_usage(), 4096 / 8 / 10);
+}
+
+TEST(RankSelectTest, SelectInWord)
+{
+	std::mt19937_64 rng(2);
+	for (int trial = 0; trial < 1000; ++trial)
+	{
+		uint64_t word = rng() & rng();
+		std::size_t k = 0;
+		for (std::size_t pos = 0; pos < 64; ++pos)
+			if (word & ((uint64_t) 1 << (63 - pos)))
+			{
+				ASSERT_EQ(pos, bit_word::select(word, k++));
+			}
+		uint8_t byte = (uint8_t) word;
+		k = 0;
+		for (std::size_t pos = 0; pos < 8; ++pos)
+			if (byte & (0x80 >> pos))
+			{
+				ASSERT_EQ(pos, bit_word::select(byte, k++));
+			}
+	}
+}
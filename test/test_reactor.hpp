@@ -0,0 +1,230 @@
+/*
+ * test_reactor.hpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+using namespace R;
+
+//skips the tests where the kernel refuses the backend
+class __REACTOR_TEST : public ::testing::Test
+{
+protected:
+	Scheduler scheduler;
+	std::unique_ptr<Reactor> reactor;
+
+	__REACTOR_TEST() :
+			scheduler(2)
+	{
+	}
+
+	virtual void SetUp()
+	{
+		try
+		{
+			reactor.reset(new Reactor(scheduler, 8));
+		}
+		catch (const std::system_error&)
+		{
+		}
+		if (!reactor)
+			GTEST_SKIP();
+	}
+};
+
+static void set_non_blocking(int fd)
+{
+	fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+}
+
+static void socket_pair(int (&fds)[2])
+{
+	ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds));
+}
+
+static void write_all(Reactor& reactor, int fd, const char* data, std::size_t bytes)
+{
+	while (bytes > 0)
+	{
+		std::size_t written = reactor.async_write(fd, data, bytes);
+		data += written;
+		bytes -= written;
+	}
+}
+
+static std::string read_exactly(Reactor& reactor, int fd, std::size_t bytes)
+{
+	std::string data(bytes, '\0');
+	std::size_t done = 0;
+	while (done < bytes)
+	{
+		std::size_t read = reactor.async_read(fd, &data[done], bytes - done);
+		if (read == 0)
+			break;
+		done += read;
+	}
+	data.resize(done);
+	return data;
+}
+
+TEST_F(__REACTOR_TEST, PingPong)
+{
+	int fds[2];
+	socket_pair(fds);
+	Reactor& io = *reactor;
+	Task echo = scheduler.spawn([&]()
+	{
+		char buffer[64];
+		std::size_t read;
+		while ((read = io.async_read(fds[1], buffer, sizeof(buffer))) > 0)
+			write_all(io, fds[1], buffer, read);
+	});
+	scheduler.spawn([&]()
+	{
+		for (int round = 0; round < 1000; ++round)
+		{
+			std::string message = "ping " + std::to_string(round);
+			write_all(io, fds[0], message.data(), message.size());
+			ASSERT_EQ(message, read_exactly(io, fds[0], message.size()));
+		}
+		io.close(fds[0]);
+	}).join();
+	echo.join();
+	io.close(fds[1]);
+}
+
+//more than the socket buffers hold, so both sides park midway
+TEST_F(__REACTOR_TEST, LargeTransfer)
+{
+	int fds[2];
+	socket_pair(fds);
+	Reactor& io = *reactor;
+	std::string data(4 << 20, '\0');
+	for (std::size_t index = 0; index < data.size(); ++index)
+		data[index] = (char) (index * 131 % 251);
+	std::string received;
+	Task reader = scheduler.spawn([&]()
+	{
+		received = read_exactly(io, fds[1], data.size() + 1);
+	});
+	scheduler.spawn([&]()
+	{
+		write_all(io, fds[0], data.data(), data.size());
+		io.close(fds[0]);
+	}).join();
+	reader.join();
+	EXPECT_TRUE(received == data);
+	io.close(fds[1]);
+}
+
+TEST_F(__REACTOR_TEST, ResumedByOtherThread)
+{
+	int fds[2];
+	socket_pair(fds);
+	Reactor& io = *reactor;
+	char byte = 0;
+	Task reader = scheduler.spawn([&]()
+	{
+		ASSERT_EQ(1u, io.async_read(fds[0], &byte, 1));
+		ASSERT_EQ(0u, io.async_read(fds[0], &byte, 1));
+	});
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	EXPECT_FALSE(reader.done());
+	ASSERT_EQ(1, write(fds[1], "x", 1));
+	::close(fds[1]);
+	reader.join();
+	EXPECT_EQ('x', byte);
+	io.close(fds[0]);
+}
+
+TEST_F(__REACTOR_TEST, OutsideOfFibers)
+{
+	int fds[2];
+	socket_pair(fds);
+	Reactor& io = *reactor;
+	Task writer = scheduler.spawn([&]()
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		write_all(io, fds[1], "abc", 3);
+	});
+	EXPECT_EQ("abc", read_exactly(io, fds[0], 3));
+	writer.join();
+	io.close(fds[0]);
+	io.close(fds[1]);
+}
+
+TEST_F(__REACTOR_TEST, AcceptAndEcho)
+{
+	int listener = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+	ASSERT_GE(listener, 0);
+	sockaddr_in address = sockaddr_in();
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	socklen_t length = sizeof(address);
+	ASSERT_EQ(0, bind(listener, (sockaddr*) &address, length));
+	ASSERT_EQ(0, getsockname(listener, (sockaddr*) &address, &length));
+	ASSERT_EQ(0, listen(listener, 128));
+	Reactor& io = *reactor;
+	const int clients = 50;
+	std::vector<Task> echoes;
+	Task server = scheduler.spawn([&]()
+	{
+		for (int index = 0; index < clients; ++index)
+		{
+			int connection = io.async_accept(listener);
+			echoes.push_back(scheduler.spawn([&io, connection]()
+			{
+				char buffer[256];
+				std::size_t read;
+				while ((read = io.async_read(connection, buffer, sizeof(buffer))) > 0)
+					write_all(io, connection, buffer, read);
+				io.close(connection);
+			}));
+		}
+	});
+	std::vector<Task> tasks;
+	for (int index = 0; index < clients; ++index)
+		tasks.push_back(scheduler.spawn([&, index]()
+		{
+			int fd = socket(AF_INET, SOCK_STREAM, 0);
+			ASSERT_EQ(0, connect(fd, (sockaddr*) &address, sizeof(address)));
+			set_non_blocking(fd);
+			std::string message(1000 + index, (char) ('a' + index % 26));
+			write_all(io, fd, message.data(), message.size());
+			EXPECT_EQ(message, read_exactly(io, fd, message.size()));
+			io.close(fd);
+		}));
+	for (Task& task : tasks)
+		task.join();
+	server.join();
+	for (Task& task : echoes)
+		task.join();
+	io.close(listener);
+}
+
+TEST_F(__REACTOR_TEST, Error)
+{
+	Reactor& io = *reactor;
+	int fds[2];
+	socket_pair(fds);
+	::close(fds[1]);
+	Task task = scheduler.spawn([&]()
+	{
+		char byte = 0;
+		io.async_read(fds[0], &byte, 1);
+		io.async_read(-1, &byte, 1);
+	});
+	EXPECT_THROW(task.join(), std::system_error);
+	io.close(fds[0]);
+}
@@ -0,0 +1,15 @@
+/*
+ * test_reactor_epoll.cpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef DEBUG
+#define DEBUG
+#endif
+
+#define R_REACTOR_BACKEND R_REACTOR_EPOLL
+#include <R/reactor.hpp>
+
+#define __REACTOR_TEST Reactor_Epoll
+#include "test_reactor.hpp"
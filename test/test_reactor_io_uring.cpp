@@ -0,0 +1,15 @@
+/*
+ * test_reactor_io_uring.cpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef DEBUG
+#define DEBUG
+#endif
+
+#define R_REACTOR_BACKEND R_REACTOR_IO_URING
+#include <R/reactor.hpp>
+
+#define __REACTOR_TEST Reactor_IoUring
+#include "test_reactor.hpp"
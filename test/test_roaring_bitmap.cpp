@@ -0,0 +1,203 @@
+/*
+ * test_roaring_bitmap.cpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef DEBUG
+#define DEBUG
+#endif
+
+#include <cstdio>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include <R/bit_vector.hpp>
+#include <R/roaring_bitmap.hpp>
+
+using namespace R;
+
+static const size_t UNIVERSE = 5 * 65536 + 1000;
+
+//random mix of sparse bits, dense blocks and long runs
+static void randomize(RoaringBitmap& roaring, BitVector<uint64_t>& dense,
+		std::mt19937& rng, int rounds)
+{
+	for (int round = 0; round < rounds; ++round)
+	{
+		size_t index = rng() % UNIVERSE;
+		size_t length = std::min<size_t>(rng() % 20000, UNIVERSE - index);
+		switch (rng() % 8)
+		{
+		case 0:
+			roaring.set_range(index, length);
+			dense.set_range(index, length);
+			break;
+		case 1:
+			roaring.clear_range(index, length);
+			dense.clear_range(index, length);
+			break;
+		case 2:
+			for (int k = 0; k < 3000; ++k)
+			{
+				size_t bit = (index + rng() % 60000) % UNIVERSE;
+				roaring.set_bit(bit);
+				dense.set_bit(bit);
+			}
+			break;
+		case 3:
+			for (int k = 0; k < 2000; ++k)
+			{
+				size_t bit = (index + rng() % 60000) % UNIVERSE;
+				roaring.clear_bit(bit);
+				dense.clear_bit(bit);
+			}
+			break;
+		default:
+			roaring.set_bit(index);
+			dense.set_bit(index);
+			break;
+		}
+	}
+}
+
+static void expect_same(const RoaringBitmap& roaring,
+		const BitVector<uint64_t>& dense)
+{
+	ASSERT_EQ(dense.count(), roaring.count());
+	BitVector<uint64_t> converted(UNIVERSE);
+	roaring.to_dense(converted);
+	ASSERT_TRUE(converted == dense);
+	for (size_t k = 0; k < UNIVERSE; k += 97)
+		ASSERT_EQ(dense.get_bit(k), roaring.get_bit(k)) << "bit " << k;
+}
+
+TEST(RoaringBitmapTest, MatchesDense)
+{
+	std::mt19937 rng(5);
+	for (int trial = 0; trial < 3; ++trial)
+	{
+		RoaringBitmap roaring;
+		BitVector<uint64_t> dense(UNIVERSE);
+		randomize(roaring, dense, rng, 40);
+		expect_same(roaring, dense);
+
+		roaring.optimize();
+		expect_same(roaring, dense);
+		EXPECT_TRUE(RoaringBitmap::from_dense(dense) == roaring);
+	}
+}
+
+TEST(RoaringBitmapTest, SetOperations)
+{
+	std::mt19937 rng(11);
+	for (int trial = 0; trial < 4; ++trial)
+	{
+		RoaringBitmap a, b;
+		BitVector<uint64_t> x(UNIVERSE), y(UNIVERSE);
+		randomize(a, x, rng, 15);
+		randomize(b, y, rng, 15);
+
+		EXPECT_EQ(x.is_collide(y), a.is_collide(b));
+		EXPECT_EQ(x.is_collide(y), b.is_collide(a));
+
+		RoaringBitmap merged(a);
+		BitVector<uint64_t> merged_dense(x);
+		merged.merge(b);
+		merged_dense.merge(y);
+		expect_same(merged, merged_dense);
+
+		RoaringBitmap intersected(a);
+		BitVector<uint64_t> intersected_dense(x);
+		intersected.intersect(b);
+		intersected_dense.intersect(y);
+		expect_same(intersected, intersected_dense);
+		EXPECT_EQ(intersected_dense.count() > 0, a.is_collide(b));
+	}
+}
+
+//run chunks merged run by run, including runs that touch or overlap
+TEST(RoaringBitmapTest, RunMerge)
+{
+	std::mt19937 rng(17);
+	RoaringBitmap a, b;
+	BitVector<uint64_t> x(UNIVERSE), y(UNIVERSE);
+	for (size_t index = 0; index + 64 < UNIVERSE; index += 40 + rng() % 40)
+	{
+		size_t length = 1 + rng() % 30;
+		a.set_range(index, length);
+		x.set_range(index, length);
+		size_t shift = rng() % 40;
+		b.set_range(index + shift, length);
+		y.set_range(index + shift, length);
+	}
+	a.optimize();
+	b.optimize();
+	a.merge(b);
+	x.merge(y);
+	expect_same(a, x);
+
+	for (size_t bit = 3; bit < UNIVERSE; bit += 7919)
+	{
+		a.set_bit(bit);
+		x.set_bit(bit);
+	}
+	expect_same(a, x);
+}
+
+TEST(RoaringBitmapTest, Collide)
+{
+	RoaringBitmap runs, sparse, dense;
+	runs.set_range(1000, 500);
+	sparse.set_bit(999);
+	sparse.set_bit(1500);
+	EXPECT_FALSE(runs.is_collide(sparse));
+	sparse.set_bit(1499);
+	EXPECT_TRUE(runs.is_collide(sparse));
+
+	for (size_t k = 0; k < 65536; k += 2)
+		dense.set_bit(k);
+	EXPECT_TRUE(runs.is_collide(dense));
+	RoaringBitmap odd;
+	odd.set_bit(1001);
+	EXPECT_FALSE(odd.is_collide(dense));
+}
+
+TEST(RoaringBitmapTest, DenseBitArray)
+{
+	BitArray<uint32_t, 256> array(false);
+	array.set_range(10, 40);
+	array.set_bit(200);
+	RoaringBitmap roaring = RoaringBitmap::from_dense(array);
+	EXPECT_EQ(41, roaring.count());
+	EXPECT_EQ(10, roaring.lower_bound(0));
+	EXPECT_EQ(200, roaring.lower_bound(50));
+
+	BitArray<uint32_t, 256> back(false);
+	roaring.to_dense(back);
+	EXPECT_TRUE(back == array);
+}
+
+//memory follows the number of members, not the universe
+TEST(RoaringBitmapTest, SparseMemory)
+{
+	RoaringBitmap roaring;
+	const size_t huge = (size_t) 1 << 40;
+	for (size_t k = 0; k < 1000; ++k)
+		roaring.set_bit(k * (huge / 1000));
+	roaring.optimize();
+	EXPECT_EQ(1000, roaring.count());
+	EXPECT_EQ(1000, roaring.chunks());
+	EXPECT_LT(roaring.memory_usage(), 100 * 1000);
+
+	RoaringBitmap full;
+	full.set_range(0, 65536 * 100);
+	EXPECT_EQ(65536 * 100, full.count());
+	EXPECT_LT(full.memory_usage(), 200 * 100);
+
+	RoaringBitmap copy(roaring);
+	copy.merge(full);
+	EXPECT_EQ(65536 * 100 + 1000 - 1, copy.count());
+	copy.intersect(roaring);
+	EXPECT_TRUE(copy == roaring);
+}
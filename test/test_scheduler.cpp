@@ -0,0 +1,166 @@
+/*
+ * test_scheduler.cpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef DEBUG
+#define DEBUG
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <R/scheduler.hpp>
+
+using namespace R;
+
+TEST(SchedulerTest, SpawnAndJoin)
+{
+	Scheduler scheduler(4);
+	std::atomic<int> sum(0);
+	std::vector<Task> tasks;
+	for (int index = 0; index < 2000; ++index)
+		tasks.push_back(scheduler.spawn([&sum, index]()
+		{
+			sum.fetch_add(index);
+			Scheduler::yield_to_scheduler();
+			sum.fetch_add(index);
+		}, 16 * 1024));
+	for (Task& task : tasks)
+		task.join();
+	EXPECT_EQ(2 * 1999 * 2000 / 2, sum.load());
+	EXPECT_TRUE(tasks.front().done());
+}
+
+static int fibonacci(Scheduler& scheduler, int n)
+{
+	if (n < 2)
+		return n;
+	int left = 0;
+	Task task = scheduler.spawn([&scheduler, &left, n]()
+	{
+		left = fibonacci(scheduler, n - 1);
+	}, 16 * 1024);
+	int right = fibonacci(scheduler, n - 2);
+	task.join();
+	return left + right;
+}
+
+TEST(SchedulerTest, NestedJoin)
+{
+	Scheduler scheduler(3);
+	int result = 0;
+	scheduler.spawn([&]()
+	{
+		result = fibonacci(scheduler, 15);
+	}).join();
+	EXPECT_EQ(610, result);
+}
+
+TEST(SchedulerTest, YieldAlternates)
+{
+	Scheduler scheduler(1);
+	std::vector<int> order;
+	scheduler.spawn([&]()
+	{
+		Task a = scheduler.spawn([&]()
+		{
+			for (int step = 0; step < 3; ++step)
+			{
+				order.push_back(1);
+				Scheduler::yield_to_scheduler();
+			}
+		});
+		Task b = scheduler.spawn([&]()
+		{
+			for (int step = 0; step < 3; ++step)
+			{
+				order.push_back(2);
+				Scheduler::yield_to_scheduler();
+			}
+		});
+		a.join();
+		b.join();
+	}).join();
+	ASSERT_EQ(6, order.size());
+	for (std::size_t index = 1; index < order.size(); ++index)
+		EXPECT_NE(order[index - 1], order[index]);
+}
+
+TEST(SchedulerTest, Exception)
+{
+	Scheduler scheduler(2);
+	Task task = scheduler.spawn([]()
+	{
+		throw std::runtime_error("failed");
+	});
+	EXPECT_THROW(task.join(), std::runtime_error);
+	std::string caught;
+	scheduler.spawn([&]()
+	{
+		try
+		{
+			task.join();
+		}
+		catch (const std::runtime_error& error)
+		{
+			caught = error.what();
+		}
+	}).join();
+	EXPECT_EQ("failed", caught);
+}
+
+TEST(SchedulerTest, SuspendAndReady)
+{
+	Scheduler scheduler(2);
+	std::atomic<Fiber*> parked(nullptr);
+	std::atomic<int> stage(0);
+	Task task = scheduler.spawn([&]()
+	{
+		stage = 1;
+		Scheduler::suspend([&](Fiber* fiber)
+		{
+			parked = fiber;
+		});
+		stage = 2;
+	});
+	while (parked.load() == nullptr)
+		std::this_thread::yield();
+	EXPECT_EQ(1, stage.load());
+	//woken from a thread outside the pool
+	Scheduler::ready(parked.load());
+	task.join();
+	EXPECT_EQ(2, stage.load());
+}
+
+TEST(SchedulerTest, Sleep)
+{
+	typedef Scheduler::Clock Clock;
+	//one worker: the sleepers overlap instead of taking turns
+	Scheduler scheduler(1);
+	std::atomic<int> early(0);
+	Clock::time_point begin = Clock::now();
+	std::vector<Task> tasks;
+	for (int index = 0; index < 1000; ++index)
+		tasks.push_back(scheduler.spawn([&early, index]()
+		{
+			Clock::time_point start = Clock::now();
+			std::chrono::milliseconds delay(20 + index % 20);
+			Scheduler::sleep_for(delay);
+			if (Clock::now() - start < delay)
+				++early;
+		}, 16 * 1024));
+	for (Task& task : tasks)
+		task.join();
+	EXPECT_EQ(0, early.load());
+	EXPECT_LT(Clock::now() - begin, std::chrono::seconds(2));
+	EXPECT_EQ(0, scheduler.timers());
+	//outside of fibers it sleeps the thread
+	Clock::time_point start = Clock::now();
+	Scheduler::sleep_for(std::chrono::milliseconds(5));
+	EXPECT_GE(Clock::now() - start, std::chrono::milliseconds(5));
+}
@@ -0,0 +1,118 @@
+/*
+ * test_stack_pool.cpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef DEBUG
+#define DEBUG
+#endif
+
+#include <cstring>
+#include <vector>
+#include <gtest/gtest.h>
+#include <R/coroutine.hpp>
+#include <R/stack_pool.hpp>
+
+using namespace R;
+
+//malloc memory is not page aligned, so the pool has to align the guard
+class MallocStackAllocator : public Allocator
+{
+public:
+	int allocations = 0;
+	int live = 0;
+
+	virtual Aux allocate(Size size, Ptr &addr)
+	{
+		++allocations;
+		++live;
+		addr = (Ptr) ((char*) malloc(size + 8) + 8);
+		return (Aux) ((char*) addr - 8);
+	}
+	virtual void deallocate(Aux aux)
+	{
+		--live;
+		free(aux);
+	}
+};
+
+TEST(StackPoolTest, ReuseAndRounding)
+{
+	StackPool pool;
+	EXPECT_EQ(page_size(), StackPool::round(1));
+	EXPECT_EQ(page_size() * 4, StackPool::round(page_size() * 3));
+	EXPECT_EQ(page_size() * 4, StackPool::round(page_size() * 4));
+
+	StackPool::Stack first = pool.allocate(10000);
+	EXPECT_EQ(StackPool::round(10000), first.size);
+	EXPECT_EQ(0, (uintptr_t) first.base % page_size());
+	std::memset(first.base, 1, first.size);
+	pool.deallocate(first);
+	EXPECT_EQ(first.size, pool.cached_bytes());
+
+	//the same size class hands the cached stack back, another maps anew
+	StackPool::Stack again = pool.allocate(first.size);
+	EXPECT_EQ(first.base, again.base);
+	EXPECT_EQ(0, pool.cached_bytes());
+	StackPool::Stack other = pool.allocate(first.size * 2);
+	EXPECT_NE(first.base, other.base);
+	pool.deallocate(again);
+	pool.deallocate(other);
+	pool.trim();
+	EXPECT_EQ(0, pool.cached_bytes());
+}
+
+TEST(StackPoolTest, CacheLimitAndAllocator)
+{
+	MallocStackAllocator allocator;
+	{
+		StackPool pool(page_size() * 16, allocator);
+		std::vector<StackPool::Stack> stacks;
+		for (int index = 0; index < 8; ++index)
+		{
+			stacks.push_back(pool.allocate(page_size() * 4));
+			std::memset(stacks.back().base, 2, stacks.back().size);
+		}
+		EXPECT_EQ(8, allocator.live);
+		//only four of them fit in the cache
+		for (const StackPool::Stack& stack : stacks)
+			pool.deallocate(stack);
+		EXPECT_EQ(page_size() * 16, pool.cached_bytes());
+		EXPECT_EQ(4, allocator.live);
+		for (int index = 0; index < 4; ++index)
+			pool.deallocate(pool.allocate(page_size() * 4));
+		EXPECT_EQ(8, allocator.allocations);
+	}
+	EXPECT_EQ(0, allocator.live);
+}
+
+TEST(StackPoolTest, GuardPage)
+{
+	StackPool pool;
+	StackPool::Stack stack = pool.allocate(page_size());
+	EXPECT_DEATH(((volatile char*) stack.base)[-1] = 0, "");
+	pool.deallocate(stack);
+}
+
+TEST(StackPoolTest, Coroutines)
+{
+	StackPool pool;
+	int sum = 0;
+	for (int index = 0; index < 1000; ++index)
+	{
+		symmetric_coroutine<int>::call_type add(
+				[&sum](symmetric_coroutine<int>::yield_type& yield)
+				{
+					//touches most of a small stack
+					volatile char buffer[8 * 1024];
+					buffer[0] = (char) yield.get();
+					sum += buffer[0];
+				}, 16 * 1024, pool);
+		add(index % 2);
+	}
+	EXPECT_EQ(500, sum);
+#if R_COROUTINE_BACKEND != R_COROUTINE_THREAD
+	EXPECT_EQ(StackPool::round(16 * 1024), pool.cached_bytes());
+#endif
+}
@@ -0,0 +1,138 @@
+/*
+ * test_timing_wheel.cpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef DEBUG
+#define DEBUG
+#endif
+
+#include <memory>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include <R/timing_wheel.hpp>
+
+using namespace R;
+
+namespace
+{
+
+struct Entry : public TimingWheel::Timer
+{
+	int fired;
+	TimingWheel::Tick expected;
+
+	Entry() :
+			fired(0), expected(0)
+	{
+	}
+};
+
+}
+
+TEST(TimingWheelTest, Basic)
+{
+	TimingWheel wheel(100);
+	Entry near, far, due, cancelled;
+	wheel.insert(&near, 105);
+	wheel.insert(&far, 100 + 5000);
+	wheel.insert(&due, 50);
+	wheel.insert(&cancelled, 103);
+	EXPECT_EQ(4, wheel.size());
+	EXPECT_TRUE(wheel.cancel(&cancelled));
+	EXPECT_FALSE(wheel.cancel(&cancelled));
+	TimingWheel::Tick next = 0;
+	ASSERT_TRUE(wheel.next(next));
+	EXPECT_EQ(100, next);
+
+	std::vector<Entry*> fired;
+	auto collect = [&fired](TimingWheel::Timer* timer)
+	{
+		fired.push_back((Entry*) timer);
+	};
+	EXPECT_EQ(1, wheel.advance(104, collect));
+	ASSERT_EQ(1, fired.size());
+	EXPECT_EQ(&due, fired[0]);
+	ASSERT_TRUE(wheel.next(next));
+	EXPECT_LE(next, 105);
+	EXPECT_EQ(1, wheel.advance(105, collect));
+	EXPECT_EQ(&near, fired[1]);
+	EXPECT_FALSE(near.pending());
+	EXPECT_EQ(0, wheel.advance(5099, collect));
+	EXPECT_EQ(1, wheel.advance(1000000, collect));
+	EXPECT_EQ(&far, fired[2]);
+	EXPECT_TRUE(wheel.empty());
+	EXPECT_FALSE(wheel.next(next));
+	EXPECT_EQ(1000000, wheel.now());
+}
+
+//random deadlines at every scale, cancels and steps: every timer fires
+//in the advance that first passes its deadline
+TEST(TimingWheelTest, Random)
+{
+	std::mt19937_64 random(7);
+	TimingWheel wheel(12345);
+	std::vector<std::unique_ptr<Entry>> entries;
+	std::vector<Entry*> live;
+	TimingWheel::Tick now = wheel.now();
+	for (int round = 0; round < 3000; ++round)
+	{
+		for (int index = 0; index < 20; ++index)
+		{
+			entries.emplace_back(new Entry);
+			Entry* entry = entries.back().get();
+			int scale = (int) (random() % 40);
+			TimingWheel::Tick delta = random()
+					& (((TimingWheel::Tick) 1 << scale) - 1);
+			entry->expected = now + delta;
+			wheel.insert(entry, entry->expected);
+			live.push_back(entry);
+		}
+		if (!live.empty() && random() % 3 == 0)
+		{
+			std::size_t index = random() % live.size();
+			if (live[index]->pending())
+			{
+				EXPECT_TRUE(wheel.cancel(live[index]));
+			}
+			live[index] = live.back();
+			live.pop_back();
+		}
+		TimingWheel::Tick previous = now;
+		int step = (int) (random() % 24);
+		now += random() & (((TimingWheel::Tick) 1 << step) - 1);
+		wheel.advance(now, [previous, now](TimingWheel::Timer* timer)
+		{
+			Entry* entry = (Entry*) timer;
+			++entry->fired;
+			EXPECT_LE(entry->expected, now);
+			EXPECT_GE(entry->expected, previous);
+		});
+		TimingWheel::Tick next;
+		if (wheel.next(next))
+		{
+			EXPECT_GE(next, now);
+		}
+	}
+	std::size_t pending = 0;
+	for (const std::unique_ptr<Entry>& entry : entries)
+	{
+		EXPECT_LE(entry->fired, 1);
+		if (entry->pending())
+		{
+			++pending;
+			EXPECT_GT(entry->expected, now);
+			EXPECT_EQ(0, entry->fired);
+		}
+	}
+	EXPECT_EQ(pending, wheel.size());
+	//and everything fires in the end
+	std::size_t fired = wheel.advance(now + ((TimingWheel::Tick) 1 << 41),
+			[](TimingWheel::Timer*)
+			{
+			});
+	EXPECT_EQ(pending, fired);
+	EXPECT_TRUE(wheel.empty());
+}
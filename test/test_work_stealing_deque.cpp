@@ -0,0 +1,75 @@
+/*
+ * test_work_stealing_deque.cpp
+ *
+ *  Created on: 2026. 10. 17.
+ */
+
+#ifndef DEBUG
+#define DEBUG
+#endif
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <R/work_stealing_deque.hpp>
+
+using namespace R;
+
+TEST(WorkStealingDequeTest, Order)
+{
+	WorkStealingDeque<int> deque(4);
+	int value = 0;
+	EXPECT_FALSE(deque.pop(value));
+	EXPECT_FALSE(deque.steal(value));
+	//grows past the initial ring
+	for (int index = 0; index < 100; ++index)
+		deque.push(index);
+	EXPECT_EQ(100, deque.size());
+	ASSERT_TRUE(deque.steal(value));
+	EXPECT_EQ(0, value);
+	ASSERT_TRUE(deque.pop(value));
+	EXPECT_EQ(99, value);
+	for (int index = 1; index < 99; ++index)
+	{
+		ASSERT_TRUE(deque.steal(value));
+		EXPECT_EQ(index, value);
+	}
+	EXPECT_TRUE(deque.empty());
+	EXPECT_FALSE(deque.pop(value));
+}
+
+//every pushed item is taken exactly once by the owner or a thief
+TEST(WorkStealingDequeTest, Concurrent)
+{
+	const int ITEMS = 200000;
+	const int THIEVES = 3;
+	WorkStealingDeque<int> deque(16);
+	std::vector<std::atomic<int>> taken(ITEMS);
+	for (std::atomic<int>& count : taken)
+		count.store(0);
+	std::atomic<bool> done(false);
+	std::vector<std::thread> thieves;
+	for (int thief = 0; thief < THIEVES; ++thief)
+		thieves.emplace_back([&]()
+		{
+			int value;
+			while (!done.load())
+				if (deque.steal(value))
+					taken[value].fetch_add(1);
+		});
+	int value;
+	for (int index = 0; index < ITEMS; ++index)
+	{
+		deque.push(index);
+		if (index % 3 == 0 && deque.pop(value))
+			taken[value].fetch_add(1);
+	}
+	while (deque.pop(value))
+		taken[value].fetch_add(1);
+	done.store(true);
+	for (std::thread& thief : thieves)
+		thief.join();
+	for (int index = 0; index < ITEMS; ++index)
+		ASSERT_EQ(1, taken[index].load()) << index;
+}